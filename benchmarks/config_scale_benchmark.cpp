@@ -0,0 +1,270 @@
+#include "buildjson/buildjson.hpp"
+#include "configgen.hpp"
+#include "pid/builder.hpp"
+#include "pid/buildjson.hpp"
+#include "pid/pidloop.hpp"
+#include "pid/zone_interface.hpp"
+#include "sensors/builder.hpp"
+#include "sensors/buildjson.hpp"
+#include "sensors/manager.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/test/sdbus_mock.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <gmock/gmock.h>
+
+namespace pid_control
+{
+namespace
+{
+
+/*
+ * A generated configuration in a scratch directory, with the sysfs files its
+ * fans read from and write to under <dir>/sys.
+ */
+class ScaleConfig
+{
+  public:
+    explicit ScaleConfig(const benchmark::State& state)
+    {
+        std::string dir =
+            std::filesystem::temp_directory_path() / "swampd-scale-XXXXXX";
+        if (mkdtemp(dir.data()) == nullptr)
+        {
+            throw std::runtime_error("Unable to create " + dir);
+        }
+        _dir = dir;
+
+        bench::ConfigShape shape;
+        shape.zones = state.range(0);
+        shape.sensors = state.range(1);
+        shape.controllers = state.range(2);
+        shape.sysfsDir = _dir / "sys";
+        std::filesystem::create_directory(shape.sysfsDir);
+
+        size_t fans = bench::fansPerZone(shape) * shape.zones;
+        for (size_t n = 1; n <= fans; n++)
+        {
+            std::ofstream(shape.sysfsDir + "/fan" + std::to_string(n) +
+                          "_input")
+                << 5000 << "\n";
+        }
+
+        path = _dir / "config.json";
+        std::ofstream(path) << bench::generateConfig(shape).dump(4) << "\n";
+        sensorCount = shape.zones * shape.sensors;
+    }
+
+    ~ScaleConfig()
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(_dir, ec);
+    }
+
+    ScaleConfig(const ScaleConfig&) = delete;
+    ScaleConfig& operator=(const ScaleConfig&) = delete;
+
+    std::string path;
+    size_t sensorCount;
+
+  private:
+    std::filesystem::path _dir;
+};
+
+/* The peak resident set size of this process image, in kB. */
+double imagePeakRssKb(void)
+{
+    std::ifstream status("/proc/self/status");
+    std::string field;
+    while (status >> field)
+    {
+        if (field == "VmHWM:")
+        {
+            double kb = 0;
+            status >> kb;
+            return kb;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Build the configuration at path, and run a cycle of every zone if cycle,
+ * then print the process's peak RSS.  Run by peakRssKb() in a process of its
+ * own.
+ */
+int measureConfig(const std::string& path, bool cycle)
+{
+    auto data = parseValidateJson(path);
+    auto sensorConfig = buildSensorsFromJson(data);
+    auto [zoneConfig, zoneDetailsConfig] = buildPIDsFromJson(data);
+
+    ::testing::NiceMock<sdbusplus::SdBusMock> sdbus;
+    auto bus = sdbusplus::get_mocked_new(&sdbus);
+    SensorManager mgr(bus, bus);
+    buildSensors(sensorConfig, mgr);
+    auto zones = buildZones(zoneConfig, zoneDetailsConfig, mgr, bus);
+
+    if (cycle)
+    {
+        for (const auto& [id, zone] : zones)
+        {
+            uint64_t cycleCnt = 0;
+            pidControlStart(zone);
+            pidControlCycle(zone, cycleCnt);
+        }
+    }
+
+    std::cout << imagePeakRssKb() << "\n";
+    return 0;
+}
+
+/*
+ * The peak RSS, in kB, of building the configuration at path (and cycling
+ * its zones if cycle) in a new process.  ru_maxrss would carry over the
+ * benchmark's own peak, which a forked child starts with, so the child
+ * execs this program afresh and reports the peak of that image.
+ */
+double peakRssKb(const std::string& path, bool cycle)
+{
+    std::string command = std::filesystem::read_symlink("/proc/self/exe");
+    command = "'" + command + "' --peak-rss " + (cycle ? "cycle" : "build") +
+              " '" + path + "' 2>/dev/null";
+
+    FILE* child = popen(command.c_str(), "r");
+    if (child == nullptr)
+    {
+        throw std::runtime_error("Unable to run " + command);
+    }
+
+    double kb = 0;
+    int read = fscanf(child, "%lf", &kb);
+    int status = pclose(child);
+    if (read != 1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+        throw std::runtime_error("Unable to measure " + path);
+    }
+
+    return kb;
+}
+
+// Reading and parsing the json, into the sensor and zone configuration.
+void BM_ParseConfig(benchmark::State& state)
+{
+    ScaleConfig config(state);
+
+    for (auto _ : state)
+    {
+        auto data = parseValidateJson(config.path);
+        auto sensorConfig = buildSensorsFromJson(data);
+        auto pidConfig = buildPIDsFromJson(data);
+        benchmark::DoNotOptimize(sensorConfig);
+        benchmark::DoNotOptimize(pidConfig);
+    }
+
+    state.counters["sensors"] = config.sensorCount;
+}
+
+// Building the sensors and zones from a parsed configuration.
+void BM_BuildConfig(benchmark::State& state)
+{
+    ScaleConfig config(state);
+    auto data = parseValidateJson(config.path);
+    auto sensorConfig = buildSensorsFromJson(data);
+    auto [zoneConfig, zoneDetailsConfig] = buildPIDsFromJson(data);
+
+    ::testing::NiceMock<sdbusplus::SdBusMock> sdbus;
+    auto bus = sdbusplus::get_mocked_new(&sdbus);
+
+    for (auto _ : state)
+    {
+        SensorManager mgr(bus, bus);
+        buildSensors(sensorConfig, mgr);
+        auto zones = buildZones(zoneConfig, zoneDetailsConfig, mgr, bus);
+        benchmark::DoNotOptimize(zones);
+    }
+
+    state.counters["sensors"] = config.sensorCount;
+    state.counters["peak_rss_kB"] = peakRssKb(config.path, false);
+}
+
+// One fan cycle of every zone, with a thermal cycle every tenth.
+void BM_ZoneCycle(benchmark::State& state)
+{
+    ScaleConfig config(state);
+    auto data = parseValidateJson(config.path);
+    auto sensorConfig = buildSensorsFromJson(data);
+    auto [zoneConfig, zoneDetailsConfig] = buildPIDsFromJson(data);
+
+    ::testing::NiceMock<sdbusplus::SdBusMock> sdbus;
+    auto bus = sdbusplus::get_mocked_new(&sdbus);
+    SensorManager mgr(bus, bus);
+    buildSensors(sensorConfig, mgr);
+    auto zones = buildZones(zoneConfig, zoneDetailsConfig, mgr, bus);
+
+    std::vector<std::shared_ptr<ZoneInterface>> running;
+    for (const auto& [id, zone] : zones)
+    {
+        pidControlStart(zone);
+        running.push_back(zone);
+    }
+    std::vector<uint64_t> cycleCnt(running.size(), 0);
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < running.size(); i++)
+        {
+            pidControlCycle(running[i], cycleCnt[i]);
+        }
+    }
+
+    state.counters["sensors"] = config.sensorCount;
+    state.counters["peak_rss_kB"] = peakRssKb(config.path, true);
+}
+
+void scaleArgs(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({"zones", "sensors", "controllers"})
+        ->ArgsProduct({{1, 4, 16}, {8, 32, 128}, {2, 8}});
+}
+
+BENCHMARK(BM_ParseConfig)->Apply(scaleArgs)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_BuildConfig)->Apply(scaleArgs)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ZoneCycle)->Apply(scaleArgs)->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace pid_control
+
+int main(int argc, char** argv)
+{
+    if (argc == 4 && std::strcmp(argv[1], "--peak-rss") == 0)
+    {
+        return pid_control::measureConfig(argv[3],
+                                          std::strcmp(argv[2], "cycle") == 0);
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
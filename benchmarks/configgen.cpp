@@ -0,0 +1,148 @@
+#include "configgen.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace pid_control
+{
+namespace bench
+{
+
+size_t fansPerZone(const ConfigShape& shape)
+{
+    return std::max<size_t>(1, shape.sensors / 4);
+}
+
+static json makePid(double proportionalCoeff, double integralCoeff,
+                    double feedFwdGainCoeff, double outMin, double outMax)
+{
+    return {
+        {"samplePeriod", 0.1},
+        {"proportionalCoeff", proportionalCoeff},
+        {"integralCoeff", integralCoeff},
+        {"feedFwdOffsetCoeff", 0.0},
+        {"feedFwdGainCoeff", feedFwdGainCoeff},
+        {"integralLimit_min", outMin},
+        {"integralLimit_max", outMax},
+        {"outLim_min", outMin},
+        {"outLim_max", outMax},
+        {"slewNeg", 0.0},
+        {"slewPos", 0.0},
+    };
+}
+
+static json makeStepwise(void)
+{
+    return {
+        {"samplePeriod", 1.0},
+        {"positiveHysteresis", 0.0},
+        {"negativeHysteresis", 0.0},
+        {"isCeiling", false},
+        {"reading", {{"0", 25}, {"1", 35}, {"2", 45}, {"3", 55}}},
+        {"output", {{"0", 3000}, {"1", 5000}, {"2", 7000}, {"3", 10000}}},
+    };
+}
+
+json generateConfig(const ConfigShape& shape)
+{
+    size_t fans = fansPerZone(shape);
+    size_t temps = (shape.sensors > fans) ? shape.sensors - fans : 1;
+    size_t controllers = std::max<size_t>(1, shape.controllers);
+
+    json sensors = json::array();
+    json zones = json::array();
+
+    for (size_t z = 0; z < shape.zones; z++)
+    {
+        std::string prefix = "z" + std::to_string(z) + "_";
+
+        json fanNames = json::array();
+        for (size_t i = 0; i < fans; i++)
+        {
+            std::string n = std::to_string(z * fans + i + 1);
+            std::string name = prefix + "fan" + std::to_string(i);
+            sensors.push_back({
+                {"name", name},
+                {"type", "fan"},
+                {"readPath", shape.sysfsDir + "/fan" + n + "_input"},
+                {"writePath", shape.sysfsDir + "/pwm" + n},
+                {"min", 0},
+                {"max", 255},
+            });
+            fanNames.push_back(name);
+        }
+
+        std::vector<json> inputs(controllers, json::array());
+        for (size_t i = 0; i < std::max(temps, controllers); i++)
+        {
+            std::string name = prefix + "temp" + std::to_string(i % temps);
+            if (i < temps)
+            {
+                sensors.push_back({
+                    {"name", name},
+                    {"type", "temp"},
+                    {"readPath",
+                     "/xyz/openbmc_project/extsensors/temperature/" + name},
+                    {"timeout", 0},
+                });
+            }
+            inputs[i % controllers].push_back(name);
+        }
+
+        json pids = json::array();
+        pids.push_back({
+            {"name", prefix + "fans"},
+            {"type", "fan"},
+            {"inputs", fanNames},
+            {"setpoint", 0.0},
+            {"pid", makePid(0.0, 0.0, 0.01, 20.0, 100.0)},
+        });
+
+        for (size_t c = 0; c < controllers; c++)
+        {
+            json pid = {
+                {"name", prefix + "ctl" + std::to_string(c)},
+                {"inputs", inputs[c]},
+            };
+            switch (c % 3)
+            {
+                case 0:
+                    pid["type"] = "temp";
+                    pid["setpoint"] = 70.0;
+                    pid["pid"] = makePid(-200.0, -20.0, 0.0, 3000.0, 10000.0);
+                    break;
+                case 1:
+                    pid["type"] = "margin";
+                    pid["setpoint"] = 10.0;
+                    pid["pid"] = makePid(200.0, 20.0, 0.0, 3000.0, 10000.0);
+                    break;
+                default:
+                    pid["type"] = "stepwise";
+                    pid["setpoint"] = 0.0;
+                    pid["pid"] = makeStepwise();
+                    break;
+            }
+            pids.push_back(pid);
+        }
+
+        zones.push_back({
+            {"id", z},
+            {"minThermalOutput", 3000.0},
+            {"failsafePercent", 100.0},
+            {"cycleIntervalTimeMS", 100},
+            {"updateThermalsTimeMS", 1000},
+            {"pids", pids},
+        });
+    }
+
+    return {{"sensors", sensors}, {"zones", zones}};
+}
+
+} // namespace bench
+} // namespace pid_control
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
+#include <string>
+
+namespace pid_control
+{
+namespace bench
+{
+
+/* The shape of a generated configuration. */
+struct ConfigShape
+{
+    size_t zones = 1;
+    size_t sensors = 8;     // per zone, a quarter of them fans
+    size_t controllers = 2; // thermal controllers per zone, besides the fans'
+    std::string sysfsDir = "/sys/class/hwmon/hwmon0"; // for the fan files
+};
+
+/*
+ * Generate a valid json configuration of the given shape.
+ *
+ * Each zone has its own fans and temperature sensors, so sensors * zones in
+ * all.  The fans are read from <sysfsDir>/fan<n>_input and written to
+ * <sysfsDir>/pwm<n>, and all of a zone's fans are under one fan PID.  The
+ * temperature sensors are host sensors, spread round robin over the zone's
+ * thermal controllers, which take turns being temp PIDs, margin PIDs and
+ * stepwise controllers.
+ */
+nlohmann::json generateConfig(const ConfigShape& shape);
+
+/* The number of fans in each zone of a configuration of the given shape. */
+size_t fansPerZone(const ConfigShape& shape);
+
+} // namespace bench
+} // namespace pid_control
@@ -0,0 +1,140 @@
+#include "dbus/dbushelper_interface.hpp"
+#include "dbus/dbuspassive.hpp"
+#include "test/dbushelper_mock.hpp"
+
+#include <sys/socket.h>
+#include <systemd/sd-bus.h>
+#include <unistd.h>
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/message.hpp>
+#include <sdbusplus/test/sdbus_mock.hpp>
+#include <xyz/openbmc_project/Sensor/Value/common.hpp>
+
+#include <array>
+#include <memory>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <gmock/gmock.h>
+
+namespace pid_control
+{
+namespace
+{
+
+using SensorValue = sdbusplus::common::xyz::openbmc_project::sensor::Value;
+
+constexpr std::array<const char*, 3> sensorTypes = {"temp", "margin", "fan"};
+constexpr auto sensorPath = "/xyz/openbmc_project/sensors/temperature/bench";
+
+/* A passive sensor of the given type on a mocked bus that accepts anything. */
+struct BenchPassive
+{
+    explicit BenchPassive(const std::string& type) :
+        bus(sdbusplus::get_mocked_new(&sdbus)),
+        passive(bus, type, "bench", std::make_unique<DbusHelperMock>(), false,
+                sensorPath, nullptr)
+    {
+        SensorProperties settings;
+        settings.value = 40.0;
+        settings.max = (type == "fan") ? 10000.0 : 0.0;
+        settings.available = true;
+        settings.unavailableAsFailed = true;
+        passive.initFromSettings(settings, false);
+    }
+
+    ::testing::NiceMock<sdbusplus::SdBusMock> sdbus;
+    sdbusplus::bus_t bus;
+    DbusPassive passive;
+};
+
+void BM_DbusPassiveUpdateValue(benchmark::State& state)
+{
+    BenchPassive bench(sensorTypes[state.range(0)]);
+    double value = 30.0;
+
+    for (auto _ : state)
+    {
+        value = (value > 80.0) ? 30.0 : value + 0.5;
+        bench.passive.updateValue(value, false);
+    }
+}
+
+/*
+ * handleSensorValue() on a real Value PropertiesChanged signal, as a sensor
+ * daemon sends it.  The signal is built and sealed on a bus over a
+ * socketpair that never reaches a broker, then read again each iteration.
+ */
+void BM_HandleSensorValue(benchmark::State& state)
+{
+    BenchPassive bench(sensorTypes[state.range(0)]);
+
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0,
+                   fds) < 0)
+    {
+        state.SkipWithError("socketpair failed");
+        return;
+    }
+
+    // The bus owns fds[0] once it's set.
+    sd_bus* bus = nullptr;
+    sd_bus_message* m = nullptr;
+    int rc = sd_bus_new(&bus);
+    if (rc >= 0)
+    {
+        rc = sd_bus_set_fd(bus, fds[0], fds[0]);
+    }
+    if (rc < 0)
+    {
+        close(fds[0]);
+    }
+    if (rc >= 0)
+    {
+        rc = sd_bus_start(bus);
+    }
+    if (rc >= 0)
+    {
+        rc = sd_bus_message_new_signal(bus, &m, sensorPath,
+                                       "org.freedesktop.DBus.Properties",
+                                       "PropertiesChanged");
+    }
+    if (rc >= 0)
+    {
+        rc = sd_bus_message_append(m, "sa{sv}as", SensorValue::interface, 1,
+                                   SensorValue::property_names::value, "d",
+                                   42.0, 0);
+    }
+    if (rc >= 0)
+    {
+        rc = sd_bus_message_seal(m, 1, 0);
+    }
+
+    if (rc < 0)
+    {
+        state.SkipWithError("Unable to build the signal");
+    }
+    else
+    {
+        auto msg = sdbusplus::message_t(m);
+
+        for (auto _ : state)
+        {
+            sd_bus_message_rewind(m, 1);
+            benchmark::DoNotOptimize(handleSensorValue(msg, &bench.passive));
+        }
+    }
+
+    sd_bus_message_unref(m);
+    sd_bus_unref(bus);
+    close(fds[1]);
+}
+
+BENCHMARK(BM_DbusPassiveUpdateValue)->ArgName("type")->DenseRange(0, 2);
+BENCHMARK(BM_HandleSensorValue)->ArgName("type")->DenseRange(0, 2);
+
+} // namespace
+} // namespace pid_control
+
+BENCHMARK_MAIN();
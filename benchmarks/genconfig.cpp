@@ -0,0 +1,45 @@
+#include "configgen.hpp"
+
+#include <CLI/CLI.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[])
+{
+    pid_control::bench::ConfigShape shape;
+    std::string outputPath;
+
+    CLI::App app{"Generate a synthetic fan control configuration"};
+
+    app.add_option("-z,--zones", shape.zones, "Zones, default 1");
+    app.add_option("-s,--sensors", shape.sensors,
+                   "Sensors per zone, a quarter of them fans, default 8");
+    app.add_option("-c,--controllers", shape.controllers,
+                   "Thermal controllers per zone, default 2");
+    app.add_option("--sysfs", shape.sysfsDir,
+                   "Directory of the fan input and pwm files");
+    app.add_option("-o,--output", outputPath,
+                   "Optional file for the configuration, default stdout");
+
+    CLI11_PARSE(app, argc, argv);
+
+    auto config = pid_control::bench::generateConfig(shape).dump(4);
+
+    if (outputPath.empty())
+    {
+        std::cout << config << "\n";
+        return 0;
+    }
+
+    std::ofstream output(outputPath);
+    output << config << "\n";
+    if (!output)
+    {
+        std::cerr << "Unable to write " << outputPath << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include "pid/ec/pid.hpp"
+#include "pid/ec/pidbatch.hpp"
+#include "test/pid_helpers.hpp"
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace pid_control
+{
+namespace
+{
+
+std::vector<double> makeInputs(size_t count)
+{
+    std::vector<double> inputs(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        inputs[i] = 40.0 + (i % 30);
+    }
+    return inputs;
+}
+
+void BM_PidReference(benchmark::State& state)
+{
+    size_t count = state.range(0);
+    std::mt19937 gen(1);
+    std::vector<ec::pid_info_t> pids = makeRandomControllers(gen, count);
+    std::vector<double> inputs = makeInputs(count);
+    std::vector<double> outputs(count);
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            outputs[i] = ec::pid(&pids[i], inputs[i], 50.0);
+        }
+        benchmark::DoNotOptimize(outputs.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_PidBatch(benchmark::State& state)
+{
+    size_t count = state.range(0);
+    ec::PidBatch batch;
+    std::mt19937 gen(1);
+    for (const auto& info : makeRandomControllers(gen, count))
+    {
+        batch.add(info);
+    }
+    std::vector<double> inputs = makeInputs(count);
+    std::vector<double> setpoints(count, 50.0);
+    std::vector<double> outputs(count);
+
+    for (auto _ : state)
+    {
+        batch.run(inputs, setpoints, outputs);
+        benchmark::DoNotOptimize(outputs.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_PidReference)->Arg(8)->Arg(64)->Arg(512);
+BENCHMARK(BM_PidBatch)->Arg(8)->Arg(64)->Arg(512);
+
+} // namespace
+} // namespace pid_control
+
+BENCHMARK_MAIN();
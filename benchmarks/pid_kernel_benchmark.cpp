@@ -0,0 +1,75 @@
+#include "pid/ec/pid.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace pid_control
+{
+namespace
+{
+
+enum Shape
+{
+    proportional,
+    proportionalIntegral,
+    proportionalIntegralSlew,
+    full,
+};
+
+ec::pid_info_t makeController(int shape)
+{
+    ec::pid_info_t info = {};
+    info.ts = 1.0;
+    info.proportionalCoeff = -0.5;
+    info.integralLimit = {0.0, 100.0};
+    info.outLim = {0.0, 100.0};
+
+    if (shape != proportional)
+    {
+        info.integralCoeff = -0.1;
+    }
+    if (shape == proportionalIntegralSlew || shape == full)
+    {
+        info.slewPos = 10.0;
+    }
+    if (shape == full)
+    {
+        info.derivativeCoeff = 0.05;
+        info.feedFwdGain = 0.2;
+    }
+
+    return info;
+}
+
+// ec::pid() as controllers call it with core logging off.
+void BM_PidGeneric(benchmark::State& state)
+{
+    ec::pid_info_t info = makeController(state.range(0));
+    double input = 40.0;
+
+    for (auto _ : state)
+    {
+        input = (input > 60.0) ? 40.0 : input + 0.5;
+        benchmark::DoNotOptimize(ec::pid(&info, input, 50.0, nullptr));
+    }
+}
+
+void BM_PidSpecialized(benchmark::State& state)
+{
+    ec::pid_info_t info = makeController(state.range(0));
+    ec::pid_kernel_t kernel = ec::pidKernel(info);
+    double input = 40.0;
+
+    for (auto _ : state)
+    {
+        input = (input > 60.0) ? 40.0 : input + 0.5;
+        benchmark::DoNotOptimize(kernel(&info, input, 50.0));
+    }
+}
+
+BENCHMARK(BM_PidGeneric)->DenseRange(proportional, full);
+BENCHMARK(BM_PidSpecialized)->DenseRange(proportional, full);
+
+} // namespace
+} // namespace pid_control
+
+BENCHMARK_MAIN();
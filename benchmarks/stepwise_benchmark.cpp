@@ -0,0 +1,45 @@
+#include "pid/ec/stepwise.hpp"
+
+#include <cstddef>
+
+#include <benchmark/benchmark.h>
+
+namespace pid_control
+{
+namespace
+{
+
+ec::StepwiseInfo makeCurve(size_t points, bool interpolate)
+{
+    ec::StepwiseInfo info;
+    info.ts = 1.0;
+    info.interpolate = interpolate;
+
+    for (size_t i = 0; i < points; i++)
+    {
+        info.reading.push_back(20.0 + 60.0 * i / points);
+        info.output.push_back(10.0 + 90.0 * i / points);
+    }
+
+    return info;
+}
+
+// One lookup per iteration, sweeping the input across the whole curve.
+void BM_Stepwise(benchmark::State& state)
+{
+    ec::StepwiseInfo info = makeCurve(state.range(0), state.range(1));
+    double input = 15.0;
+
+    for (auto _ : state)
+    {
+        input = (input > 85.0) ? 15.0 : input + 0.7;
+        benchmark::DoNotOptimize(ec::stepwise(info, input));
+    }
+}
+
+BENCHMARK(BM_Stepwise)->ArgsProduct({{2, 8, 32, 128}, {false, true}});
+
+} // namespace
+} // namespace pid_control
+
+BENCHMARK_MAIN();
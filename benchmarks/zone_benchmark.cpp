@@ -0,0 +1,217 @@
+#include "clock.hpp"
+#include "conf.hpp"
+#include "interfaces.hpp"
+#include "pid/ec/pid.hpp"
+#include "pid/fancontroller.hpp"
+#include "pid/pidcontroller.hpp"
+#include "pid/thermalcontroller.hpp"
+#include "pid/zone.hpp"
+#include "sensors/manager.hpp"
+#include "sensors/pluggable.hpp"
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/test/sdbus_mock.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <gmock/gmock.h>
+
+namespace pid_control
+{
+namespace
+{
+
+/* A sensor reading that's always fresh, so the zone never goes failsafe. */
+class FixedRead : public ReadInterface
+{
+  public:
+    explicit FixedRead(double value) : _value(value) {}
+
+    ReadReturn read(void) override
+    {
+        return {_value, clockNow(), _value};
+    }
+
+  private:
+    double _value;
+};
+
+class NullWrite : public WriteInterface
+{
+  public:
+    NullWrite() : WriteInterface(0, 255) {}
+
+    void write(double value) override
+    {
+        benchmark::DoNotOptimize(value);
+    }
+};
+
+/*
+ * A zone of fanCount fans under one fan PID and, when thermalCount isn't
+ * zero, thermalCount sensors under one thermal PID, with every sensor read
+ * once and a fixed setpoint for the fans.  The zone's dbus objects are on a
+ * mocked bus that accepts anything.
+ */
+class BenchZone
+{
+  public:
+    BenchZone(size_t fanCount, size_t thermalCount, ThermalType type) :
+        _passiveBus(sdbusplus::get_mocked_new(&_sdbus)),
+        _hostBus(sdbusplus::get_mocked_new(&_sdbus)),
+        _modeBus(sdbusplus::get_mocked_new(&_sdbus)),
+        _mgr(_passiveBus, _hostBus),
+        _zone(0, 0.0, 100.0, conf::CycleTime(), _mgr, _modeBus, "/bench", true,
+              false)
+    {
+        ec::pidinfo info;
+        info.ts = 1.0;
+        info.proportionalCoeff = 0.01;
+        info.integralCoeff = 0.001;
+        info.integralLimit = {0.0, 100.0};
+        info.outLim = {0.0, 100.0};
+
+        std::vector<std::string> fans;
+        for (size_t i = 0; i < fanCount; i++)
+        {
+            fans.push_back("fan" + std::to_string(i));
+            addSensor("fan", fans.back(), 5000.0 + i);
+            _zone.addFanInput(fans.back(), false);
+        }
+        auto fanPid = FanController::createFanPid(&_zone, "fans", fans, info);
+        fan = fanPid.get();
+        _zone.addFanPID(std::move(fanPid));
+
+        if (thermalCount != 0)
+        {
+            info.proportionalCoeff = -1.0;
+            info.integralCoeff = -0.1;
+            info.outLim = {0.0, 10000.0};
+
+            std::vector<conf::SensorInput> inputs;
+            for (size_t i = 0; i < thermalCount; i++)
+            {
+                conf::SensorInput input;
+                input.name = "temp" + std::to_string(i);
+                inputs.push_back(input);
+                addSensor("temp", input.name, 40.0 + i);
+                _zone.addThermalInput(input.name, false);
+            }
+            auto thermalPid = ThermalController::createThermalPid(
+                &_zone, "temps", inputs, 50.0, info, type);
+            thermal = thermalPid.get();
+            _zone.addThermalPID(std::move(thermalPid));
+            _zone.addPidControlProcess("temps", "temp", 50.0, _modeBus,
+                                       "/bench/temps", true);
+        }
+
+        _zone.initializeCache();
+        _zone.updateFanTelemetry();
+        _zone.updateSensors();
+        _zone.addPidControlProcess("bench", "temp", 0.0, _modeBus,
+                                   "/bench/bench", true);
+        _zone.addSetPoint(4000.0, "bench");
+        _zone.determineMaxSetPointRequest();
+    }
+
+    DbusPidZone& zone(void)
+    {
+        return _zone;
+    }
+
+    PIDController* fan = nullptr;
+    PIDController* thermal = nullptr;
+
+  private:
+    void addSensor(const std::string& type, const std::string& name,
+                   double value)
+    {
+        _mgr.addSensor(type, name,
+                       std::make_unique<PluggableSensor>(
+                           name, 0, std::make_unique<FixedRead>(value),
+                           std::make_unique<NullWrite>()));
+    }
+
+    ::testing::NiceMock<sdbusplus::SdBusMock> _sdbus;
+    sdbusplus::bus_t _passiveBus;
+    sdbusplus::bus_t _hostBus;
+    sdbusplus::bus_t _modeBus;
+    SensorManager _mgr;
+    DbusPidZone _zone;
+};
+
+void BM_ThermalInputProc(benchmark::State& state)
+{
+    BenchZone bench(1, state.range(1),
+                    static_cast<ThermalType>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(bench.thermal->inputProc());
+    }
+}
+
+void BM_FanInputProc(benchmark::State& state)
+{
+    BenchZone bench(state.range(0), 0, ThermalType::margin);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(bench.fan->inputProc());
+    }
+}
+
+void BM_FanOutputProc(benchmark::State& state)
+{
+    BenchZone bench(state.range(0), 0, ThermalType::margin);
+    double output = 30.0;
+
+    for (auto _ : state)
+    {
+        output = (output > 90.0) ? 30.0 : output + 1.0;
+        bench.fan->outputProc(output);
+    }
+}
+
+void BM_UpdateFanTelemetry(benchmark::State& state)
+{
+    BenchZone bench(state.range(0), 0, ThermalType::margin);
+
+    for (auto _ : state)
+    {
+        bench.zone().updateFanTelemetry();
+    }
+}
+
+void BM_ProcessFans(benchmark::State& state)
+{
+    BenchZone bench(state.range(0), 0, ThermalType::margin);
+
+    for (auto _ : state)
+    {
+        bench.zone().processFans();
+    }
+}
+
+BENCHMARK(BM_ThermalInputProc)
+    ->ArgNames({"type", "inputs"})
+    ->ArgsProduct({{static_cast<int>(ThermalType::margin),
+                    static_cast<int>(ThermalType::absolute),
+                    static_cast<int>(ThermalType::summation)},
+                   {1, 4, 16, 64}});
+BENCHMARK(BM_FanInputProc)->ArgName("fans")->RangeMultiplier(2)->Range(1, 32);
+BENCHMARK(BM_FanOutputProc)->ArgName("fans")->RangeMultiplier(2)->Range(1, 32);
+BENCHMARK(BM_UpdateFanTelemetry)
+    ->ArgName("fans")
+    ->RangeMultiplier(2)
+    ->Range(1, 32);
+BENCHMARK(BM_ProcessFans)->ArgName("fans")->RangeMultiplier(2)->Range(1, 32);
+
+} // namespace
+} // namespace pid_control
+
+BENCHMARK_MAIN();
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <chrono>
+
+namespace pid_control
+{
+
+/*
+ * The source of the current time for the control loops: sensor timestamps,
+ * sensor timeouts, and failsafe logging.  It's the steady clock unless
+ * replaced by setClock(), as tests and swampd-sim do to control time.
+ */
+class Clock
+{
+  public:
+    using duration = std::chrono::steady_clock::duration;
+    using time_point = std::chrono::steady_clock::time_point;
+
+    virtual ~Clock() = default;
+
+    virtual time_point now(void) const = 0;
+};
+
+class SteadyClock : public Clock
+{
+  public:
+    time_point now(void) const override
+    {
+        return std::chrono::steady_clock::now();
+    }
+};
+
+/* A clock that only moves when told to. */
+class ManualClock : public Clock
+{
+  public:
+    explicit ManualClock(time_point start = time_point()) : _now(start) {}
+
+    time_point now(void) const override
+    {
+        return _now;
+    }
+
+    void advance(duration by)
+    {
+        _now += by;
+    }
+
+    void set(time_point to)
+    {
+        _now = to;
+    }
+
+  private:
+    time_point _now;
+};
+
+namespace detail
+{
+inline const SteadyClock steadyClock;
+inline const Clock* currentClock = &steadyClock;
+} // namespace detail
+
+/* The clock in use. */
+inline const Clock& getClock(void)
+{
+    return *detail::currentClock;
+}
+
+/* Use the given clock from now on, or the steady clock for nullptr.  The
+ * caller keeps ownership.  Returns the clock that was in use.
+ */
+inline const Clock* setClock(const Clock* clock)
+{
+    const Clock* previous = detail::currentClock;
+    detail::currentClock = clock ? clock : &detail::steadyClock;
+    return previous;
+}
+
+/* Shorthand for getClock().now(). */
+inline Clock::time_point clockNow(void)
+{
+    return getClock().now();
+}
+
+/* Uses a clock until it goes out of scope, then puts the previous one back. */
+class ScopedClock
+{
+  public:
+    explicit ScopedClock(const Clock& clock) : _previous(setClock(&clock)) {}
+    ~ScopedClock()
+    {
+        setClock(_previous);
+    }
+
+    ScopedClock(const ScopedClock&) = delete;
+    ScopedClock& operator=(const ScopedClock&) = delete;
+
+  private:
+    const Clock* _previous;
+};
+
+} // namespace pid_control
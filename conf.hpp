@@ -3,6 +3,7 @@
 #include "pid/ec/pid.hpp"
 #include "pid/ec/stepwise.hpp"
 
+#include <cmath>
 #include <cstdint>
 #include <limits>
 #include <map>
@@ -15,6 +16,32 @@ namespace pid_control
 namespace conf
 {
 
+/* Note: If you update these structs you need to update the encoding in
+ * configcache.cpp and bump its version.
+ */
+
+/*
+ * One stage of a sensor's input filter chain.  Only the fields for the given
+ * type are used.
+ */
+struct SensorFilterConfig
+{
+    /* One of "ema", "median", "rateLimit" or "spike". */
+    std::string type;
+    /* ema: weight of the newest sample, in (0.0, 1.0]. */
+    double alpha = 1.0;
+    /* median: number of samples the median is taken over. */
+    uint32_t window = 1;
+    /* rateLimit: largest change allowed per second. */
+    double maxRate = 0.0;
+    /* spike: largest jump from the last accepted sample. */
+    double threshold = 0.0;
+    /* spike: consecutive rejects before a jump is accepted as real. */
+    uint32_t maxRejects = 1;
+
+    bool operator==(const SensorFilterConfig&) const = default;
+};
+
 /*
  * General sensor structure used for configuration.
  */
@@ -28,10 +55,15 @@ struct SensorConfig
     /* min/max values for writing a percentage or error checking. */
     int64_t min;
     int64_t max;
-    int64_t timeout;
+    /* Staleness timeout in milliseconds, 0 disables the check. */
+    int64_t timeoutMs;
     bool ignoreDbusMinMax;
     bool unavailableAsFailed;
     bool ignoreFailIfHostOff;
+    /* Filters applied to each new reading, in order. */
+    std::vector<SensorFilterConfig> filters;
+
+    bool operator==(const SensorConfig&) const = default;
 };
 
 /*
@@ -47,6 +79,18 @@ struct SensorInput
     double convertMarginZero = std::numeric_limits<double>::quiet_NaN();
     bool convertTempToMargin = false;
     bool missingIsAcceptable = false;
+
+    bool operator==(const SensorInput& rhs) const
+    {
+        // convertMarginZero is NaN when unused, which never compares equal.
+        bool sameMarginZero = (convertMarginZero == rhs.convertMarginZero) ||
+                              (std::isnan(convertMarginZero) &&
+                               std::isnan(rhs.convertMarginZero));
+
+        return name == rhs.name && sameMarginZero &&
+               convertTempToMargin == rhs.convertTempToMargin &&
+               missingIsAcceptable == rhs.missingIsAcceptable;
+    }
 };
 
 /*
@@ -60,6 +104,24 @@ struct ControllerInfo
     ec::pidinfo pidInfo;             // pid details
     ec::StepwiseInfo stepwiseInfo;
     double failSafePercent;
+
+    /* Only the pidInfo or stepwiseInfo that the type uses is compared, the
+     * other one is never filled in.
+     */
+    bool operator==(const ControllerInfo& rhs) const
+    {
+        if (type != rhs.type || inputs != rhs.inputs ||
+            setpoint != rhs.setpoint || failSafePercent != rhs.failSafePercent)
+        {
+            return false;
+        }
+        if (type != "stepwise")
+        {
+            return pidInfo == rhs.pidInfo;
+        }
+
+        return stepwiseInfo == rhs.stepwiseInfo;
+    }
 };
 
 struct CycleTime
@@ -69,6 +131,8 @@ struct CycleTime
 
     /* The interval of updating thermals. 1 second by default */
     uint64_t updateThermalsTimeMS = 1000; // milliseconds
+
+    bool operator==(const CycleTime&) const = default;
 };
 
 /*
@@ -90,6 +154,8 @@ struct ZoneConfig
     /* Enable accumulation of the output PWM of different controllers with same
      * sensor */
     bool accumulateSetPoint;
+
+    bool operator==(const ZoneConfig&) const = default;
 };
 
 using PIDConf = std::map<std::string, ControllerInfo>;
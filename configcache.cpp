@@ -0,0 +1,547 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright 2026 Google Inc
+
+#include "configcache.hpp"
+
+#include "conf.hpp"
+#include "pid/ec/stepwise.hpp"
+#include "util.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pid_control
+{
+
+/* Bump whenever the encoding, or the conf structs it encodes, change. */
+static constexpr uint32_t cacheVersion = 2;
+static constexpr char cacheMagic[4] = {'S', 'W', 'P', 'C'};
+
+struct CacheHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceHash;
+    uint64_t payloadHash;
+    uint64_t payloadSize;
+};
+
+static_assert(sizeof(CacheHeader) == 32 &&
+              std::is_trivially_copyable_v<CacheHeader>);
+
+namespace
+{
+
+/* Values are written in host byte order, the cache never leaves the BMC. */
+class Encoder
+{
+  public:
+    template <typename T>
+        requires std::is_arithmetic_v<T>
+    void put(T value)
+    {
+        _data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void put(bool value)
+    {
+        put(static_cast<uint8_t>(value));
+    }
+
+    void put(const std::string& value)
+    {
+        put(static_cast<uint32_t>(value.size()));
+        _data.append(value);
+    }
+
+    std::string& data()
+    {
+        return _data;
+    }
+
+  private:
+    std::string _data;
+};
+
+class Decoder
+{
+  public:
+    explicit Decoder(std::string_view data) : _data(data) {}
+
+    template <typename T>
+        requires std::is_arithmetic_v<T>
+    T get()
+    {
+        T value;
+        std::memcpy(&value, take(sizeof(value)).data(), sizeof(value));
+        return value;
+    }
+
+    bool getBool()
+    {
+        return get<uint8_t>() != 0;
+    }
+
+    std::string getString()
+    {
+        return std::string(take(get<uint32_t>()));
+    }
+
+    /* An element count, checked against the bytes left so a corrupt count
+     * fails here rather than in a huge allocation.
+     */
+    uint32_t getCount(size_t minElementSize)
+    {
+        auto count = get<uint32_t>();
+        if (count > _data.size() / minElementSize)
+        {
+            throw std::runtime_error("Configuration cache is truncated");
+        }
+        return count;
+    }
+
+    bool empty() const
+    {
+        return _data.empty();
+    }
+
+  private:
+    std::string_view take(size_t size)
+    {
+        if (size > _data.size())
+        {
+            throw std::runtime_error("Configuration cache is truncated");
+        }
+        std::string_view out = _data.substr(0, size);
+        _data.remove_prefix(size);
+        return out;
+    }
+
+    std::string_view _data;
+};
+
+void encodeSensor(Encoder& e, const conf::SensorConfig& s)
+{
+    e.put(s.type);
+    e.put(s.readPath);
+    e.put(s.writePath);
+    e.put(s.min);
+    e.put(s.max);
+    e.put(s.timeoutMs);
+    e.put(s.ignoreDbusMinMax);
+    e.put(s.unavailableAsFailed);
+    e.put(s.ignoreFailIfHostOff);
+    e.put(static_cast<uint32_t>(s.filters.size()));
+    for (const auto& f : s.filters)
+    {
+        e.put(f.type);
+        e.put(f.alpha);
+        e.put(f.window);
+        e.put(f.maxRate);
+        e.put(f.threshold);
+        e.put(f.maxRejects);
+    }
+}
+
+conf::SensorConfig decodeSensor(Decoder& d)
+{
+    conf::SensorConfig s;
+    s.type = d.getString();
+    s.readPath = d.getString();
+    s.writePath = d.getString();
+    s.min = d.get<int64_t>();
+    s.max = d.get<int64_t>();
+    s.timeoutMs = d.get<int64_t>();
+    s.ignoreDbusMinMax = d.getBool();
+    s.unavailableAsFailed = d.getBool();
+    s.ignoreFailIfHostOff = d.getBool();
+    for (uint32_t count = d.getCount(4); count > 0; count--)
+    {
+        conf::SensorFilterConfig f;
+        f.type = d.getString();
+        f.alpha = d.get<double>();
+        f.window = d.get<uint32_t>();
+        f.maxRate = d.get<double>();
+        f.threshold = d.get<double>();
+        f.maxRejects = d.get<uint32_t>();
+        s.filters.push_back(std::move(f));
+    }
+    return s;
+}
+
+void encodeLimits(Encoder& e, const ec::limits_t& l)
+{
+    e.put(l.min);
+    e.put(l.max);
+}
+
+void encodeDoubles(Encoder& e, const std::vector<double>& values)
+{
+    e.put(static_cast<uint32_t>(values.size()));
+    for (double value : values)
+    {
+        e.put(value);
+    }
+}
+
+std::vector<double> decodeDoubles(Decoder& d)
+{
+    std::vector<double> values(d.getCount(sizeof(double)));
+    for (double& value : values)
+    {
+        value = d.get<double>();
+    }
+    return values;
+}
+
+ec::limits_t decodeLimits(Decoder& d)
+{
+    ec::limits_t l;
+    l.min = d.get<double>();
+    l.max = d.get<double>();
+    return l;
+}
+
+/* Like operator==, only the pidInfo or stepwiseInfo the type uses is written.
+ * The other is never filled in, and would make equal configurations encode
+ * differently.
+ */
+void encodeController(Encoder& e, const conf::ControllerInfo& c)
+{
+    e.put(c.type);
+    e.put(static_cast<uint32_t>(c.inputs.size()));
+    for (const auto& input : c.inputs)
+    {
+        e.put(input.name);
+        e.put(input.convertMarginZero);
+        e.put(input.convertTempToMargin);
+        e.put(input.missingIsAcceptable);
+    }
+    e.put(c.setpoint);
+    e.put(c.failSafePercent);
+
+    if (c.type != "stepwise")
+    {
+        const ec::pidinfo& p = c.pidInfo;
+        e.put(p.checkHysterWithSetpt);
+        e.put(p.ts);
+        e.put(p.proportionalCoeff);
+        e.put(p.integralCoeff);
+        e.put(p.derivativeCoeff);
+        e.put(p.feedFwdOffset);
+        e.put(p.feedFwdGain);
+        encodeLimits(e, p.integralLimit);
+        encodeLimits(e, p.outLim);
+        e.put(p.slewNeg);
+        e.put(p.slewPos);
+        e.put(p.positiveHysteresis);
+        e.put(p.negativeHysteresis);
+        return;
+    }
+
+    const ec::StepwiseInfo& s = c.stepwiseInfo;
+    e.put(s.ts);
+    e.put(s.positiveHysteresis);
+    e.put(s.negativeHysteresis);
+    e.put(s.isCeiling);
+    e.put(s.interpolate);
+    encodeDoubles(e, s.reading);
+    encodeDoubles(e, s.output);
+}
+
+conf::ControllerInfo decodeController(Decoder& d)
+{
+    conf::ControllerInfo c;
+    c.type = d.getString();
+    for (uint32_t count = d.getCount(4); count > 0; count--)
+    {
+        conf::SensorInput input;
+        input.name = d.getString();
+        input.convertMarginZero = d.get<double>();
+        input.convertTempToMargin = d.getBool();
+        input.missingIsAcceptable = d.getBool();
+        c.inputs.push_back(std::move(input));
+    }
+    c.setpoint = d.get<double>();
+    c.failSafePercent = d.get<double>();
+
+    if (c.type != "stepwise")
+    {
+        ec::pidinfo& p = c.pidInfo;
+        p.checkHysterWithSetpt = d.getBool();
+        p.ts = d.get<double>();
+        p.proportionalCoeff = d.get<double>();
+        p.integralCoeff = d.get<double>();
+        p.derivativeCoeff = d.get<double>();
+        p.feedFwdOffset = d.get<double>();
+        p.feedFwdGain = d.get<double>();
+        p.integralLimit = decodeLimits(d);
+        p.outLim = decodeLimits(d);
+        p.slewNeg = d.get<double>();
+        p.slewPos = d.get<double>();
+        p.positiveHysteresis = d.get<double>();
+        p.negativeHysteresis = d.get<double>();
+        return c;
+    }
+
+    ec::StepwiseInfo& s = c.stepwiseInfo;
+    s.ts = d.get<double>();
+    s.positiveHysteresis = d.get<double>();
+    s.negativeHysteresis = d.get<double>();
+    s.isCeiling = d.getBool();
+    s.interpolate = d.getBool();
+    s.reading = decodeDoubles(d);
+    s.output = decodeDoubles(d);
+    return c;
+}
+
+void encodeZone(Encoder& e, const conf::ZoneConfig& z)
+{
+    e.put(z.minThermalOutput);
+    e.put(z.failsafePercent);
+    e.put(z.cycleTime.cycleIntervalTimeMS);
+    e.put(z.cycleTime.updateThermalsTimeMS);
+    e.put(z.accumulateSetPoint);
+}
+
+conf::ZoneConfig decodeZone(Decoder& d)
+{
+    conf::ZoneConfig z;
+    z.minThermalOutput = d.get<double>();
+    z.failsafePercent = d.get<double>();
+    z.cycleTime.cycleIntervalTimeMS = d.get<uint64_t>();
+    z.cycleTime.updateThermalsTimeMS = d.get<uint64_t>();
+    z.accumulateSetPoint = d.getBool();
+    return z;
+}
+
+} // namespace
+
+uint64_t hashBytes(std::string_view data)
+{
+    uint64_t hash = 0xcbf29ce484222325;
+    for (char c : data)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+uint64_t hashFile(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        throw std::runtime_error("Unable to open " + path);
+    }
+    std::string data((std::istreambuf_iterator<char>(in)),
+                     std::istreambuf_iterator<char>());
+    return hashBytes(data);
+}
+
+std::string serializeConfig(
+    const std::map<std::string, conf::SensorConfig>& sensorConfig,
+    const std::map<int64_t, conf::PIDConf>& zoneConfig,
+    const std::map<int64_t, conf::ZoneConfig>& zoneDetailsConfig)
+{
+    Encoder e;
+
+    e.put(static_cast<uint32_t>(sensorConfig.size()));
+    for (const auto& [name, sensor] : sensorConfig)
+    {
+        e.put(name);
+        encodeSensor(e, sensor);
+    }
+
+    e.put(static_cast<uint32_t>(zoneConfig.size()));
+    for (const auto& [zoneId, pids] : zoneConfig)
+    {
+        e.put(zoneId);
+        e.put(static_cast<uint32_t>(pids.size()));
+        for (const auto& [name, pid] : pids)
+        {
+            e.put(name);
+            encodeController(e, pid);
+        }
+    }
+
+    e.put(static_cast<uint32_t>(zoneDetailsConfig.size()));
+    for (const auto& [zoneId, zone] : zoneDetailsConfig)
+    {
+        e.put(zoneId);
+        encodeZone(e, zone);
+    }
+
+    return std::move(e.data());
+}
+
+void deserializeConfig(std::string_view data,
+                       std::map<std::string, conf::SensorConfig>& sensorConfig,
+                       std::map<int64_t, conf::PIDConf>& zoneConfig,
+                       std::map<int64_t, conf::ZoneConfig>& zoneDetailsConfig)
+{
+    Decoder d(data);
+    std::map<std::string, conf::SensorConfig> sensors;
+    std::map<int64_t, conf::PIDConf> pids;
+    std::map<int64_t, conf::ZoneConfig> zones;
+
+    for (uint32_t count = d.getCount(4); count > 0; count--)
+    {
+        std::string name = d.getString();
+        sensors[name] = decodeSensor(d);
+    }
+
+    for (uint32_t count = d.getCount(12); count > 0; count--)
+    {
+        auto& zone = pids[d.get<int64_t>()];
+        for (uint32_t pidCount = d.getCount(4); pidCount > 0; pidCount--)
+        {
+            std::string name = d.getString();
+            zone[name] = decodeController(d);
+        }
+    }
+
+    for (uint32_t count = d.getCount(8); count > 0; count--)
+    {
+        int64_t zoneId = d.get<int64_t>();
+        zones[zoneId] = decodeZone(d);
+    }
+
+    if (!d.empty())
+    {
+        throw std::runtime_error("Configuration cache has trailing data");
+    }
+
+    sensorConfig = std::move(sensors);
+    zoneConfig = std::move(pids);
+    zoneDetailsConfig = std::move(zones);
+}
+
+uint64_t hashConfig(
+    const std::map<std::string, conf::SensorConfig>& sensorConfig,
+    const std::map<int64_t, conf::PIDConf>& zoneConfig,
+    const std::map<int64_t, conf::ZoneConfig>& zoneDetailsConfig)
+{
+    return hashBytes(
+        serializeConfig(sensorConfig, zoneConfig, zoneDetailsConfig));
+}
+
+void writeConfigCache(
+    const std::string& path, uint64_t sourceHash,
+    const std::map<std::string, conf::SensorConfig>& sensorConfig,
+    const std::map<int64_t, conf::PIDConf>& zoneConfig,
+    const std::map<int64_t, conf::ZoneConfig>& zoneDetailsConfig)
+{
+    std::string payload =
+        serializeConfig(sensorConfig, zoneConfig, zoneDetailsConfig);
+
+    CacheHeader header;
+    std::memcpy(header.magic, cacheMagic, sizeof(header.magic));
+    header.version = cacheVersion;
+    header.sourceHash = sourceHash;
+    header.payloadHash = hashBytes(payload);
+    header.payloadSize = payload.size();
+
+    std::string contents(reinterpret_cast<const char*>(&header),
+                         sizeof(header));
+    contents += payload;
+    writeFileAtomic(path, contents);
+}
+
+/* Validate the mapped cache and decode it, or return false. */
+static bool loadConfigCache(
+    std::string_view file, uint64_t sourceHash,
+    std::map<std::string, conf::SensorConfig>& sensorConfig,
+    std::map<int64_t, conf::PIDConf>& zoneConfig,
+    std::map<int64_t, conf::ZoneConfig>& zoneDetailsConfig)
+{
+    CacheHeader header;
+    if (file.size() < sizeof(header))
+    {
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    file.remove_prefix(sizeof(header));
+
+    if (std::memcmp(header.magic, cacheMagic, sizeof(header.magic)) != 0 ||
+        header.version != cacheVersion)
+    {
+        return false;
+    }
+    if (header.sourceHash != sourceHash)
+    {
+        return false;
+    }
+    if (header.payloadSize != file.size() ||
+        header.payloadHash != hashBytes(file))
+    {
+        std::cerr << "Configuration cache is corrupt\n";
+        return false;
+    }
+
+    deserializeConfig(file, sensorConfig, zoneConfig, zoneDetailsConfig);
+    return true;
+}
+
+bool readConfigCache(const std::string& path, uint64_t sourceHash,
+                     std::map<std::string, conf::SensorConfig>& sensorConfig,
+                     std::map<int64_t, conf::PIDConf>& zoneConfig,
+                     std::map<int64_t, conf::ZoneConfig>& zoneDetailsConfig)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        return false;
+    }
+
+    bool loaded = false;
+    try
+    {
+        loaded = loadConfigCache(
+            std::string_view(static_cast<const char*>(mapped), size),
+            sourceHash, sensorConfig, zoneConfig, zoneDetailsConfig);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Ignoring configuration cache " << path << ": "
+                  << e.what() << "\n";
+    }
+    munmap(mapped, size);
+
+    return loaded;
+}
+
+} // namespace pid_control
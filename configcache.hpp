@@ -0,0 +1,83 @@
+#pragma once
+
+#include "conf.hpp"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+
+namespace pid_control
+{
+
+/* Where swampd keeps its precompiled configuration by default. */
+constexpr auto configCacheDefaultPath = "/var/lib/swampd/config.bin";
+
+/* The source hash recorded for configuration discovered over D-Bus. */
+constexpr uint64_t dbusConfigSource = 0;
+
+/*
+ * 64-bit FNV-1a hash of data.
+ */
+uint64_t hashBytes(std::string_view data);
+
+/*
+ * hashBytes() of the file's contents.
+ *
+ * @throw std::runtime_error if the file can't be read.
+ */
+uint64_t hashFile(const std::string& path);
+
+/*
+ * Encode the configuration maps in the cache's binary format.
+ */
+std::string serializeConfig(
+    const std::map<std::string, conf::SensorConfig>& sensorConfig,
+    const std::map<int64_t, conf::PIDConf>& zoneConfig,
+    const std::map<int64_t, conf::ZoneConfig>& zoneDetailsConfig);
+
+/*
+ * Decode configuration encoded by serializeConfig(), replacing the contents
+ * of the maps.
+ *
+ * @throw std::runtime_error if data is truncated or malformed.
+ */
+void deserializeConfig(std::string_view data,
+                       std::map<std::string, conf::SensorConfig>& sensorConfig,
+                       std::map<int64_t, conf::PIDConf>& zoneConfig,
+                       std::map<int64_t, conf::ZoneConfig>& zoneDetailsConfig);
+
+/*
+ * Hash of the configuration, equal for equal configurations.
+ */
+uint64_t hashConfig(
+    const std::map<std::string, conf::SensorConfig>& sensorConfig,
+    const std::map<int64_t, conf::PIDConf>& zoneConfig,
+    const std::map<int64_t, conf::ZoneConfig>& zoneDetailsConfig);
+
+/*
+ * Write the configuration to path, replacing any previous cache atomically.
+ * sourceHash identifies what the configuration was built from: the
+ * hashBytes() of the json file, or dbusConfigSource.
+ *
+ * @throw std::runtime_error or std::filesystem::filesystem_error on failure.
+ */
+void writeConfigCache(
+    const std::string& path, uint64_t sourceHash,
+    const std::map<std::string, conf::SensorConfig>& sensorConfig,
+    const std::map<int64_t, conf::PIDConf>& zoneConfig,
+    const std::map<int64_t, conf::ZoneConfig>& zoneDetailsConfig);
+
+/*
+ * Load the configuration written by writeConfigCache() into the maps.
+ *
+ * Returns false, leaving the maps untouched, if there's no cache, it was
+ * written by a different version, built from a different source, or fails
+ * its content hash.
+ */
+bool readConfigCache(const std::string& path, uint64_t sourceHash,
+                     std::map<std::string, conf::SensorConfig>& sensorConfig,
+                     std::map<int64_t, conf::PIDConf>& zoneConfig,
+                     std::map<int64_t, conf::ZoneConfig>& zoneDetailsConfig);
+
+} // namespace pid_control
@@ -21,6 +21,7 @@
 #include "dbushelper.hpp"
 #include "dbusutil.hpp"
 #include "ec/stepwise.hpp"
+#include "sensors/filter.hpp"
 #include "tuning.hpp"
 #include "util.hpp"
 
@@ -28,6 +29,7 @@
 
 #include <boost/asio/error.hpp>
 #include <boost/asio/steady_timer.hpp>
+#include <sdbusplus/asio/connection.hpp>
 #include <sdbusplus/bus.hpp>
 #include <sdbusplus/bus/match.hpp>
 #include <sdbusplus/exception.hpp>
@@ -45,12 +47,15 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <exception>
 #include <format>
+#include <initializer_list>
 #include <iostream>
-#include <limits>
 #include <list>
 #include <map>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <tuple>
@@ -107,73 +112,67 @@ inline std::string sensorNameToDbusName(const std::string& sensorName)
     return retString;
 }
 
-std::vector<std::string> getSelectedProfiles(sdbusplus::bus_t& bus)
+/* State shared by the matches that watch for configuration changes. */
+struct ReloadState
 {
-    std::vector<std::string> ret;
-    auto mapper = bus.new_method_call(
-        ObjectMapper::default_service, ObjectMapper::instance_path,
-        ObjectMapper::interface, ObjectMapper::method_names::get_sub_tree);
-    mapper.append("/", 0,
-                  std::array<const char*, 1>{ControlThermalMode::interface});
-    std::unordered_map<
-        std::string, std::unordered_map<std::string, std::vector<std::string>>>
-        respData;
-
-    try
-    {
-        auto resp = bus.call(mapper);
-        resp.read(respData);
-    }
-    catch (const sdbusplus::exception_t&)
-    {
-        // can't do anything without mapper call data
-        throw std::runtime_error("ObjectMapper Call Failure");
-    }
-    if (respData.empty())
-    {
-        // if the user has profiles but doesn't expose the interface to select
-        // one, just go ahead without using profiles
-        return ret;
-    }
+    boost::asio::steady_timer* timer = nullptr;
+    ReloadDebounce debounce;
+    /* The sensors the loaded configuration refers to, empty until a
+     * configuration with zones has been loaded.
+     */
+    SensorPatterns referenced;
+    size_t avoided = 0;
+};
+
+static ReloadState reloadState;
+static DiscoveryPasses discoveryPasses;
+
+size_t reloadAvoided(void)
+{
+    return ++reloadState.avoided;
+}
 
-    // assumption is that we should only have a small handful of selected
-    // profiles at a time (probably only 1), so calling each individually should
-    // not incur a large cost
-    for (const auto& objectPair : respData)
+/*
+ * The sensor names every Pid and Stepwise configuration refers to, as
+ * findSensors() takes them.
+ */
+std::vector<std::string> getReferencedSensors(
+    const ManagedObjectType& configurations)
+{
+    std::vector<std::string> names;
+
+    for (const auto& [path, interfaces] : configurations)
     {
-        const std::string& path = objectPair.first;
-        for (const auto& ownerPair : objectPair.second)
+        for (const char* interface :
+             {pidConfigurationInterface, stepwiseConfigurationInterface})
         {
-            const std::string& busName = ownerPair.first;
-            auto getProfile =
-                bus.new_method_call(busName.c_str(), path.c_str(),
-                                    "org.freedesktop.DBus.Properties", "Get");
-            getProfile.append(ControlThermalMode::interface,
-                              ControlThermalMode::property_names::current);
-            std::variant<std::string> variantResp;
-            try
+            auto base = interfaces.find(interface);
+            if (base == interfaces.end())
             {
-                auto resp = bus.call(getProfile);
-                resp.read(variantResp);
+                continue;
             }
-            catch (const sdbusplus::exception_t&)
+            for (const char* key : {"Inputs", "Outputs", "MissingIsAcceptable"})
             {
-                throw std::runtime_error("Failure getting profile");
+                auto find = base->second.find(key);
+                if (find == base->second.end())
+                {
+                    continue;
+                }
+                const auto* list =
+                    std::get_if<std::vector<std::string>>(&find->second);
+                if (list == nullptr)
+                {
+                    continue;
+                }
+                for (const std::string& name : *list)
+                {
+                    names.push_back(sensorNameToDbusName(name));
+                }
             }
-            std::string mode = std::get<std::string>(variantResp);
-            ret.emplace_back(std::move(mode));
         }
     }
-    if (debugEnabled)
-    {
-        std::cout << "Profiles selected: ";
-        for (const auto& profile : ret)
-        {
-            std::cout << profile << " ";
-        }
-        std::cout << "\n";
-    }
-    return ret;
+
+    return names;
 }
 
 int eventHandler(sd_bus_message* m, void* context, sd_bus_error*)
@@ -182,6 +181,7 @@ int eventHandler(sd_bus_message* m, void* context, sd_bus_error*)
     {
         throw std::runtime_error("Invalid match");
     }
+    ReloadState* state = static_cast<ReloadState*>(context);
 
     // we skip associations because the mapper populates these, not the sensors
     const std::array<const char*, 2> skipList = {
@@ -190,57 +190,83 @@ int eventHandler(sd_bus_message* m, void* context, sd_bus_error*)
             interface};
 
     sdbusplus::message_t message(m);
-    if (std::string(message.get_member()) == "InterfacesAdded")
+    std::string member = message.get_member();
+    if (member == "InterfacesAdded" || member == "InterfacesRemoved")
     {
         sdbusplus::object_path path;
-        std::unordered_map<
-            std::string,
-            std::unordered_map<std::string, std::variant<Associations, bool>>>
-            data;
+        if (member == "InterfacesAdded")
+        {
+            std::unordered_map<
+                std::string,
+                std::unordered_map<std::string,
+                                   std::variant<Associations, bool>>>
+                data;
 
-        message.read(path, data);
+            message.read(path, data);
 
-        for (const char* skip : skipList)
-        {
-            auto find = data.find(skip);
-            if (find != data.end())
+            for (const char* skip : skipList)
             {
-                data.erase(find);
-                if (data.empty())
+                auto find = data.find(skip);
+                if (find != data.end())
                 {
-                    return 1;
+                    data.erase(find);
+                    if (data.empty())
+                    {
+                        return 1;
+                    }
                 }
             }
-        }
 
-        if (debugEnabled)
-        {
-            std::cout << "New config detected: " << path.str << std::endl;
-            for (auto& d : data)
+            if (debugEnabled)
             {
-                std::cout << "\tdata is " << d.first << std::endl;
-                for (auto& second : d.second)
+                std::cout << "New config detected: " << path.str << std::endl;
+                for (auto& d : data)
                 {
-                    std::cout << "\t\tdata is " << second.first << std::endl;
+                    std::cout << "\tdata is " << d.first << std::endl;
+                    for (auto& second : d.second)
+                    {
+                        std::cout << "\t\tdata is " << second.first
+                                  << std::endl;
+                    }
                 }
             }
         }
-    }
+        else
+        {
+            message.read(path);
+        }
 
-    boost::asio::steady_timer* timer =
-        static_cast<boost::asio::steady_timer*>(context);
+        // A sensor no zone uses can come and go without a reload.
+        if (!state->referenced.empty() && !state->referenced.matches(path.str))
+        {
+            size_t avoided = reloadAvoided();
+            if (debugEnabled)
+            {
+                std::cout << "Ignoring unreferenced sensor " << path.str
+                          << ", " << avoided << " reloads avoided\n";
+            }
+            return 1;
+        }
+    }
 
-    // do a brief sleep as we tend to get a bunch of these events at
-    // once
-    timer->expires_after(std::chrono::seconds(2));
-    timer->async_wait([](const boost::system::error_code ec) {
+    // we tend to get a bunch of these events at once, so wait for the burst
+    // to settle
+    if (state->debounce.pending())
+    {
+        reloadAvoided();
+    }
+    state->timer->expires_after(
+        state->debounce.onEvent(std::chrono::steady_clock::now()));
+    state->timer->async_wait([state](const boost::system::error_code ec) {
         if (ec == boost::asio::error::operation_aborted)
         {
             /* another timer started*/
             return;
         }
 
-        std::cout << "New configuration detected, reloading\n.";
+        state->debounce.reset();
+        std::cout << "New configuration detected, reloading ("
+                  << state->avoided << " reloads avoided)\n";
         tryRestartControlLoops();
     });
 
@@ -261,6 +287,7 @@ void createMatches(sdbusplus::bus_t& bus, boost::asio::steady_timer& timer)
     {
         return;
     }
+    reloadState.timer = &timer;
 
     // we restart when the configuration changes or there are new sensors
     for (const auto& interface : interfaces)
@@ -269,17 +296,17 @@ void createMatches(sdbusplus::bus_t& bus, boost::asio::steady_timer& timer)
             bus,
             "type='signal',member='PropertiesChanged',arg0namespace='" +
                 interface + "'",
-            eventHandler, &timer);
+            eventHandler, &reloadState);
     }
     matches.emplace_back(
         bus,
         "type='signal',member='InterfacesAdded',arg0path='/xyz/openbmc_project/"
         "sensors/'",
-        eventHandler, &timer);
+        eventHandler, &reloadState);
     matches.emplace_back(bus,
                          "type='signal',member='InterfacesRemoved',arg0path='/"
                          "xyz/openbmc_project/sensors/'",
-                         eventHandler, &timer);
+                         eventHandler, &reloadState);
 }
 
 /**
@@ -302,6 +329,56 @@ inline DbusVariantType getPIDAttribute(
     return search->second;
 }
 
+/**
+ * retrieve the optional input staleness timeout from the pid configuration map
+ * @param[in] base - the PID configuration map
+ * @return the timeout in milliseconds, 0 when InputTimeoutMS isn't set
+ */
+inline int64_t getInputTimeoutMs(
+    const std::unordered_map<std::string, DbusVariantType>& base)
+{
+    // D-Bus passive sensor updates are pushed in, not pulled by timer poll,
+    // so by default their inputs aren't checked for a timeout.
+    auto findInputTimeout = base.find("InputTimeoutMS");
+    if (findInputTimeout == base.end())
+    {
+        return 0;
+    }
+
+    double timeoutMs =
+        std::visit(VariantToDoubleVisitor(), findInputTimeout->second);
+    if (timeoutMs < 0.0)
+    {
+        throw std::runtime_error("InputTimeoutMS must not be negative");
+    }
+
+    return static_cast<int64_t>(timeoutMs);
+}
+
+/**
+ * retrieve the optional input filter chain from the pid configuration map
+ * @param[in] base - the PID configuration map
+ * @return the filters parsed from InputFilters, empty when it isn't set
+ * @throw SensorBuildException : a filter in InputFilters can't be parsed
+ */
+inline std::vector<conf::SensorFilterConfig> getInputFilters(
+    const std::unordered_map<std::string, DbusVariantType>& base)
+{
+    std::vector<conf::SensorFilterConfig> filters;
+
+    auto findInputFilters = base.find("InputFilters");
+    if (findInputFilters != base.end())
+    {
+        for (const auto& spec :
+             std::get<std::vector<std::string>>(findInputFilters->second))
+        {
+            filters.push_back(parseSensorFilter(spec));
+        }
+    }
+
+    return filters;
+}
+
 inline void getCycleTimeSetting(
     const std::unordered_map<std::string, DbusVariantType>& zone,
     const int zoneIndex, const std::string& attributeName, uint64_t& value)
@@ -451,120 +528,29 @@ void populatePidInfo(
     info.pidInfo.derivativeCoeff = derivativeCoeff;
 }
 
-bool init(sdbusplus::bus_t& bus, boost::asio::steady_timer& timer,
-          std::map<std::string, conf::SensorConfig>& sensorConfig,
-          std::map<int64_t, conf::PIDConf>& zoneConfig,
-          std::map<int64_t, conf::ZoneConfig>& zoneDetailsConfig)
+/**
+ * Build the sensor, PID and zone configuration from the discovered D-Bus
+ * objects.
+ *
+ * @param bus - used to read sensor thresholds for SetPointOffset.
+ * @param configurations - the PID, Stepwise and Zone configuration objects.
+ * @param sensors - map of sensor path to its Sensor.Value or FanPwm interface.
+ * @param selectedProfiles - the thermal mode profiles currently selected.
+ * @return false if the configuration has no zones yet.
+ */
+bool buildConfiguration(
+    sdbusplus::bus_t& bus, ManagedObjectType& configurations,
+    const std::unordered_map<std::string, std::string>& sensors,
+    const std::vector<std::string>& selectedProfiles,
+    std::map<std::string, conf::SensorConfig>& sensorConfig,
+    std::map<int64_t, conf::PIDConf>& zoneConfig,
+    std::map<int64_t, conf::ZoneConfig>& zoneDetailsConfig)
 {
     sensorConfig.clear();
     zoneConfig.clear();
     zoneDetailsConfig.clear();
 
-    createMatches(bus, timer);
-
-    auto mapper = bus.new_method_call(
-        ObjectMapper::default_service, ObjectMapper::instance_path,
-        ObjectMapper::interface, ObjectMapper::method_names::get_sub_tree);
-    mapper.append(
-        "/", 0,
-        std::array<const char*, 6>{
-            objectManagerInterface, pidConfigurationInterface,
-            pidZoneConfigurationInterface, stepwiseConfigurationInterface,
-            SensorValue::interface, ControlFanPwm::interface});
-    std::unordered_map<
-        std::string, std::unordered_map<std::string, std::vector<std::string>>>
-        respData;
-    try
-    {
-        auto resp = bus.call(mapper);
-        resp.read(respData);
-    }
-    catch (const sdbusplus::exception_t&)
-    {
-        // can't do anything without mapper call data
-        throw std::runtime_error("ObjectMapper Call Failure");
-    }
-
-    if (respData.empty())
-    {
-        // can't do anything without mapper call data
-        throw std::runtime_error("No configuration data available from Mapper");
-    }
-    // create a map of pair of <has pid configuration, ObjectManager path>
-    std::unordered_map<std::string, std::pair<bool, std::string>> owners;
-    // and a map of <path, interface> for sensors
-    std::unordered_map<std::string, std::string> sensors;
-    for (const auto& objectPair : respData)
-    {
-        for (const auto& ownerPair : objectPair.second)
-        {
-            auto& owner = owners[ownerPair.first];
-            for (const std::string& interface : ownerPair.second)
-            {
-                if (interface == objectManagerInterface)
-                {
-                    owner.second = objectPair.first;
-                }
-                if (interface == pidConfigurationInterface ||
-                    interface == pidZoneConfigurationInterface ||
-                    interface == stepwiseConfigurationInterface)
-                {
-                    owner.first = true;
-                }
-                if (interface == SensorValue::interface ||
-                    interface == ControlFanPwm::interface)
-                {
-                    // we're not interested in pwm sensors, just pwm control
-                    if (interface == SensorValue::interface &&
-                        objectPair.first.find("pwm") != std::string::npos)
-                    {
-                        continue;
-                    }
-                    sensors[objectPair.first] = interface;
-                }
-            }
-        }
-    }
-    ManagedObjectType configurations;
-    for (const auto& owner : owners)
-    {
-        // skip if no pid configuration (means probably a sensor)
-        if (!owner.second.first)
-        {
-            continue;
-        }
-        auto endpoint = bus.new_method_call(
-            owner.first.c_str(), owner.second.second.c_str(),
-            "org.freedesktop.DBus.ObjectManager", "GetManagedObjects");
-        ManagedObjectType configuration;
-        try
-        {
-            auto response = bus.call(endpoint);
-            response.read(configuration);
-        }
-        catch (const sdbusplus::exception_t&)
-        {
-            // this shouldn't happen, probably means daemon crashed
-            throw std::runtime_error(
-                "Error getting managed objects from " + owner.first);
-        }
-
-        for (auto& pathPair : configuration)
-        {
-            if (pathPair.second.find(pidConfigurationInterface) !=
-                    pathPair.second.end() ||
-                pathPair.second.find(pidZoneConfigurationInterface) !=
-                    pathPair.second.end() ||
-                pathPair.second.find(stepwiseConfigurationInterface) !=
-                    pathPair.second.end())
-            {
-                configurations.emplace(pathPair);
-            }
-        }
-    }
-
     // remove controllers from config that aren't in the current profile(s)
-    std::vector<std::string> selectedProfiles = getSelectedProfiles(bus);
     if (selectedProfiles.size())
     {
         for (auto pathIt = configurations.begin();
@@ -749,6 +735,10 @@ bool init(sdbusplus::bus_t& bus, boost::asio::steady_timer& timer,
                         std::get<bool>(findIgnoreFailIfHostOff->second);
                 }
 
+                int64_t inputTimeoutMs = getInputTimeoutMs(base);
+                std::vector<conf::SensorFilterConfig> inputFilters =
+                    getInputFilters(base);
+
                 std::vector<SensorInterfaceType> inputSensorInterfaces;
                 std::vector<SensorInterfaceType> outputSensorInterfaces;
                 std::vector<SensorInterfaceType>
@@ -801,7 +791,8 @@ bool init(sdbusplus::bus_t& bus, boost::asio::steady_timer& timer,
                                 config.type = pidClass;
                                 config.readPath =
                                     getSensorPath(config.type, inputSensorName);
-                                config.timeout = 0;
+                                config.timeoutMs = inputTimeoutMs;
+                                config.filters = inputFilters;
                                 config.ignoreDbusMinMax = true;
                                 config.unavailableAsFailed =
                                     unavailableAsFailed;
@@ -841,8 +832,8 @@ bool init(sdbusplus::bus_t& bus, boost::asio::steady_timer& timer,
                     const std::string& inputSensorPath =
                         inputSensorInterface.first;
 
-                    // Setting timeout to 0 is intentional, as D-Bus passive
-                    // sensor updates are pushed in, not pulled by timer poll.
+                    // The timeout defaults to 0, as D-Bus passive sensor
+                    // updates are pushed in, not pulled by timer poll.
                     // Setting ignoreDbusMinMax is intentional, as this
                     // prevents normalization of values to [0.0, 1.0] range,
                     // which would mess up the PID loop math.
@@ -858,7 +849,8 @@ bool init(sdbusplus::bus_t& bus, boost::asio::steady_timer& timer,
                         archivedInputSensorNames.push_back(inputSensorName);
                         config.type = pidClass;
                         config.readPath = inputSensorInterface.first;
-                        config.timeout = 0;
+                        config.timeoutMs = inputTimeoutMs;
+                        config.filters = inputFilters;
                         config.ignoreDbusMinMax = true;
                         config.unavailableAsFailed = unavailableAsFailed;
                         config.ignoreFailIfHostOff = ignoreFailIfHostOff;
@@ -977,6 +969,8 @@ bool init(sdbusplus::bus_t& bus, boost::asio::steady_timer& timer,
                         // different ranges
                         fanConfig.max = 255;
                         fanConfig.min = 0;
+                        fanConfig.timeoutMs = inputTimeoutMs;
+                        fanConfig.filters = inputFilters;
                     }
                 }
                 // if the sensors aren't available in the current state, don't
@@ -1085,6 +1079,10 @@ bool init(sdbusplus::bus_t& bus, boost::asio::steady_timer& timer,
                         std::get<bool>(findIgnoreFailIfHostOff->second);
                 }
 
+                int64_t inputTimeoutMs = getInputTimeoutMs(base);
+                std::vector<conf::SensorFilterConfig> inputFilters =
+                    getInputFilters(base);
+
                 bool sensorFound = false;
                 for (const std::string& sensorName : sensorNames)
                 {
@@ -1120,10 +1118,8 @@ bool init(sdbusplus::bus_t& bus, boost::asio::steady_timer& timer,
                             config.ignoreDbusMinMax = true;
                             config.unavailableAsFailed = unavailableAsFailed;
                             config.ignoreFailIfHostOff = ignoreFailIfHostOff;
-                            // todo: maybe un-hardcode this if we run into
-                            // slower timeouts with sensors
-
-                            config.timeout = 0;
+                            config.timeoutMs = inputTimeoutMs;
+                            config.filters = inputFilters;
                             sensorFound = true;
                         }
                         else
@@ -1152,10 +1148,8 @@ bool init(sdbusplus::bus_t& bus, boost::asio::steady_timer& timer,
                             config.ignoreDbusMinMax = true;
                             config.unavailableAsFailed = unavailableAsFailed;
                             config.ignoreFailIfHostOff = ignoreFailIfHostOff;
-                            // todo: maybe un-hardcode this if we run into
-                            // slower timeouts with sensors
-
-                            config.timeout = 0;
+                            config.timeoutMs = inputTimeoutMs;
+                            config.filters = inputFilters;
                             sensorFound = true;
                         }
                     }
@@ -1229,37 +1223,26 @@ bool init(sdbusplus::bus_t& bus, boost::asio::steady_timer& timer,
                     info.stepwiseInfo.negativeHysteresis = std::visit(
                         VariantToDoubleVisitor(), findNegHyst->second);
                 }
-                std::vector<double> readings =
+                info.stepwiseInfo.reading =
                     std::get<std::vector<double>>(base.at("Reading"));
-                if (readings.size() > ec::maxStepwisePoints)
-                {
-                    throw std::invalid_argument("Too many stepwise points.");
-                }
-                if (readings.empty())
+                if (info.stepwiseInfo.reading.empty())
                 {
                     throw std::invalid_argument(
                         "Must have one stepwise point.");
                 }
-                std::copy(readings.begin(), readings.end(),
-                          info.stepwiseInfo.reading);
-                if (readings.size() < ec::maxStepwisePoints)
-                {
-                    info.stepwiseInfo.reading[readings.size()] =
-                        std::numeric_limits<double>::quiet_NaN();
-                }
-                std::vector<double> outputs =
+                info.stepwiseInfo.output =
                     std::get<std::vector<double>>(base.at("Output"));
-                if (readings.size() != outputs.size())
+                if (info.stepwiseInfo.reading.size() !=
+                    info.stepwiseInfo.output.size())
                 {
                     throw std::invalid_argument(
                         "Outputs size must match readings");
                 }
-                std::copy(outputs.begin(), outputs.end(),
-                          info.stepwiseInfo.output);
-                if (outputs.size() < ec::maxStepwisePoints)
+                auto findInterpolate = base.find("Interpolate");
+                if (findInterpolate != base.end())
                 {
-                    info.stepwiseInfo.output[outputs.size()] =
-                        std::numeric_limits<double>::quiet_NaN();
+                    info.stepwiseInfo.interpolate =
+                        std::get<bool>(findInterpolate->second);
                 }
             }
         }
@@ -1277,5 +1260,302 @@ bool init(sdbusplus::bus_t& bus, boost::asio::steady_timer& timer,
     return true;
 }
 
+using SubTreeType = std::unordered_map<
+    std::string, std::unordered_map<std::string, std::vector<std::string>>>;
+
+/*
+ * One pass of configuration discovery.  The mapper queries, the profile
+ * lookups and the GetManagedObjects call to every owner are all in flight at
+ * the same time; each pending call holds a reference to this object and the
+ * configuration is built when the last reply arrives, unless a later pass
+ * has started by then.
+ */
+class Discovery : public std::enable_shared_from_this<Discovery>
+{
+  public:
+    Discovery(sdbusplus::asio::connection& bus,
+              std::map<std::string, conf::SensorConfig>& sensorConfig,
+              std::map<int64_t, conf::PIDConf>& zoneConfig,
+              std::map<int64_t, conf::ZoneConfig>& zoneDetailsConfig,
+              InitCallback&& done) :
+        _bus(bus), _sensorConfig(sensorConfig), _zoneConfig(zoneConfig),
+        _zoneDetailsConfig(zoneDetailsConfig), _done(std::move(done)),
+        _pass(discoveryPasses.start())
+    {}
+
+    void start(void)
+    {
+        _started = std::chrono::steady_clock::now();
+        _pending = 2;
+
+        auto self = shared_from_this();
+        _bus.async_method_call(
+            [self](const boost::system::error_code& ec,
+                   const SubTreeType& respData) {
+                self->onConfigurationOwners(ec, respData);
+            },
+            ObjectMapper::default_service, ObjectMapper::instance_path,
+            ObjectMapper::interface, ObjectMapper::method_names::get_sub_tree,
+            "/", 0,
+            std::array<const char*, 6>{
+                objectManagerInterface, pidConfigurationInterface,
+                pidZoneConfigurationInterface, stepwiseConfigurationInterface,
+                SensorValue::interface, ControlFanPwm::interface});
+        _bus.async_method_call(
+            [self](const boost::system::error_code& ec,
+                   const SubTreeType& respData) {
+                self->onProfileOwners(ec, respData);
+            },
+            ObjectMapper::default_service, ObjectMapper::instance_path,
+            ObjectMapper::interface, ObjectMapper::method_names::get_sub_tree,
+            "/", 0, std::array<const char*, 1>{ControlThermalMode::interface});
+    }
+
+  private:
+    void fail(const std::string& what)
+    {
+        if (!_error)
+        {
+            _error = std::make_exception_ptr(std::runtime_error(what));
+        }
+    }
+
+    void onConfigurationOwners(const boost::system::error_code& ec,
+                               const SubTreeType& respData)
+    {
+        _mapperDone = std::chrono::steady_clock::now();
+
+        if (ec)
+        {
+            // can't do anything without mapper call data
+            fail("ObjectMapper Call Failure");
+        }
+        else if (respData.empty())
+        {
+            // can't do anything without mapper call data
+            fail("No configuration data available from Mapper");
+        }
+        if (_error)
+        {
+            finish();
+            return;
+        }
+
+        // create a map of pair of <has pid configuration, ObjectManager path>
+        std::unordered_map<std::string, std::pair<bool, std::string>> owners;
+        for (const auto& objectPair : respData)
+        {
+            for (const auto& ownerPair : objectPair.second)
+            {
+                auto& owner = owners[ownerPair.first];
+                for (const std::string& interface : ownerPair.second)
+                {
+                    if (interface == objectManagerInterface)
+                    {
+                        owner.second = objectPair.first;
+                    }
+                    if (interface == pidConfigurationInterface ||
+                        interface == pidZoneConfigurationInterface ||
+                        interface == stepwiseConfigurationInterface)
+                    {
+                        owner.first = true;
+                    }
+                    if (interface == SensorValue::interface ||
+                        interface == ControlFanPwm::interface)
+                    {
+                        // we're not interested in pwm sensors, just pwm
+                        // control
+                        if (interface == SensorValue::interface &&
+                            objectPair.first.find("pwm") != std::string::npos)
+                        {
+                            continue;
+                        }
+                        _sensors[objectPair.first] = interface;
+                    }
+                }
+            }
+        }
+
+        auto self = shared_from_this();
+        for (const auto& owner : owners)
+        {
+            // skip if no pid configuration (means probably a sensor)
+            if (!owner.second.first)
+            {
+                continue;
+            }
+            ++_owners;
+            ++_pending;
+            _bus.async_method_call(
+                [self, name = owner.first](
+                    const boost::system::error_code& callError,
+                    const ManagedObjectType& objects) {
+                    self->onManagedObjects(name, callError, objects);
+                },
+                owner.first, owner.second.second,
+                "org.freedesktop.DBus.ObjectManager", "GetManagedObjects");
+        }
+
+        finish();
+    }
+
+    void onManagedObjects(const std::string& owner,
+                          const boost::system::error_code& ec,
+                          const ManagedObjectType& configuration)
+    {
+        if (ec)
+        {
+            // this shouldn't happen, probably means daemon crashed
+            fail("Error getting managed objects from " + owner);
+            finish();
+            return;
+        }
+
+        for (const auto& pathPair : configuration)
+        {
+            if (pathPair.second.find(pidConfigurationInterface) !=
+                    pathPair.second.end() ||
+                pathPair.second.find(pidZoneConfigurationInterface) !=
+                    pathPair.second.end() ||
+                pathPair.second.find(stepwiseConfigurationInterface) !=
+                    pathPair.second.end())
+            {
+                _configurations.emplace(pathPair);
+            }
+        }
+
+        finish();
+    }
+
+    void onProfileOwners(const boost::system::error_code& ec,
+                         const SubTreeType& respData)
+    {
+        if (ec)
+        {
+            // can't do anything without mapper call data
+            fail("ObjectMapper Call Failure");
+            finish();
+            return;
+        }
+
+        // if the user has profiles but doesn't expose the interface to select
+        // one, just go ahead without using profiles
+        auto self = shared_from_this();
+        for (const auto& objectPair : respData)
+        {
+            for (const auto& ownerPair : objectPair.second)
+            {
+                ++_pending;
+                _bus.async_method_call(
+                    [self](const boost::system::error_code& callError,
+                           const std::variant<std::string>& mode) {
+                        self->onProfile(callError, mode);
+                    },
+                    ownerPair.first, objectPair.first,
+                    "org.freedesktop.DBus.Properties", "Get",
+                    ControlThermalMode::interface,
+                    ControlThermalMode::property_names::current);
+            }
+        }
+
+        finish();
+    }
+
+    void onProfile(const boost::system::error_code& ec,
+                   const std::variant<std::string>& mode)
+    {
+        if (ec)
+        {
+            fail("Failure getting profile");
+        }
+        else
+        {
+            _selectedProfiles.emplace_back(std::get<std::string>(mode));
+        }
+
+        finish();
+    }
+
+    void finish(void)
+    {
+        if (--_pending > 0)
+        {
+            return;
+        }
+
+        discoveryPasses.finish(
+            _pass, _error, [this] { return build(); }, _done);
+    }
+
+    bool build(void)
+    {
+        if (debugEnabled)
+        {
+            std::cout << "Profiles selected: ";
+            for (const auto& profile : _selectedProfiles)
+            {
+                std::cout << profile << " ";
+            }
+            std::cout << "\n";
+        }
+
+        auto queried = std::chrono::steady_clock::now();
+        bool ready = buildConfiguration(_bus, _configurations, _sensors,
+                                        _selectedProfiles, _sensorConfig,
+                                        _zoneConfig, _zoneDetailsConfig);
+        auto built = std::chrono::steady_clock::now();
+
+        // Until there are zones, any sensor could be the one they wait on.
+        reloadState.referenced =
+            ready ? SensorPatterns(getReferencedSensors(_configurations))
+                  : SensorPatterns();
+
+        using std::chrono::duration_cast;
+        using std::chrono::milliseconds;
+        std::cout << "Configuration discovered in "
+                  << duration_cast<milliseconds>(built - _started).count()
+                  << "ms: mapper "
+                  << duration_cast<milliseconds>(_mapperDone - _started).count()
+                  << "ms, " << _owners << " owners "
+                  << duration_cast<milliseconds>(queried - _mapperDone).count()
+                  << "ms, build "
+                  << duration_cast<milliseconds>(built - queried).count()
+                  << "ms\n";
+
+        return ready;
+    }
+
+    sdbusplus::asio::connection& _bus;
+    std::map<std::string, conf::SensorConfig>& _sensorConfig;
+    std::map<int64_t, conf::PIDConf>& _zoneConfig;
+    std::map<int64_t, conf::ZoneConfig>& _zoneDetailsConfig;
+    InitCallback _done;
+    uint64_t _pass;
+
+    size_t _pending = 0;
+    size_t _owners = 0;
+    std::exception_ptr _error;
+    std::chrono::steady_clock::time_point _started;
+    std::chrono::steady_clock::time_point _mapperDone;
+
+    // map of <path, interface> for sensors
+    std::unordered_map<std::string, std::string> _sensors;
+    ManagedObjectType _configurations;
+    std::vector<std::string> _selectedProfiles;
+};
+
+void init(sdbusplus::asio::connection& bus, boost::asio::steady_timer& timer,
+          std::map<std::string, conf::SensorConfig>& sensorConfig,
+          std::map<int64_t, conf::PIDConf>& zoneConfig,
+          std::map<int64_t, conf::ZoneConfig>& zoneDetailsConfig,
+          InitCallback&& done)
+{
+    createMatches(bus, timer);
+
+    std::make_shared<Discovery>(bus, sensorConfig, zoneConfig,
+                                zoneDetailsConfig, std::move(done))
+        ->start();
+}
+
 } // namespace dbus_configuration
 } // namespace pid_control
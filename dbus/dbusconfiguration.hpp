@@ -18,10 +18,13 @@
 #include "conf.hpp"
 
 #include <boost/asio/steady_timer.hpp>
-#include <sdbusplus/bus.hpp>
+#include <sdbusplus/asio/connection.hpp>
 #include <sdbusplus/message/native_types.hpp>
 
+#include <cstddef>
 #include <cstdint>
+#include <exception>
+#include <functional>
 #include <map>
 #include <string>
 #include <unordered_map>
@@ -43,18 +46,38 @@ namespace dbus_configuration
 {
 
 /**
- * Initialize a dbus-based configuration.
+ * Called when the dbus-based configuration has been discovered.  error is set
+ * if discovery failed, otherwise ready is false if there are no zones yet.
+ * Not called for a discovery superseded by a later init().
+ */
+using InitCallback = std::function<void(std::exception_ptr error, bool ready)>;
+
+/**
+ * Initialize a dbus-based configuration.  The D-Bus queries are issued
+ * concurrently and the configuration maps are only written once all replies
+ * have arrived, right before done is called, and only if init() hasn't been
+ * called again since.
  *
  * @param bus - the sdbusplus connection to use
  * @param timer - the timer to use
  * @param sensorConfig - The configuration converted sensor list.
  * @param zoneConfig - The configuration converted PID list.
  * @param zoneDetailsConfig - The configuration converted Zone configuration.
+ * @param done - called from the io_context once discovery completes.
  */
-bool init(sdbusplus::bus_t& bus, boost::asio::steady_timer& timer,
+void init(sdbusplus::asio::connection& bus, boost::asio::steady_timer& timer,
           std::map<std::string, conf::SensorConfig>& sensorConfig,
           std::map<int64_t, conf::PIDConf>& zoneConfig,
-          std::map<int64_t, conf::ZoneConfig>& zoneDetailsConfig);
+          std::map<int64_t, conf::ZoneConfig>& zoneDetailsConfig,
+          InitCallback&& done);
+
+/**
+ * Record a configuration reload that was avoided, because the change didn't
+ * touch anything in use or was folded into another reload.
+ *
+ * @return how many reloads have been avoided so far.
+ */
+size_t reloadAvoided(void);
 
 } // namespace dbus_configuration
 } // namespace pid_control
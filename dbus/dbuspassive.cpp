@@ -5,6 +5,7 @@
 
 #include "dbuspassive.hpp"
 
+#include "clock.hpp"
 #include "conf.hpp"
 #include "dbushelper_interface.hpp"
 #include "dbuspassiveredundancy.hpp"
@@ -51,7 +52,7 @@ using StateDecoratorOperationalStatus = sdbusplus::common::xyz::
 namespace pid_control
 {
 
-std::unique_ptr<ReadInterface> DbusPassive::createDbusPassive(
+std::unique_ptr<DbusPassive> DbusPassive::createDbusPassive(
     sdbusplus::bus_t& bus, const std::string& type, const std::string& id,
     std::unique_ptr<DbusHelperInterface> helper, const conf::SensorConfig* info,
     const std::shared_ptr<DbusPassiveRedundancy>& redundancy)
@@ -182,7 +183,7 @@ void DbusPassive::setValue(double value, double unscaled)
 
     _value = value;
     _unscaled = unscaled;
-    _updated = std::chrono::high_resolution_clock::now();
+    _updated = clockNow();
 }
 
 void DbusPassive::setValue(double value)
@@ -366,6 +367,12 @@ double DbusPassive::getMin(void)
     return _min;
 }
 
+double DbusPassive::scale(double unscaled) const
+{
+    scaleSensorReading(_min, _max, unscaled);
+    return unscaled;
+}
+
 void DbusPassive::updateValue(double value, bool force)
 {
     _badReading = false;
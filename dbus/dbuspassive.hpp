@@ -37,7 +37,7 @@ int dbusHandleSignal(sd_bus_message* msg, void* data, sd_bus_error* err);
 class DbusPassive : public ReadInterface
 {
   public:
-    static std::unique_ptr<ReadInterface> createDbusPassive(
+    static std::unique_ptr<DbusPassive> createDbusPassive(
         sdbusplus::bus_t& bus, const std::string& type, const std::string& id,
         std::unique_ptr<DbusHelperInterface> helper,
         const conf::SensorConfig* info,
@@ -52,6 +52,7 @@ class DbusPassive : public ReadInterface
     ReadReturn read(void) override;
     bool getFailed(void) const override;
     std::string getFailReason(void) const override;
+    double scale(double unscaled) const override;
 
     void updateValue(double value, bool force);
     void setValue(double value, double unscaled);
@@ -94,7 +95,7 @@ class DbusPassive : public ReadInterface
     std::string path;
     std::shared_ptr<DbusPassiveRedundancy> redundancy;
     /* The last time the value was refreshed, not necessarily changed. */
-    std::chrono::high_resolution_clock::time_point _updated;
+    std::chrono::steady_clock::time_point _updated;
 };
 
 int handleSensorValue(sdbusplus::message_t& msg, DbusPassive* owner);
@@ -1,8 +1,14 @@
 
+#include "dbusutil.hpp"
+
 #include <sdbusplus/bus/match.hpp>
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <exception>
 #include <map>
 #include <regex>
 #include <set>
@@ -88,6 +94,101 @@ bool findSensors(const std::unordered_map<std::string, std::string>& sensors,
     return matches.size() > 0;
 }
 
+SensorPatterns::SensorPatterns(const std::vector<std::string>& patterns)
+{
+    for (const auto& pattern : patterns)
+    {
+        _patterns.emplace_back('/' + pattern + '$');
+    }
+}
+
+bool SensorPatterns::empty(void) const
+{
+    return _patterns.empty();
+}
+
+bool SensorPatterns::matches(const std::string& path) const
+{
+    return std::any_of(_patterns.begin(), _patterns.end(),
+                       [&path](const std::regex& reg) {
+                           return std::regex_search(path, reg);
+                       });
+}
+
+ReloadDebounce::Clock::duration ReloadDebounce::onEvent(
+    Clock::time_point now)
+{
+    if (!_burstStart)
+    {
+        _burstStart = now;
+    }
+    _events++;
+
+    Clock::duration delay = minDelay;
+    for (size_t i = 1; i < _events && delay < maxDelay; i++)
+    {
+        delay *= 2;
+    }
+    delay = std::min<Clock::duration>(delay, maxDelay);
+
+    Clock::time_point deadline = *_burstStart + maxWait;
+    if (now + delay > deadline)
+    {
+        delay = std::max<Clock::duration>(deadline - now,
+                                          Clock::duration::zero());
+    }
+    return delay;
+}
+
+bool ReloadDebounce::pending(void) const
+{
+    return _burstStart.has_value();
+}
+
+void ReloadDebounce::reset(void)
+{
+    _burstStart.reset();
+    _events = 0;
+}
+
+uint64_t DiscoveryPasses::start(void)
+{
+    return ++_latest;
+}
+
+bool DiscoveryPasses::current(uint64_t pass) const
+{
+    return pass == _latest;
+}
+
+void DiscoveryPasses::finish(uint64_t pass, std::exception_ptr error,
+                             const Build& build, const Done& done) const
+{
+    if (!current(pass))
+    {
+        return;
+    }
+
+    if (error)
+    {
+        done(error, false);
+        return;
+    }
+
+    bool ready = false;
+    try
+    {
+        ready = build();
+    }
+    catch (const std::exception&)
+    {
+        done(std::current_exception(), false);
+        return;
+    }
+
+    done(nullptr, ready);
+}
+
 std::string getSensorUnit(const std::string& type)
 {
     std::string unit;
@@ -1,7 +1,13 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <exception>
+#include <functional>
 #include <map>
+#include <optional>
+#include <regex>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
@@ -39,6 +45,79 @@ bool findSensors(const std::unordered_map<std::string, std::string>& sensors,
                  const std::string& search,
                  std::vector<std::pair<std::string, std::string>>& matches);
 
+/*
+ * The sensor names a configuration references, matched against sensor paths
+ * the same way findSensors() matches them.
+ */
+class SensorPatterns
+{
+  public:
+    SensorPatterns() = default;
+    explicit SensorPatterns(const std::vector<std::string>& patterns);
+
+    bool empty(void) const;
+    bool matches(const std::string& path) const;
+
+  private:
+    std::vector<std::regex> _patterns;
+};
+
+/*
+ * Decides how long to wait for more configuration changes before reloading.
+ * A lone change reloads quickly, while the wait doubles with each change in a
+ * burst, but never goes past maxWait after the burst's first change.
+ */
+class ReloadDebounce
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr auto minDelay = std::chrono::milliseconds(500);
+    static constexpr auto maxDelay = std::chrono::seconds(4);
+    static constexpr auto maxWait = std::chrono::seconds(10);
+
+    /* Record a change at now, returns how long to wait before reloading. */
+    Clock::duration onEvent(Clock::time_point now);
+    /* Whether a change is waiting on a reload. */
+    bool pending(void) const;
+    /* The reload went ahead, the next change starts a new burst. */
+    void reset(void);
+
+  private:
+    std::optional<Clock::time_point> _burstStart;
+    size_t _events = 0;
+};
+
+/*
+ * Numbers the passes of configuration discovery.  A reload starts a new pass
+ * without waiting on the last, and their replies can arrive in any order, so
+ * a pass only builds the configuration if no later one has started.
+ */
+class DiscoveryPasses
+{
+  public:
+    /* Builds the configuration, returns false if it has no zones yet. */
+    using Build = std::function<bool(void)>;
+    /* Told the error the pass failed with, or whether the build was ready. */
+    using Done = std::function<void(std::exception_ptr error, bool ready)>;
+
+    /* Start a pass, returns its number. */
+    uint64_t start(void);
+    /* Whether pass is the latest one started. */
+    bool current(uint64_t pass) const;
+
+    /*
+     * Finish pass, which failed with error if set: run build and pass done
+     * its result.  A pass superseded by a later one does neither, since
+     * build writes the configuration the later pass owns.
+     */
+    void finish(uint64_t pass, std::exception_ptr error, const Build& build,
+                const Done& done) const;
+
+  private:
+    uint64_t _latest = 0;
+};
+
 // Set zone number for a zone, 0-based
 int64_t setZoneIndex(const std::string& name,
                      std::map<std::string, int64_t>& zones, int64_t index);
@@ -37,7 +37,7 @@ namespace pid_control
 
 using namespace phosphor::logging;
 
-std::unique_ptr<WriteInterface> DbusWritePercent::createDbusWrite(
+std::unique_ptr<DbusWritePercent> DbusWritePercent::createDbusWrite(
     const std::string& path, int64_t min, int64_t max,
     std::unique_ptr<DbusHelperInterface> helper)
 {
@@ -106,7 +106,7 @@ void DbusWritePercent::write(double value, bool force, int64_t* written)
     return;
 }
 
-std::unique_ptr<WriteInterface> DbusWrite::createDbusWrite(
+std::unique_ptr<DbusWrite> DbusWrite::createDbusWrite(
     const std::string& path, int64_t min, int64_t max,
     std::unique_ptr<DbusHelperInterface> helper)
 {
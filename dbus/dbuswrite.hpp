@@ -29,7 +29,7 @@ namespace pid_control
 class DbusWritePercent : public WriteInterface
 {
   public:
-    static std::unique_ptr<WriteInterface> createDbusWrite(
+    static std::unique_ptr<DbusWritePercent> createDbusWrite(
         const std::string& path, int64_t min, int64_t max,
         std::unique_ptr<DbusHelperInterface> helper);
 
@@ -50,7 +50,7 @@ class DbusWritePercent : public WriteInterface
 class DbusWrite : public WriteInterface
 {
   public:
-    static std::unique_ptr<WriteInterface> createDbusWrite(
+    static std::unique_ptr<DbusWrite> createDbusWrite(
         const std::string& path, int64_t min, int64_t max,
         std::unique_ptr<DbusHelperInterface> helper);
 
@@ -5,6 +5,7 @@
 
 #include "failsafeloggers/failsafe_logger.hpp"
 #include "failsafeloggers/failsafe_logger_utility.hpp"
+#include "symbols.hpp"
 
 #include <algorithm>
 #include <cstddef>
@@ -25,8 +26,7 @@ void buildFailsafeLoggers(
     zoneIdToFailsafeLogger =
         std::unordered_map<int64_t,
                            std::shared_ptr<pid_control::FailsafeLogger>>();
-    sensorNameToZoneId =
-        std::unordered_map<std::string, std::vector<int64_t>>();
+    sensorIdToZoneId = std::unordered_map<SymbolId, std::vector<int64_t>>();
     for (const auto& zoneIdToZone : zones)
     {
         int64_t zoneId = zoneIdToZone.first;
@@ -38,11 +38,11 @@ void buildFailsafeLoggers(
             zoneIdToZone.second->getSensorNames();
         for (const std::string& sensorName : sensorNames)
         {
-            if (std::find(sensorNameToZoneId[sensorName].begin(),
-                          sensorNameToZoneId[sensorName].end(), zoneId) ==
-                sensorNameToZoneId[sensorName].end())
+            auto& zoneIds = sensorIdToZoneId[intern(sensorName)];
+            if (std::find(zoneIds.begin(), zoneIds.end(), zoneId) ==
+                zoneIds.end())
             {
-                sensorNameToZoneId[sensorName].push_back(zoneId);
+                zoneIds.push_back(zoneId);
             }
         }
         std::cerr << "Build failsafe logger for Zone " << zoneId
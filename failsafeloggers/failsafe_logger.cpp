@@ -1,5 +1,7 @@
 #include "failsafe_logger.hpp"
 
+#include "clock.hpp"
+
 #include <chrono>
 #include <cstdint>
 #include <iostream>
@@ -13,7 +15,7 @@ void FailsafeLogger::outputFailsafeLog(
     const std::string& location, const std::string& reason)
 {
     // Remove outdated log entries.
-    const auto now = std::chrono::high_resolution_clock::now();
+    const auto now = clockNow();
     uint64_t nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
                          now.time_since_epoch())
                          .count();
@@ -1,10 +1,10 @@
 #include "failsafe_logger_utility.hpp"
 
 #include "failsafeloggers/failsafe_logger.hpp"
+#include "symbols.hpp"
 
 #include <cstdint>
 #include <memory>
-#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -13,5 +13,6 @@ std::unordered_map<int64_t, std::shared_ptr<pid_control::FailsafeLogger>>
         std::unordered_map<int64_t,
                            std::shared_ptr<pid_control::FailsafeLogger>>();
 
-std::unordered_map<std::string, std::vector<int64_t>> sensorNameToZoneId =
-    std::unordered_map<std::string, std::vector<int64_t>>();
+std::unordered_map<pid_control::SymbolId, std::vector<int64_t>>
+    sensorIdToZoneId =
+        std::unordered_map<pid_control::SymbolId, std::vector<int64_t>>();
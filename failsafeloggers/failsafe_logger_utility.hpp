@@ -1,6 +1,7 @@
 #pragma once
 
 #include "failsafeloggers/failsafe_logger.hpp"
+#include "symbols.hpp"
 
 #include <cstdint>
 #include <memory>
@@ -13,9 +14,10 @@
 extern std::unordered_map<int64_t, std::shared_ptr<pid_control::FailsafeLogger>>
     zoneIdToFailsafeLogger;
 
-/** Map of the sensor name/ID to its corresponding zone IDs.
+/** Map of the sensor's SymbolId to its corresponding zone IDs.
  */
-extern std::unordered_map<std::string, std::vector<int64_t>> sensorNameToZoneId;
+extern std::unordered_map<pid_control::SymbolId, std::vector<int64_t>>
+    sensorIdToZoneId;
 
 namespace pid_control
 {
@@ -27,7 +29,19 @@ inline void outputFailsafeLogWithSensor(
     const std::string& sensorName, const bool newFailsafeState,
     const std::string& location, const std::string& reason)
 {
-    for (const int64_t zoneId : sensorNameToZoneId[sensorName])
+    auto id = symbols().find(sensorName);
+    if (!id)
+    {
+        return;
+    }
+
+    auto zoneIds = sensorIdToZoneId.find(*id);
+    if (zoneIds == sensorIdToZoneId.end())
+    {
+        return;
+    }
+
+    for (const int64_t zoneId : zoneIds->second)
     {
         if (zoneIdToFailsafeLogger.count(zoneId))
         {
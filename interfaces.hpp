@@ -11,7 +11,7 @@ namespace pid_control
 struct ReadReturn
 {
     double value = std::numeric_limits<double>::quiet_NaN();
-    std::chrono::high_resolution_clock::time_point updated;
+    std::chrono::steady_clock::time_point updated;
     double unscaled = value;
 
     bool operator==(const ReadReturn& rhs) const
@@ -52,6 +52,15 @@ class ReadInterface
     {
         return "Unimplemented";
     }
+
+    /*
+     * The value read() returns for an unscaled reading.  A sensor's filters
+     * run on the unscaled readings, and this gives the filtered value.
+     */
+    virtual double scale(double unscaled) const
+    {
+        return unscaled;
+    }
 };
 
 /*
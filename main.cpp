@@ -5,16 +5,21 @@
 
 #include "buildjson/buildjson.hpp"
 #include "conf.hpp"
+#include "configcache.hpp"
 #include "dbus/dbusconfiguration.hpp"
 #include "failsafeloggers/builder.hpp"
 #include "hoststatemonitor.hpp"
 #include "pid/builder.hpp"
 #include "pid/buildjson.hpp"
 #include "pid/pidloop.hpp"
+#include "pid/snapshot.hpp"
 #include "pid/tuning.hpp"
+#include "sensors/build_utils.hpp"
 #include "sensors/builder.hpp"
 #include "sensors/buildjson.hpp"
+#include "sensors/hostbatch.hpp"
 #include "sensors/manager.hpp"
+#include "sensors/missing.hpp"
 #include "util.hpp"
 #include "zone_interface.hpp"
 
@@ -28,6 +33,7 @@
 #include <boost/asio/steady_timer.hpp>
 #include <sdbusplus/asio/connection.hpp>
 #include <sdbusplus/bus.hpp>
+#include <sdbusplus/bus/match.hpp>
 #include <sdbusplus/server/manager.hpp>
 
 #include <chrono>
@@ -41,6 +47,7 @@
 #include <map>
 #include <memory>
 #include <optional>
+#include <set>
 #include <stdexcept>
 #include <string>
 #include <tuple>
@@ -58,21 +65,50 @@ std::map<int64_t, conf::PIDConf> zoneConfig = {};
 /* The configuration converted Zone configuration. */
 std::map<int64_t, conf::ZoneConfig> zoneDetailsConfig = {};
 
+/* The first and longest waits between attempts to build a sensor or zone. */
+static constexpr auto retryMinDelay = std::chrono::seconds(1);
+static constexpr auto retryMaxDelay = std::chrono::seconds(60);
+/* Gives the mapper a moment to catch up after a missing sensor appears. */
+static constexpr auto sensorAppearedDelay = std::chrono::milliseconds(500);
+
+/*
+ * A sensor or zone that failed to build, waiting to be tried again.
+ */
+struct Retry
+{
+    std::shared_ptr<boost::asio::steady_timer> timer;
+    Backoff backoff{retryMinDelay, retryMaxDelay};
+    /* Set for a D-Bus sensor, fires when its object is added. */
+    std::unique_ptr<sdbusplus::bus::match_t> appeared;
+};
+
 namespace state
 {
-/* Set to true while canceling is in progress */
-static bool isCanceling = false;
+/* Set to true while a zone's loop is being canceled, by zone */
+static std::map<int64_t, bool> isCanceling;
 /* The zones build from configuration */
 static std::unordered_map<int64_t, std::shared_ptr<ZoneInterface>> zones;
-/* The timers used by the PID loop */
-static std::vector<std::shared_ptr<boost::asio::steady_timer>> timers;
+/* The timers used by the PID loop, by zone */
+static std::unordered_map<int64_t, std::shared_ptr<boost::asio::steady_timer>>
+    timers;
 /* The sensors build from configuration */
 static std::optional<SensorManager> mgmr;
+/* The configuration the running sensors and zones were built from */
+static std::map<std::string, conf::SensorConfig> sensorConfig;
+static std::map<int64_t, conf::PIDConf> zoneConfig;
+static std::map<int64_t, conf::ZoneConfig> zoneDetailsConfig;
+/* Controller state waiting to be restored into zones as they're built */
+static Snapshot saved;
+/* Sensors standing in as missing, by name */
+static std::map<std::string, Retry> sensorRetries;
+/* Zones that failed to build, by zone */
+static std::map<int64_t, Retry> zoneRetries;
 } // namespace state
 
 } // namespace pid_control
 
 std::filesystem::path configPath = "";
+std::string configCachePath = pid_control::configCacheDefaultPath;
 
 /* async io context for operation */
 boost::asio::io_context io;
@@ -106,83 +142,572 @@ std::filesystem::path searchConfigurationPath()
     return name;
 }
 
+/*
+ * Cancel the loops of the given zones.  A canceled loop can still hold its
+ * zone until its pending handler has run.
+ */
+void cancelZoneLoops(const std::set<int64_t>& zoneIds)
+{
+    for (int64_t zoneId : zoneIds)
+    {
+        auto timer = state::timers.find(zoneId);
+        if (timer == state::timers.end())
+        {
+            continue;
+        }
+
+        state::isCanceling[zoneId] = true;
+        timer->second->cancel();
+        state::timers.erase(timer);
+    }
+}
+
+/*
+ * Keep the controller state of the given zones, so it can be restored once
+ * they're rebuilt.
+ */
+void keepControllerStates(const std::set<int64_t>& zoneIds)
+{
+    auto now = std::chrono::steady_clock::now();
+    for (int64_t zoneId : zoneIds)
+    {
+        auto zone = state::zones.find(zoneId);
+        if (zone != state::zones.end())
+        {
+            state::saved[zoneId] = {now, zone->second->getControllerStates()};
+        }
+    }
+}
+
+/*
+ * Write the controller state of the running zones to snapshotPath, so a
+ * restarted daemon can pick up where this one left off.
+ */
+void saveControllerStates()
+{
+    if (state::zones.empty())
+    {
+        // Don't replace the last snapshot while no zones are running.
+        return;
+    }
+
+    Snapshot snapshot;
+    auto now = std::chrono::steady_clock::now();
+    for (const auto& [zoneId, zone] : state::zones)
+    {
+        snapshot[zoneId] = {now, zone->getControllerStates()};
+    }
+
+    try
+    {
+        writeSnapshot(snapshotPath, snapshot);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Failed to save controller state: " << e.what() << "\n";
+    }
+}
+
+void scheduleControllerStateSaves()
+{
+    static boost::asio::steady_timer timer(io);
+
+    timer.expires_after(snapshotInterval);
+    timer.async_wait([](const boost::system::error_code& ec) {
+        if (ec)
+        {
+            return;
+        }
+
+        saveControllerStates();
+        scheduleControllerStateSaves();
+    });
+}
+
+/*
+ * Forget the running zones, sensors and configuration.
+ */
+void clearControlLoops()
+{
+    state::sensorRetries.clear();
+    state::zoneRetries.clear();
+    state::zones.clear();
+    state::mgmr.reset();
+    state::sensorConfig.clear();
+    state::zoneConfig.clear();
+    state::zoneDetailsConfig.clear();
+}
+
 void stopControlLoops()
 {
+    std::set<int64_t> zoneIds;
     for (const auto& timer : state::timers)
     {
-        timer->cancel();
+        zoneIds.insert(timer.first);
     }
-    state::isCanceling = true;
-    state::timers.clear();
+    cancelZoneLoops(zoneIds);
 
-    if (state::zones.size() > 0 && state::zones.begin()->second.use_count() > 1)
+    for (const auto& zone : state::zones)
     {
-        throw std::runtime_error("wait for count back to 1");
+        if (zone.second.use_count() > 1)
+        {
+            throw std::runtime_error("wait for count back to 1");
+        }
     }
 
-    state::zones.clear();
-    state::isCanceling = false;
+    clearControlLoops();
 }
 
-void restartControlLoops()
+void startControlLoops();
+void retrySensor(const std::string& name);
+
+/*
+ * Wait delay before the next attempt at a missing sensor, replacing any wait
+ * already pending.
+ */
+void scheduleSensorRetry(const std::string& name,
+                         std::chrono::steady_clock::duration delay)
 {
-    stopControlLoops();
+    auto& timer = state::sensorRetries.at(name).timer;
+    timer->expires_after(delay);
+    timer->async_wait([name](const boost::system::error_code& error) {
+        if (error)
+        {
+            return; // canceled or rescheduled
+        }
+        retrySensor(name);
+    });
+}
 
-    const std::filesystem::path path =
-        (!configPath.empty()) ? configPath : searchConfigurationPath();
+/*
+ * Stand in for a sensor that failed to build, so the zones using it run in
+ * failsafe instead of waiting, and keep trying it: with backoff, and as soon
+ * as it shows up on D-Bus.
+ */
+void addMissingSensor(const std::string& name, const conf::SensorConfig& info)
+{
+    state::mgmr->addSensor(info.type, name,
+                           state::mgmr->make<MissingSensor>(name));
 
-    if (std::filesystem::exists(path))
+    Retry& retry = state::sensorRetries[name];
+    retry.timer = std::make_shared<boost::asio::steady_timer>(io);
+    if (getReadInterfaceType(info.readPath) == IOInterfaceType::DBUSPASSIVE)
     {
-        /*
-         * When building the sensors, if any of the dbus passive ones aren't on
-         * the bus, it'll fail immediately.
-         */
+        namespace rules = sdbusplus::bus::match::rules;
+        retry.appeared = std::make_unique<sdbusplus::bus::match_t>(
+            static_cast<sdbusplus::bus_t&>(passiveBus),
+            rules::interfacesAdded() + rules::argNpath(0, info.readPath),
+            [name](sdbusplus::message_t&) {
+                std::cerr << "Sensor " << name << " appeared\n";
+                scheduleSensorRetry(name, sensorAppearedDelay);
+            });
+    }
+    scheduleSensorRetry(name, retry.backoff.next());
+}
+
+void retrySensor(const std::string& name)
+{
+    auto config = state::sensorConfig.find(name);
+    if (config == state::sensorConfig.end() || !state::mgmr)
+    {
+        state::sensorRetries.erase(name);
+        return;
+    }
+
+    try
+    {
+        buildSensor(name, config->second, *state::mgmr);
+    }
+    catch (const std::exception& e)
+    {
+        auto delay = state::sensorRetries.at(name).backoff.next();
+        std::cerr << "Sensor " << name << " still missing, retrying in "
+                  << std::chrono::duration_cast<std::chrono::seconds>(delay)
+                         .count()
+                  << "s: " << e.what() << "\n";
+        scheduleSensorRetry(name, delay);
+        return;
+    }
+
+    // The zones look the sensor up every cycle, so they switch over to it and
+    // leave failsafe on their own.
+    std::cerr << "Sensor " << name << " is available\n";
+    state::sensorRetries.erase(name);
+}
+
+/*
+ * Try a zone that failed to build again after backoff.  The zone is left
+ * out of the running configuration, so the next diff rebuilds it.
+ */
+void scheduleZoneRetry(int64_t zoneId)
+{
+    state::zoneConfig.erase(zoneId);
+    state::zoneDetailsConfig.erase(zoneId);
+
+    Retry& retry = state::zoneRetries[zoneId];
+    if (!retry.timer)
+    {
+        retry.timer = std::make_shared<boost::asio::steady_timer>(io);
+    }
+    auto delay = retry.backoff.next();
+    std::cerr << "Retrying zone " << zoneId << " in "
+              << std::chrono::duration_cast<std::chrono::seconds>(delay).count()
+              << "s\n";
+
+    retry.timer->expires_after(delay);
+    retry.timer->async_wait([](const boost::system::error_code& error) {
+        if (error)
+        {
+            return;
+        }
+        startControlLoops();
+    });
+}
+
+/*
+ * Rebuild the sensors and zones that differ from the loaded configuration.
+ * Their loops must already be canceled and have released the zones.
+ */
+void rebuildControlLoops()
+{
+    ConfigDiff diff = diffConfiguration(
+        state::sensorConfig, state::zoneConfig, state::zoneDetailsConfig,
+        sensorConfig, zoneConfig, zoneDetailsConfig);
+    if (diff.zones.empty() && diff.sensors.empty())
+    {
+        return;
+    }
+
+    for (int64_t zoneId : diff.zones)
+    {
+        if (state::timers.contains(zoneId))
+        {
+            // A newer configuration touches a zone that is still running.
+            startControlLoops();
+            return;
+        }
+
+        auto zone = state::zones.find(zoneId);
+        if (zone != state::zones.end() && zone->second.use_count() > 1)
+        {
+            throw std::runtime_error("wait for count back to 1");
+        }
+    }
+
+    std::cerr << "Rebuilding " << diff.zones.size() << " of "
+              << zoneConfig.size() << " zones and " << diff.sensors.size()
+              << " sensors\n";
+
+    keepControllerStates(diff.zones);
+    for (int64_t zoneId : diff.zones)
+    {
+        state::zones.erase(zoneId);
+    }
+
+    if (!state::mgmr)
+    {
+        state::mgmr.emplace(passiveBus, hostBus);
+    }
+
+    // A sensor that can't be built doesn't hold up the zones, they start in
+    // failsafe until it turns up.
+    for (const std::string& name : diff.sensors)
+    {
+        state::sensorRetries.erase(name);
+        state::mgmr->removeSensor(name);
+
+        auto config = sensorConfig.find(name);
+        if (config == sensorConfig.end())
+        {
+            continue;
+        }
         try
         {
-            auto jsonData = parseValidateJson(path);
-            sensorConfig = buildSensorsFromJson(jsonData);
-            std::tie(zoneConfig, zoneDetailsConfig) =
-                buildPIDsFromJson(jsonData);
+            buildSensor(name, config->second, *state::mgmr);
         }
         catch (const std::exception& e)
         {
-            std::cerr << "Failed during building: " << e.what() << "\n";
-            exit(EXIT_FAILURE); /* fatal error. */
+            std::cerr << "Sensor " << name
+                      << " is missing, its zones start in failsafe: "
+                      << e.what() << "\n";
+            addMissingSensor(name, config->second);
         }
     }
-    else
+
+    // Each zone is built on its own, so one that fails doesn't keep the
+    // others from starting.
+    std::unordered_map<int64_t, std::shared_ptr<ZoneInterface>> zones;
+    std::set<int64_t> failed;
+    for (int64_t zoneId : diff.zones)
     {
-        static boost::asio::steady_timer reloadTimer(io);
-        if (!dbus_configuration::init(modeControlBus, reloadTimer, sensorConfig,
-                                      zoneConfig, zoneDetailsConfig))
+        auto config = zoneConfig.find(zoneId);
+        if (config == zoneConfig.end())
         {
-            return; // configuration not ready
+            state::zoneRetries.erase(zoneId);
+            continue;
         }
+        try
+        {
+            zones.merge(buildZones(std::map<int64_t, conf::PIDConf>{*config},
+                                   zoneDetailsConfig, *state::mgmr,
+                                   modeControlBus));
+            state::zoneRetries.erase(zoneId);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Failed to build zone " << zoneId << ": " << e.what()
+                      << "\n";
+            failed.insert(zoneId);
+        }
+    }
+
+    state::sensorConfig = sensorConfig;
+    state::zoneConfig = zoneConfig;
+    state::zoneDetailsConfig = zoneDetailsConfig;
+    for (int64_t zoneId : failed)
+    {
+        scheduleZoneRetry(zoneId);
     }
 
-    state::mgmr = buildSensors(sensorConfig, passiveBus, hostBus);
-    state::zones =
-        buildZones(zoneConfig, zoneDetailsConfig, *state::mgmr, modeControlBus);
+    auto now = std::chrono::steady_clock::now();
+    for (const auto& i : zones)
+    {
+        state::zones[i.first] = i.second;
+
+        // Pick up where the previous controllers left off, instead of
+        // starting over from a zero integral.
+        auto saved = state::saved.find(i.first);
+        if (saved == state::saved.end())
+        {
+            continue;
+        }
+        if (isFresh(saved->second, now, snapshotMaxAge))
+        {
+            size_t restored =
+                i.second->setControllerStates(saved->second.controllers);
+            std::cerr << "Zone " << i.first << " restored " << restored
+                      << " controller states\n";
+        }
+        state::saved.erase(saved);
+    }
     // Set `logMaxCountPerSecond` to 20 will limit the number of logs output per
     // second in each zone. Using 20 here would limit the output rate to be no
     // larger than 100 per sec for most platforms as the number of zones are
     // usually <=3. This will effectively avoid resource exhaustion.
     buildFailsafeLoggers(state::zones, /* logMaxCountPerSecond = */ 20);
 
-    if (0 == state::zones.size())
+    if (state::zones.empty() && state::zoneRetries.empty())
     {
         std::cerr << "No zones defined, exiting.\n";
         std::exit(EXIT_FAILURE);
     }
 
-    for (const auto& i : state::zones)
+    for (const auto& i : zones)
     {
         std::shared_ptr<boost::asio::steady_timer> timer =
-            state::timers.emplace_back(
-                std::make_shared<boost::asio::steady_timer>(io));
+            std::make_shared<boost::asio::steady_timer>(io);
+        state::timers[i.first] = timer;
+        state::isCanceling[i.first] = false;
         std::cerr << "pushing zone " << i.first << "\n";
-        pidControlLoop(i.second, timer, &state::isCanceling);
+        pidControlLoop(i.second, timer, &state::isCanceling[i.first]);
+    }
+}
+
+/*
+ * Apply the loaded configuration.  Only the zones whose configuration
+ * changed, or that use a sensor whose configuration changed, are stopped and
+ * rebuilt; the others keep running with their PID state intact.
+ */
+void startControlLoops()
+{
+    ConfigDiff diff = diffConfiguration(
+        state::sensorConfig, state::zoneConfig, state::zoneDetailsConfig,
+        sensorConfig, zoneConfig, zoneDetailsConfig);
+    if (diff.zones.empty() && diff.sensors.empty())
+    {
+        std::cerr << "Configuration unchanged\n";
+        return;
     }
+
+    cancelZoneLoops(diff.zones);
+
+    // The canceled loops' handlers are already queued, so by the time this
+    // runs they've released their zones.
+    boost::asio::post(io, [] {
+        try
+        {
+            rebuildControlLoops();
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Failed during rebuild, try again: " << e.what()
+                      << "\n";
+            // Start over from nothing, so the retry rebuilds every zone.
+            std::set<int64_t> zoneIds;
+            for (const auto& zone : state::zones)
+            {
+                zoneIds.insert(zone.first);
+            }
+            cancelZoneLoops(zoneIds);
+            keepControllerStates(zoneIds);
+            clearControlLoops();
+            tryRestartControlLoops(false);
+        }
+    });
+}
+
+/* Build the configuration from the json configuration file at path. */
+void buildJsonConfiguration(const std::filesystem::path& path)
+{
+    auto jsonData = parseValidateJson(path);
+    sensorConfig = buildSensorsFromJson(jsonData);
+    std::tie(zoneConfig, zoneDetailsConfig) = buildPIDsFromJson(jsonData);
+}
+
+/*
+ * Write the loaded configuration to the configuration cache, if it isn't
+ * already there.  Failing to is not fatal, the next start just won't be able
+ * to use it.
+ */
+void updateConfigCache(uint64_t source)
+{
+    static std::optional<std::pair<uint64_t, uint64_t>> written;
+
+    auto current = std::make_pair(
+        source, hashConfig(sensorConfig, zoneConfig, zoneDetailsConfig));
+    if (written == current)
+    {
+        return;
+    }
+
+    try
+    {
+        writeConfigCache(configCachePath, source, sensorConfig, zoneConfig,
+                         zoneDetailsConfig);
+        written = current;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Failed to write configuration cache: " << e.what()
+                  << "\n";
+    }
+}
+
+/*
+ * Compile the json configuration into the configuration cache, for the
+ * --compile-config mode.
+ */
+int compileConfiguration()
+{
+    const std::filesystem::path path =
+        (!configPath.empty()) ? configPath : searchConfigurationPath();
+
+    try
+    {
+        buildJsonConfiguration(path);
+        writeConfigCache(configCachePath, hashFile(path), sensorConfig,
+                         zoneConfig, zoneDetailsConfig);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Failed to compile " << path << ": " << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Compiled " << path << " to " << configCachePath << "\n";
+    return EXIT_SUCCESS;
+}
+
+void restartControlLoops()
+{
+    const std::filesystem::path path =
+        (!configPath.empty()) ? configPath : searchConfigurationPath();
+
+    if (std::filesystem::exists(path))
+    {
+        /*
+         * When building the sensors, if any of the dbus passive ones aren't on
+         * the bus, it'll fail immediately.
+         */
+        try
+        {
+            uint64_t source = hashFile(path);
+            if (readConfigCache(configCachePath, source, sensorConfig,
+                                zoneConfig, zoneDetailsConfig))
+            {
+                std::cerr << "Loaded configuration cache " << configCachePath
+                          << "\n";
+            }
+            else
+            {
+                buildJsonConfiguration(path);
+                updateConfigCache(source);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Failed during building: " << e.what() << "\n";
+            exit(EXIT_FAILURE); /* fatal error. */
+        }
+    }
+    else
+    {
+        // Discovery can take a while after boot, so start from what it found
+        // last time.  Once it completes, only the zones that changed since
+        // are rebuilt.
+        static bool first = true;
+        if (std::exchange(first, false) &&
+            readConfigCache(configCachePath, dbusConfigSource, sensorConfig,
+                            zoneConfig, zoneDetailsConfig))
+        {
+            std::cerr << "Starting from configuration cache "
+                      << configCachePath << "\n";
+            startControlLoops();
+        }
+
+        static boost::asio::steady_timer reloadTimer(io);
+        dbus_configuration::init(
+            modeControlBus, reloadTimer, sensorConfig, zoneConfig,
+            zoneDetailsConfig, [](std::exception_ptr error, bool ready) {
+                // retry when the configuration or control loops can't be
+                // built.
+                try
+                {
+                    if (error)
+                    {
+                        std::rethrow_exception(error);
+                    }
+                    if (!ready)
+                    {
+                        return; // configuration not ready
+                    }
+                    updateConfigCache(dbusConfigSource);
+
+                    // Most reloads find the same configuration, skip those
+                    // before diffing it zone by zone.
+                    if (hashConfig(sensorConfig, zoneConfig,
+                                   zoneDetailsConfig) ==
+                        hashConfig(state::sensorConfig, state::zoneConfig,
+                                   state::zoneDetailsConfig))
+                    {
+                        std::cerr << "Configuration unchanged, "
+                                  << dbus_configuration::reloadAvoided()
+                                  << " reloads avoided\n";
+                        return;
+                    }
+                    startControlLoops();
+                }
+                catch (const std::exception& e)
+                {
+                    std::cerr << "Failed to load configuration, try again: "
+                              << e.what() << "\n";
+                    tryRestartControlLoops(false);
+                }
+            });
+        return;
+    }
+
+    startControlLoops();
 }
 
 void tryRestartControlLoops(bool first)
@@ -282,6 +807,7 @@ void signalHandler(const boost::system::error_code& error, int signal_number)
     }
     if (signal_number == SIGTERM)
     {
+        pid_control::saveControllerStates();
         pid_control::tryTerminateControlLoops(true);
     }
     else
@@ -322,9 +848,20 @@ int main(int argc, char* argv[])
     app.add_flag("-d,--debug", debugEnabled, "Enable or disable debug mode");
     app.add_flag("-g,--corelogging", coreLoggingEnabled,
                  "Enable or disable logging of core PID loop computations");
+    app.add_option("--config-cache", configCachePath,
+                   "Optional parameter to specify the configuration cache");
+    bool compileConfig = false;
+    app.add_flag("--compile-config", compileConfig,
+                 "Compile the json configuration into the configuration "
+                 "cache and exit");
 
     CLI11_PARSE(app, argc, argv);
 
+    if (compileConfig)
+    {
+        return pid_control::compileConfiguration();
+    }
+
     static constexpr auto loggingEnablePath = "/etc/thermal.d/logging";
     static constexpr auto tuningEnablePath = "/etc/thermal.d/tuning";
     static constexpr auto debugEnablePath = "/etc/thermal.d/debugging";
@@ -403,6 +940,9 @@ int main(int argc, char* argv[])
     sdbusplus::server::manager_t manager(
         static_cast<sdbusplus::bus_t&>(modeControlBus), modeRoot);
     hostBus.request_name("xyz.openbmc_project.Hwmon.external");
+    // Lets a host push all of its sensor readings in one call.
+    pid_control::HostSensorBatch hostBatch(
+        hostBus, pid_control::SensorManager::SensorRoot);
     modeControlBus.request_name("xyz.openbmc_project.State.FanCtrl");
     sdbusplus::server::manager_t objManager(modeControlBus, modeRoot);
 
@@ -414,6 +954,11 @@ int main(int argc, char* argv[])
      * it.
      */
 
+    // Pick up the controller state a previous instance left behind.
+    pid_control::state::saved = pid_control::readSnapshot(
+        pid_control::snapshotPath, pid_control::snapshotMaxAge);
+    pid_control::scheduleControllerStateSaves();
+
     pid_control::tryRestartControlLoops();
 
     /* setup host state monitor */
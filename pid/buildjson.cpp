@@ -118,41 +118,39 @@ void from_json(const json& j, conf::ControllerInfo& c)
         p.at("samplePeriod").get_to(c.stepwiseInfo.ts);
         p.at("isCeiling").get_to(c.stepwiseInfo.isCeiling);
 
-        for (size_t i = 0; i < ec::maxStepwisePoints; i++)
-        {
-            c.stepwiseInfo.reading[i] =
-                std::numeric_limits<double>::quiet_NaN();
-            c.stepwiseInfo.output[i] = std::numeric_limits<double>::quiet_NaN();
-        }
-
+        // The points are numbered from "0" and end at the first number
+        // missing from the readings.
         auto reading = p.find("reading");
         if (reading != p.end())
         {
-            auto r = p.at("reading");
-            for (size_t i = 0; i < ec::maxStepwisePoints; i++)
+            for (size_t i = 0; reading->contains(std::to_string(i)); i++)
             {
-                auto n = r.find(std::to_string(i));
-                if (n != r.end())
-                {
-                    r.at(std::to_string(i)).get_to(c.stepwiseInfo.reading[i]);
-                }
+                c.stepwiseInfo.reading.push_back(
+                    reading->at(std::to_string(i)).get<double>());
             }
         }
 
+        c.stepwiseInfo.output.assign(c.stepwiseInfo.reading.size(),
+                                     std::numeric_limits<double>::quiet_NaN());
         auto output = p.find("output");
         if (output != p.end())
         {
-            auto o = p.at("output");
-            for (size_t i = 0; i < ec::maxStepwisePoints; i++)
+            for (size_t i = 0; i < c.stepwiseInfo.output.size(); i++)
             {
-                auto n = o.find(std::to_string(i));
-                if (n != o.end())
+                auto n = output->find(std::to_string(i));
+                if (n != output->end())
                 {
-                    o.at(std::to_string(i)).get_to(c.stepwiseInfo.output[i]);
+                    n->get_to(c.stepwiseInfo.output[i]);
                 }
             }
         }
 
+        auto interpolate = p.find("interpolate");
+        if (interpolate != p.end())
+        {
+            interpolate->get_to(c.stepwiseInfo.interpolate);
+        }
+
         c.stepwiseInfo.positiveHysteresis = positiveHysteresisValue;
         c.stepwiseInfo.negativeHysteresis = negativeHysteresisValue;
     }
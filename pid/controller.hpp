@@ -1,10 +1,31 @@
 #pragma once
 
+#include <limits>
 #include <string>
 
 namespace pid_control
 {
 
+/*
+ * The part of a controller's state that is carried over when it's rebuilt,
+ * on a reload or a daemon restart.  Fields a controller doesn't use keep
+ * their defaults.
+ */
+struct ControllerState
+{
+    /* "pid", "fan" or "stepwise", a state only restores the same kind. */
+    std::string kind;
+    /* ec::pid_info_t internals. */
+    bool initialized = false;
+    double integral = 0.0;
+    double lastError = 0.0;
+    /* The last input acted on and the output it produced. */
+    double lastInput = std::numeric_limits<double>::quiet_NaN();
+    double lastOutput = std::numeric_limits<double>::quiet_NaN();
+    /* FanSpeedDirection, for fan controllers. */
+    int direction = 0;
+};
+
 /*
  * Base class for controllers.  Each controller that implements this needs to
  * provide an inputProc, process, and outputProc.
@@ -22,6 +43,18 @@ struct Controller
     virtual void process(void) = 0;
 
     virtual std::string getID(void) = 0;
+
+    /* Return the state to carry over if this controller is rebuilt. */
+    virtual ControllerState getState(void)
+    {
+        return {};
+    }
+
+    /* Restore state from getState(), returns false if it doesn't apply. */
+    virtual bool setState([[maybe_unused]] const ControllerState& state)
+    {
+        return false;
+    }
 };
 
 } // namespace pid_control
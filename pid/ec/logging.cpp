@@ -119,18 +119,18 @@ static void DumpCoeffsData(std::ofstream& file,
     file << "\n" << std::flush;
 }
 
-void LogInit(const std::string& name, pid_info_t* pidinfoptr)
+PidCoreLog* LogInit(const std::string& name)
 {
     if (!coreLoggingEnabled)
     {
         // PID logging not enabled by configuration, silently do nothing
-        return;
+        return nullptr;
     }
 
     if (name.empty())
     {
         std::cerr << "PID logging disabled because PID does not have a name\n";
-        return;
+        return nullptr;
     }
 
     std::string cleanName = StrClean(name);
@@ -138,7 +138,7 @@ void LogInit(const std::string& name, pid_info_t* pidinfoptr)
     {
         std::cerr << "PID logging disabled because PID name is unusable: "
                   << name << "\n";
-        return;
+        return nullptr;
     }
 
     auto iterExisting = nameToLog.find(name);
@@ -157,7 +157,7 @@ void LogInit(const std::string& name, pid_info_t* pidinfoptr)
             {
                 std::cerr << "PID logging disabled because of name collision: "
                           << name << "\n";
-                return;
+                return nullptr;
             }
         }
 
@@ -172,7 +172,7 @@ void LogInit(const std::string& name, pid_info_t* pidinfoptr)
         {
             std::cerr << "PID logging disabled because unable to open file: "
                       << filec << "\n";
-            return;
+            return nullptr;
         }
 
         outf.open(filef);
@@ -183,7 +183,7 @@ void LogInit(const std::string& name, pid_info_t* pidinfoptr)
 
             std::cerr << "PID logging disabled because unable to open file: "
                       << filef << "\n";
-            return;
+            return nullptr;
         }
 
         PidCoreLog newLog;
@@ -207,26 +207,21 @@ void LogInit(const std::string& name, pid_info_t* pidinfoptr)
         std::cerr << "PID logging initialized: " << name << "\n";
     }
 
+    // Entries are never removed, so the pointer stays valid
+    return &(iterExisting->second);
+}
+
+void LogCoeffs(PidCoreLog& pidLog, pid_info_t* pidinfoptr)
+{
     auto msNow = LogTimestamp();
 
     // Write the coefficients only once per PID loop initialization
     // If they change, caller will reinitialize the PID loops
-    DumpCoeffsData(iterExisting->second.fileCoeffs, msNow, pidinfoptr);
+    DumpCoeffsData(pidLog.fileCoeffs, msNow, pidinfoptr);
 
     // Force the next logging line to be logged
-    iterExisting->second.lastLog = iterExisting->second.lastLog.zero();
-    iterExisting->second.lastContext = PidCoreContext();
-}
-
-PidCoreLog* LogPeek(const std::string& name)
-{
-    auto iter = nameToLog.find(name);
-    if (iter != nameToLog.end())
-    {
-        return &(iter->second);
-    }
-
-    return nullptr;
+    pidLog.lastLog = pidLog.lastLog.zero();
+    pidLog.lastContext = PidCoreContext();
 }
 
 void LogContext(PidCoreLog& pidLog, const std::chrono::milliseconds& msNow,
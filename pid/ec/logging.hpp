@@ -99,11 +99,12 @@ struct PidCoreLog
     }
 };
 
-// Initializes logging files, call once per PID loop initialization
-void LogInit(const std::string& name, pid_info_t* pidinfoptr);
-
+// Initializes logging files, call once per PID loop construction
 // Returns PidCoreLog pointer, or nullptr if this PID loop not being logged
-PidCoreLog* LogPeek(const std::string& name);
+PidCoreLog* LogInit(const std::string& name);
+
+// Logs the coefficients, call once per PID loop initialization
+void LogCoeffs(PidCoreLog& pidLog, pid_info_t* pidinfoptr);
 
 // Logs a line of logging, if different, or it has been long enough
 void LogContext(PidCoreLog& pidLog, const std::chrono::milliseconds& msNow,
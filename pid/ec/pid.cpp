@@ -5,8 +5,10 @@
 
 #include "logging.hpp"
 
+#include <array>
 #include <chrono>
-#include <string>
+#include <cstddef>
+#include <utility>
 
 namespace pid_control
 {
@@ -35,18 +37,16 @@ static double clamp(double x, double min, double max)
  *  Note: Codes assumes the ts field is non-zero
  */
 double pid(pid_info_t* pidinfoptr, double input, double setpoint,
-           const std::string* nameptr)
+           PidCoreLog* logPtr)
 {
-    if (nameptr)
+    if (logPtr)
     {
         if (!(pidinfoptr->initialized))
         {
-            LogInit(*nameptr, pidinfoptr);
+            LogCoeffs(*logPtr, pidinfoptr);
         }
     }
 
-    auto logPtr = nameptr ? LogPeek(*nameptr) : nullptr;
-
     PidCoreContext coreContext;
     std::chrono::milliseconds msNow;
 
@@ -178,5 +178,117 @@ double pid(pid_info_t* pidinfoptr, double input, double setpoint,
     return output;
 }
 
+enum pidTerm : unsigned
+{
+    useIntegral = 1,
+    useDerivative = 2,
+    useFeedFwd = 4,
+    useSlew = 8,
+};
+
+/********************************
+ *  specialized pid code
+ *  Follows pid() step for step.  A term that's left out has a zero
+ *  coefficient, so pid() would have added a zero for it.
+ */
+template <size_t terms>
+static double pidTerms(pid_info_t* pidinfoptr, double input, double setpoint)
+{
+    double error = setpoint - input;
+    double proportionalTerm = pidinfoptr->proportionalCoeff * error;
+    double integral = 0.0;
+
+    if constexpr (terms & useIntegral)
+    {
+        integral = pidinfoptr->integral;
+        integral += error * pidinfoptr->integralCoeff * pidinfoptr->ts;
+        integral = clamp(integral, pidinfoptr->integralLimit.min,
+                         pidinfoptr->integralLimit.max);
+    }
+
+    double output = proportionalTerm + integral;
+
+    if constexpr (terms & useDerivative)
+    {
+        output += pidinfoptr->derivativeCoeff *
+                  ((error - pidinfoptr->lastError) / pidinfoptr->ts);
+    }
+
+    if constexpr (terms & useFeedFwd)
+    {
+        output += (setpoint + pidinfoptr->feedFwdOffset) *
+                  pidinfoptr->feedFwdGain;
+    }
+
+    output = clamp(output, pidinfoptr->outLim.min, pidinfoptr->outLim.max);
+
+    if constexpr (terms & useSlew)
+    {
+        if (pidinfoptr->initialized)
+        {
+            if (pidinfoptr->slewNeg != 0.0)
+            {
+                double minOut = pidinfoptr->lastOutput +
+                                pidinfoptr->slewNeg * pidinfoptr->ts;
+                if (output < minOut)
+                {
+                    output = minOut;
+                }
+            }
+            if (pidinfoptr->slewPos != 0.0)
+            {
+                double maxOut = pidinfoptr->lastOutput +
+                                pidinfoptr->slewPos * pidinfoptr->ts;
+                if (output > maxOut)
+                {
+                    output = maxOut;
+                }
+            }
+
+            integral = output - proportionalTerm;
+        }
+    }
+
+    pidinfoptr->integral = clamp(integral, pidinfoptr->integralLimit.min,
+                                 pidinfoptr->integralLimit.max);
+    pidinfoptr->initialized = true;
+    pidinfoptr->lastError = error;
+    pidinfoptr->lastOutput = output;
+
+    return output;
+}
+
+template <size_t... terms>
+static constexpr auto makeKernels(std::index_sequence<terms...>)
+{
+    return std::array<pid_kernel_t, sizeof...(terms)>{pidTerms<terms>...};
+}
+
+pid_kernel_t pidKernel(const pid_info_t& info)
+{
+    static constexpr auto kernels =
+        makeKernels(std::make_index_sequence<useSlew * 2>());
+
+    size_t terms = 0;
+    if (info.integralCoeff != 0.0)
+    {
+        terms |= useIntegral;
+    }
+    if (info.derivativeCoeff != 0.0)
+    {
+        terms |= useDerivative;
+    }
+    if (info.feedFwdGain != 0.0)
+    {
+        terms |= useFeedFwd;
+    }
+    if (info.slewNeg != 0.0 || info.slewPos != 0.0)
+    {
+        terms |= useSlew;
+    }
+
+    return kernels[terms];
+}
+
 } // namespace ec
 } // namespace pid_control
@@ -1,7 +1,5 @@
 #pragma once
 
-#include <string>
-
 namespace pid_control
 {
 namespace ec
@@ -11,6 +9,8 @@ struct limits_t
 {
     double min = 0.0;
     double max = 0.0;
+
+    bool operator==(const limits_t&) const = default;
 };
 
 /* Note: If you update these structs you need to update the copy code in
@@ -41,8 +41,23 @@ struct pid_info_t
     double negativeHysteresis = 0.0;
 };
 
+struct PidCoreLog;
+
+/* logPtr is the PID loop's handle from LogInit(), or nullptr if it isn't
+ * being logged.
+ */
 double pid(pid_info_t* pidinfoptr, double input, double setpoint,
-           const std::string* nameptr = nullptr);
+           PidCoreLog* logPtr = nullptr);
+
+/* ec::pid() without core logging, specialized on which of the integral,
+ * derivative, feed-forward and slew terms are in use so the others aren't
+ * computed.  Gives the same output and state as ec::pid().
+ */
+using pid_kernel_t = double (*)(pid_info_t* pidinfoptr, double input,
+                                double setpoint);
+
+/* The kernel for the coefficients currently in info. */
+pid_kernel_t pidKernel(const pid_info_t& info);
 
 /* Condensed version for use by the configuration. */
 struct pidinfo
@@ -62,6 +77,8 @@ struct pidinfo
     double slewPos = 0.0;
     double positiveHysteresis = 0.0;
     double negativeHysteresis = 0.0;
+
+    bool operator==(const pidinfo&) const = default;
 };
 
 } // namespace ec
@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright 2026 Google Inc
+
+#include "pidbatch.hpp"
+
+#include "pid.hpp"
+
+#include <cstddef>
+#include <span>
+
+namespace pid_control
+{
+namespace ec
+{
+
+// Same as the clamp in pid.cpp.
+static inline double clamp(double x, double min, double max)
+{
+    return (x < min) ? min : ((x > max) ? max : x);
+}
+
+size_t PidBatch::add(const pid_info_t& info)
+{
+    _initialized.push_back(info.initialized);
+    _integral.push_back(info.integral);
+    _lastOutput.push_back(info.lastOutput);
+    _lastError.push_back(info.lastError);
+
+    _ts.push_back(info.ts);
+    _proportionalCoeff.push_back(info.proportionalCoeff);
+    _integralCoeff.push_back(info.integralCoeff);
+    _derivativeCoeff.push_back(info.derivativeCoeff);
+    _feedFwdOffset.push_back(info.feedFwdOffset);
+    _feedFwdGain.push_back(info.feedFwdGain);
+    _integralMin.push_back(info.integralLimit.min);
+    _integralMax.push_back(info.integralLimit.max);
+    _outMin.push_back(info.outLim.min);
+    _outMax.push_back(info.outLim.max);
+    _slewNeg.push_back(info.slewNeg);
+    _slewPos.push_back(info.slewPos);
+
+    return _ts.size() - 1;
+}
+
+void PidBatch::clear(void)
+{
+    for (auto* v : {&_integral, &_lastOutput, &_lastError, &_ts,
+                    &_proportionalCoeff, &_integralCoeff, &_derivativeCoeff,
+                    &_feedFwdOffset, &_feedFwdGain, &_integralMin,
+                    &_integralMax, &_outMin, &_outMax, &_slewNeg, &_slewPos})
+    {
+        v->clear();
+    }
+    _initialized.clear();
+}
+
+void PidBatch::loadState(size_t i, const pid_info_t& info)
+{
+    _initialized[i] = info.initialized;
+    _integral[i] = info.integral;
+    _lastOutput[i] = info.lastOutput;
+    _lastError[i] = info.lastError;
+}
+
+void PidBatch::storeState(size_t i, pid_info_t* info) const
+{
+    info->initialized = _initialized[i];
+    info->integral = _integral[i];
+    info->lastOutput = _lastOutput[i];
+    info->lastError = _lastError[i];
+}
+
+/*
+ * The branches of ec::pid() are written as selects so the loop has no
+ * control flow.  Computing a term that ec::pid() would skip doesn't change
+ * the result, as long as it isn't selected.
+ */
+void PidBatch::run(std::span<const double> input,
+                   std::span<const double> setpoint, std::span<double> output)
+{
+    const size_t n = size();
+
+    const double* in = input.data();
+    const double* sp = setpoint.data();
+    double* out = output.data();
+
+    uint8_t* initialized = _initialized.data();
+    double* integral = _integral.data();
+    double* lastOutput = _lastOutput.data();
+    double* lastError = _lastError.data();
+
+    const double* ts = _ts.data();
+    const double* pCoeff = _proportionalCoeff.data();
+    const double* iCoeff = _integralCoeff.data();
+    const double* dCoeff = _derivativeCoeff.data();
+    const double* ffOffset = _feedFwdOffset.data();
+    const double* ffGain = _feedFwdGain.data();
+    const double* iMin = _integralMin.data();
+    const double* iMax = _integralMax.data();
+    const double* oMin = _outMin.data();
+    const double* oMax = _outMax.data();
+    const double* slewNeg = _slewNeg.data();
+    const double* slewPos = _slewPos.data();
+
+    for (size_t k = 0; k < n; k++)
+    {
+        double error = sp[k] - in[k];
+        double proportionalTerm = pCoeff[k] * error;
+
+        double integralTerm = integral[k] + error * iCoeff[k] * ts[k];
+        integralTerm = clamp(integralTerm, iMin[k], iMax[k]);
+        integralTerm = (0.0 != iCoeff[k]) ? integralTerm : 0.0;
+
+        double derivativeTerm = dCoeff[k] * ((error - lastError[k]) / ts[k]);
+        double feedFwdTerm = (sp[k] + ffOffset[k]) * ffGain[k];
+
+        double result =
+            proportionalTerm + integralTerm + derivativeTerm + feedFwdTerm;
+        result = clamp(result, oMin[k], oMax[k]);
+
+        bool init = initialized[k] != 0;
+        bool neg = init && (0.0 != slewNeg[k]);
+        bool pos = init && (0.0 != slewPos[k]);
+
+        double minOut = lastOutput[k] + slewNeg[k] * ts[k];
+        result = (neg && result < minOut) ? minOut : result;
+        double maxOut = lastOutput[k] + slewPos[k] * ts[k];
+        result = (pos && result > maxOut) ? maxOut : result;
+
+        integralTerm = (neg || pos) ? result - proportionalTerm : integralTerm;
+
+        integral[k] = clamp(integralTerm, iMin[k], iMax[k]);
+        initialized[k] = 1;
+        lastError[k] = error;
+        lastOutput[k] = result;
+        out[k] = result;
+    }
+}
+
+} // namespace ec
+} // namespace pid_control
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "pid.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace pid_control
+{
+namespace ec
+{
+
+/*
+ * A set of PID controllers stored as structure-of-arrays, so that one cycle
+ * of all of them runs as a single loop over contiguous memory.
+ *
+ * run() computes exactly what ec::pid() computes for each controller, in the
+ * same order of operations, so the outputs and state are bit-for-bit equal.
+ * It doesn't do the core logging; controllers that log go through ec::pid().
+ */
+class PidBatch
+{
+  public:
+    /* Add a controller with the coefficients and state in info, returns its
+     * index.
+     */
+    size_t add(const pid_info_t& info);
+
+    size_t size(void) const
+    {
+        return _ts.size();
+    }
+
+    void clear(void);
+
+    /* Copy the state that ec::pid() updates, from info into the batch. */
+    void loadState(size_t i, const pid_info_t& info);
+
+    /* Copy the state that ec::pid() updates, from the batch into info. */
+    void storeState(size_t i, pid_info_t* info) const;
+
+    /* Run one cycle of every controller.  Each span holds size() values. */
+    void run(std::span<const double> input, std::span<const double> setpoint,
+             std::span<double> output);
+
+  private:
+    // state
+    std::vector<uint8_t> _initialized;
+    std::vector<double> _integral;
+    std::vector<double> _lastOutput;
+    std::vector<double> _lastError;
+
+    // parameters
+    std::vector<double> _ts;
+    std::vector<double> _proportionalCoeff;
+    std::vector<double> _integralCoeff;
+    std::vector<double> _derivativeCoeff;
+    std::vector<double> _feedFwdOffset;
+    std::vector<double> _feedFwdGain;
+    std::vector<double> _integralMin;
+    std::vector<double> _integralMax;
+    std::vector<double> _outMin;
+    std::vector<double> _outMax;
+    std::vector<double> _slewNeg;
+    std::vector<double> _slewPos;
+};
+
+} // namespace ec
+} // namespace pid_control
@@ -16,30 +16,61 @@
 
 #include "stepwise.hpp"
 
-#include <cmath>
+#include <algorithm>
 #include <cstddef>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
 
 namespace pid_control
 {
 namespace ec
 {
 
+void sortStepwise(StepwiseInfo& info)
+{
+    if (std::is_sorted(info.reading.begin(), info.reading.end()))
+    {
+        return;
+    }
+
+    std::vector<size_t> order(info.reading.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&info](size_t a, size_t b) {
+        return info.reading[a] < info.reading[b];
+    });
+
+    std::vector<double> reading;
+    std::vector<double> output;
+    for (size_t ii : order)
+    {
+        reading.push_back(info.reading[ii]);
+        output.push_back(info.output[ii]);
+    }
+    info.reading = std::move(reading);
+    info.output = std::move(output);
+}
+
 double stepwise(const ec::StepwiseInfo& info, double input)
 {
-    double value = info.output[0]; // if we are below the lowest
-                                   // point, we set the lowest value
+    if (info.reading.empty())
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    // The first point above input.  The first point is skipped, we use its
+    // output below its reading too.
+    auto next = std::upper_bound(info.reading.begin() + 1, info.reading.end(),
+                                 input);
+    size_t ii = next - info.reading.begin() - 1;
+    double value = info.output[ii];
 
-    for (size_t ii = 1; ii < ec::maxStepwisePoints; ii++)
+    if (info.interpolate && next != info.reading.end() &&
+        input >= info.reading[ii])
     {
-        if (std::isnan(info.reading[ii]))
-        {
-            break;
-        }
-        if (info.reading[ii] > input)
-        {
-            break;
-        }
-        value = info.output[ii];
+        value += (input - info.reading[ii]) * (info.output[ii + 1] - value) /
+                 (*next - info.reading[ii]);
     }
 
     return value;
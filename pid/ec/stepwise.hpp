@@ -17,24 +17,34 @@
 
 #pragma once
 
-#include <cstddef>
+#include <vector>
 
 namespace pid_control
 {
 namespace ec
 {
-constexpr size_t maxStepwisePoints = 20;
 
+/* The points are sorted by reading.  Below the first reading the output is
+ * the first output, and at or above a reading it's that point's output, or
+ * with interpolate, the output linearly interpolated towards the next point.
+ */
 struct StepwiseInfo
 {
-    double ts; // sample time in seconds
-    double reading[maxStepwisePoints];
-    double output[maxStepwisePoints];
-    double positiveHysteresis;
-    double negativeHysteresis;
-    bool isCeiling;
+    double ts = 0.0; // sample time in seconds
+    std::vector<double> reading;
+    std::vector<double> output;
+    double positiveHysteresis = 0.0;
+    double negativeHysteresis = 0.0;
+    bool isCeiling = false;
+    bool interpolate = false;
+
+    bool operator==(const StepwiseInfo&) const = default;
 };
 
+/* Sort the points by reading, keeping the order of equal readings. */
+void sortStepwise(StepwiseInfo& info);
+
+/* NaN if there are no points. */
 double stepwise(const ec::StepwiseInfo& info, double value);
 
 } // namespace ec
@@ -5,6 +5,7 @@
 
 #include "fancontroller.hpp"
 
+#include "controller.hpp"
 #include "ec/pid.hpp"
 #include "fan.hpp"
 #include "pidcontroller.hpp"
@@ -12,11 +13,11 @@
 #include "util.hpp"
 #include "zone_interface.hpp"
 
-#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <exception>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <memory>
 #include <string>
@@ -38,22 +39,29 @@ std::unique_ptr<PIDController> FanController::createFanPid(
     ec::pid_info_t* info = fan->getPIDInfo();
 
     initializePIDStruct(info, initial);
+    fan->selectKernel();
 
     return fan;
 }
 
 double FanController::inputProc(void)
 {
-    double value = 0.0;
-    std::vector<double> values;
-    std::vector<double>::iterator result;
+    _owner->resolveCachedValueSlots(_inputs, _inputSlots);
+
+    /* the fan PID algorithm was unstable with average, and seemed to work
+     * better with minimum.  I had considered making this choice a variable
+     * in the configuration, and it's a nice-to-have..
+     */
+    double value = std::numeric_limits<double>::infinity();
 
     try
     {
-        for (const auto& name : _inputs)
+        for (size_t ii = 0; ii < _inputs.size(); ii++)
         {
             // Read the unscaled value, to correctly recover the RPM
-            value = _owner->getCachedValues(name).unscaled;
+            const ValueCacheEntry* slot = _inputSlots[ii];
+            double rpm = slot ? slot->unscaled
+                              : _owner->getCachedValues(_inputs[ii]).unscaled;
 
             /* If we have a fan we can't read, its value will be 0 for at least
              * some boards, while others... the fan will drop off dbus (if
@@ -63,16 +71,8 @@ double FanController::inputProc(void)
              * sort of have to guess -- all the other fans are reporting, why
              * not this one?  Maybe it's unable to be read, so it's "bad."
              */
-            if (!(std::isfinite(value)))
-            {
-                continue;
-            }
-            if (value <= 0.0)
-            {
-                continue;
-            }
-
-            values.push_back(value);
+            bool usable = std::isfinite(rpm) && rpm > 0.0;
+            value = (usable && rpm < value) ? rpm : value;
         }
     }
     catch (const std::exception& e)
@@ -81,21 +81,33 @@ double FanController::inputProc(void)
         throw;
     }
 
-    /* Reset the value from the above loop. */
-    value = 0.0;
-    if (values.size() > 0)
+    // None of the fans could be read.
+    if (std::isinf(value))
     {
-        /* the fan PID algorithm was unstable with average, and seemed to work
-         * better with minimum.  I had considered making this choice a variable
-         * in the configuration, and it's a nice-to-have..
-         */
-        result = std::min_element(values.begin(), values.end());
-        value = *result;
+        value = 0.0;
     }
 
     return value;
 }
 
+void FanController::resolveSensors(void)
+{
+    _sensorsVersion = _owner->getSensorsVersion();
+    _sensors.clear();
+    for (const auto& id : _inputs)
+    {
+        _sensors.push_back(_owner->getSensor(id));
+    }
+
+    if (_outputSlots.empty())
+    {
+        for (const auto& id : _inputs)
+        {
+            _outputSlots.push_back(_owner->getOutputCacheSlot(id));
+        }
+    }
+}
+
 double FanController::setptProc(void)
 {
     double maxRPM = _owner->getMaxSetPointRequest();
@@ -201,11 +213,16 @@ void FanController::outputProc(double value)
     // value and kFanFailSafeDutyCycle are 10 for 10% so let's fix that.
     percent /= 100.0;
 
+    if (_sensors.empty() || _sensorsVersion != _owner->getSensorsVersion())
+    {
+        resolveSensors();
+    }
+
     // PidSensorMap for writing.
-    for (const auto& it : _inputs)
+    auto redundantWrite = _owner->getRedundantWrite();
+    for (size_t ii = 0; ii < _sensors.size(); ii++)
     {
-        auto sensor = _owner->getSensor(it);
-        auto redundantWrite = _owner->getRedundantWrite();
+        Sensor* sensor = _sensors[ii];
         int64_t rawWritten = -1;
         sensor->write(percent, redundantWrite, &rawWritten);
 
@@ -213,12 +230,51 @@ void FanController::outputProc(double value)
         // to store a record of the PWM commanded,
         // so that this information can be included during logging.
         auto unscaledWritten = static_cast<double>(rawWritten);
-        _owner->setOutputCache(sensor->getName(), {percent, unscaledWritten});
+        if (_outputSlots[ii])
+        {
+            *_outputSlots[ii] = {percent, unscaledWritten};
+        }
+        else
+        {
+            _owner->setOutputCache(sensor->getName(),
+                                   {percent, unscaledWritten});
+        }
     }
 
     return;
 }
 
+void FanController::processDirect(void)
+{
+    double setpt = FanController::setptProc();
+    double input = FanController::inputProc();
+    FanController::outputProc(computeOutput(setpt, input));
+}
+
+ControllerState FanController::getState(void)
+{
+    ControllerState state = PIDController::getState();
+
+    state.kind = "fan";
+    state.direction = static_cast<int>(_direction);
+
+    return state;
+}
+
+bool FanController::setState(const ControllerState& state)
+{
+    if (state.direction < static_cast<int>(FanSpeedDirection::DOWN) ||
+        state.direction > static_cast<int>(FanSpeedDirection::NEUTRAL) ||
+        !PIDController::setState(state))
+    {
+        return false;
+    }
+
+    _direction = static_cast<FanSpeedDirection>(state.direction);
+
+    return true;
+}
+
 FanController::~FanController()
 {
     if constexpr (!OFFLINE_FAILSAFE_PWM)
@@ -2,8 +2,12 @@
 
 #include "ec/pid.hpp"
 #include "fan.hpp"
+#include "interfaces.hpp"
 #include "pidcontroller.hpp"
+#include "sensors/sensor.hpp"
+#include "symbols.hpp"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -25,7 +29,7 @@ class FanController : public PIDController
 
     FanController(const std::string& id, const std::vector<std::string>& inputs,
                   ZoneInterface* owner) :
-        PIDController(id, owner), _inputs(inputs)
+        PIDController(id, owner), _inputs(intern(inputs))
     {}
 
     ~FanController() override;
@@ -33,6 +37,9 @@ class FanController : public PIDController
     double setptProc(void) override;
     void outputProc(double value) override;
 
+    /* process() with this class's procs called directly. */
+    void processDirect(void);
+
     FanSpeedDirection getFanDirection(void) const
     {
         return _direction;
@@ -43,8 +50,25 @@ class FanController : public PIDController
         _direction = direction;
     };
 
+    ControllerState getState(void) override;
+    bool setState(const ControllerState& state) override;
+
   private:
-    std::vector<std::string> _inputs;
+    void resolveSensors(void);
+
+    std::vector<SymbolId> _inputs;
+
+    /*
+     * Per input, found on first use so the cycle doesn't look anything up by
+     * name: the cache entry inputProc() reads, and the sensor and output
+     * cache entry outputProc() writes.  A nullptr entry falls back to the
+     * lookup by name.  The sensors are found again whenever the zone's
+     * sensors change.
+     */
+    std::vector<const ValueCacheEntry*> _inputSlots;
+    std::vector<Sensor*> _sensors;
+    std::vector<ValueCacheEntry*> _outputSlots;
+    uint64_t _sensorsVersion = 0;
     FanSpeedDirection _direction = FanSpeedDirection::NEUTRAL;
 
     // Cosmetic only, to reduce frequency of repetitive messages
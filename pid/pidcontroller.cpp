@@ -3,18 +3,60 @@
 
 #include "pidcontroller.hpp"
 
+#include "controller.hpp"
+#include "ec/logging.hpp"
 #include "ec/pid.hpp"
 
 #include <cmath>
+#include <string>
 
 namespace pid_control
 {
 
+PIDController::PIDController(const std::string& id, ZoneInterface* owner) :
+    Controller(), _owner(owner), _id(id), _log(ec::LogInit(id))
+{
+    _pid_info.initialized = false;
+    _pid_info.checkHysterWithSetpt = false;
+    _pid_info.ts = static_cast<double>(0.0);
+    _pid_info.integral = static_cast<double>(0.0);
+    _pid_info.lastOutput = static_cast<double>(0.0);
+    _pid_info.proportionalCoeff = static_cast<double>(0.0);
+    _pid_info.integralCoeff = static_cast<double>(0.0);
+    _pid_info.derivativeCoeff = static_cast<double>(0.0);
+    _pid_info.feedFwdOffset = static_cast<double>(0.0);
+    _pid_info.feedFwdGain = static_cast<double>(0.0);
+    _pid_info.integralLimit.min = static_cast<double>(0.0);
+    _pid_info.integralLimit.max = static_cast<double>(0.0);
+    _pid_info.outLim.min = static_cast<double>(0.0);
+    _pid_info.outLim.max = static_cast<double>(0.0);
+    _pid_info.slewNeg = static_cast<double>(0.0);
+    _pid_info.slewPos = static_cast<double>(0.0);
+    _pid_info.negativeHysteresis = static_cast<double>(0.0);
+    _pid_info.positiveHysteresis = static_cast<double>(0.0);
+}
+
+void PIDController::selectKernel(void)
+{
+    // Core logging is only done by ec::pid().
+    _kernel = _log ? nullptr : ec::pidKernel(_pid_info);
+}
+
+double PIDController::runPID(ec::pid_info_t* info, double input,
+                             double setpt)
+{
+    if (_kernel && info == &_pid_info)
+    {
+        return _kernel(info, input, setpt);
+    }
+
+    return ec::pid(info, input, setpt, _log);
+}
+
 double PIDController::calPIDOutput(double setpt, double input,
                                    ec::pid_info_t* info)
 {
     double output;
-    auto name = getID();
 
     if (info->checkHysterWithSetpt)
     {
@@ -22,7 +64,7 @@ double PIDController::calPIDOutput(double setpt, double input,
         if (input > (setpt + info->positiveHysteresis))
         {
             // Calculate new output
-            output = ec::pid(info, input, setpt, &name);
+            output = runPID(info, input, setpt);
 
             // this variable isn't actually used in this context, but we're
             // setting it here in case somebody uses it later it's the correct
@@ -51,7 +93,7 @@ double PIDController::calPIDOutput(double setpt, double input,
         if (info->positiveHysteresis == 0 && info->negativeHysteresis == 0)
         {
             // Calculate new output
-            output = ec::pid(info, input, setpt, &name);
+            output = runPID(info, input, setpt);
 
             // this variable isn't actually used in this context, but we're
             // setting it here in case somebody uses it later it's the correct
@@ -78,7 +120,7 @@ double PIDController::calPIDOutput(double setpt, double input,
                 lastInput = input;
             }
 
-            output = ec::pid(info, lastInput, setpt, &name);
+            output = runPID(info, lastInput, setpt);
         }
     }
 
@@ -87,27 +129,90 @@ double PIDController::calPIDOutput(double setpt, double input,
 
 void PIDController::process(void)
 {
-    double input;
-    double setpt;
-    double output;
-
     // Get setpt value
-    setpt = setptProc();
+    double setpt = setptProc();
 
     // Get input value
-    input = inputProc();
+    double input = inputProc();
+
+    // Output new value
+    outputProc(computeOutput(setpt, input));
+
+    return;
+}
 
+double PIDController::computeOutput(double setpt, double input)
+{
     auto info = getPIDInfo();
 
     // Calculate output value
-    output = calPIDOutput(setpt, input, info);
+    double output = calPIDOutput(setpt, input, info);
 
     info->lastOutput = output;
 
-    // Output new value
+    return output;
+}
+
+bool PIDController::isBatchable(void)
+{
+    return !_pid_info.checkHysterWithSetpt &&
+           _pid_info.positiveHysteresis == 0 &&
+           _pid_info.negativeHysteresis == 0;
+}
+
+void PIDController::finishBatched(double input, double output)
+{
+    lastInput = input;
     outputProc(output);
+}
 
-    return;
+// Same clamping as ec::pid(), which tolerates min > max.
+static double clampToLimits(double x, const ec::limits_t& limits)
+{
+    if (x < limits.min)
+    {
+        return limits.min;
+    }
+    if (x > limits.max)
+    {
+        return limits.max;
+    }
+    return x;
+}
+
+ControllerState PIDController::getState(void)
+{
+    ControllerState state;
+
+    state.kind = "pid";
+    state.initialized = _pid_info.initialized;
+    state.integral = _pid_info.integral;
+    state.lastError = _pid_info.lastError;
+    state.lastInput = lastInput;
+    state.lastOutput = _pid_info.lastOutput;
+
+    return state;
+}
+
+bool PIDController::setState(const ControllerState& state)
+{
+    if (state.kind != getState().kind || !state.initialized ||
+        !std::isfinite(state.integral) || !std::isfinite(state.lastError) ||
+        !std::isfinite(state.lastOutput))
+    {
+        return false;
+    }
+
+    // The limits may have changed along with the configuration, keep the
+    // restored state inside them.
+    _pid_info.initialized = true;
+    _pid_info.integral =
+        clampToLimits(state.integral, _pid_info.integralLimit);
+    _pid_info.lastError = state.lastError;
+    _pid_info.lastOutput = clampToLimits(state.lastOutput, _pid_info.outLim);
+    lastInput = state.lastInput;
+
+    return true;
 }
 
 } // namespace pid_control
@@ -18,28 +18,7 @@ class ZoneInterface;
 class PIDController : public Controller
 {
   public:
-    PIDController(const std::string& id, ZoneInterface* owner) :
-        Controller(), _owner(owner), _id(id)
-    {
-        _pid_info.initialized = false;
-        _pid_info.checkHysterWithSetpt = false;
-        _pid_info.ts = static_cast<double>(0.0);
-        _pid_info.integral = static_cast<double>(0.0);
-        _pid_info.lastOutput = static_cast<double>(0.0);
-        _pid_info.proportionalCoeff = static_cast<double>(0.0);
-        _pid_info.integralCoeff = static_cast<double>(0.0);
-        _pid_info.derivativeCoeff = static_cast<double>(0.0);
-        _pid_info.feedFwdOffset = static_cast<double>(0.0);
-        _pid_info.feedFwdGain = static_cast<double>(0.0);
-        _pid_info.integralLimit.min = static_cast<double>(0.0);
-        _pid_info.integralLimit.max = static_cast<double>(0.0);
-        _pid_info.outLim.min = static_cast<double>(0.0);
-        _pid_info.outLim.max = static_cast<double>(0.0);
-        _pid_info.slewNeg = static_cast<double>(0.0);
-        _pid_info.slewPos = static_cast<double>(0.0);
-        _pid_info.negativeHysteresis = static_cast<double>(0.0);
-        _pid_info.positiveHysteresis = static_cast<double>(0.0);
-    }
+    PIDController(const std::string& id, ZoneInterface* owner);
 
     ~PIDController() override = default;
 
@@ -74,13 +53,41 @@ class PIDController : public Controller
 
     double calPIDOutput(double setpt, double input, ec::pid_info_t* info);
 
+    /* The middle of process(): the output for setpt and input, which the
+     * caller passes to outputProc().  A derived class running its own procs
+     * directly calls this in between.
+     */
+    double computeOutput(double setpt, double input);
+
+    /* Pick the ec::pidKernel() for the coefficients now in the PID info,
+     * which the factories call once they've set them.  Until then, and
+     * while this PID is core logged, ec::pid() is used.
+     */
+    void selectKernel(void);
+
+    /* Whether calPIDOutput() is a plain ec::pid(), with no hysteresis, so
+     * the zone may compute it in an ec::PidBatch with other controllers.
+     */
+    bool isBatchable(void);
+
+    /* The rest of process() once a batch has computed the output. */
+    void finishBatched(double input, double output);
+
+    ControllerState getState(void) override;
+    bool setState(const ControllerState& state) override;
+
   protected:
     ZoneInterface* _owner;
     std::string _id;
 
   private:
+    double runPID(ec::pid_info_t* info, double input, double setpt);
+
     // parameters
     ec::pid_info_t _pid_info;
+    ec::pid_kernel_t _kernel = nullptr;
+    // Core logging handle, found once so ec::pid() needn't look it up.
+    ec::PidCoreLog* _log = nullptr;
     double _setpoint = 0;
     double lastInput = std::numeric_limits<double>::quiet_NaN();
 };
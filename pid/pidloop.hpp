@@ -10,6 +10,25 @@
 namespace pid_control
 {
 
+/**
+ * Prepare a zone to run: open its log, initialize its cache and run a first
+ * thermal cycle.
+ *
+ * @param[in] zone - ptr to the ZoneInterface implementation to start.
+ */
+void pidControlStart(const std::shared_ptr<ZoneInterface>& zone);
+
+/**
+ * Run one fan cycle of a zone, and a thermal cycle as well when enough
+ * fan cycles have gone by.  Does nothing while the zone is in manual mode.
+ *
+ * @param[in] zone - ptr to the ZoneInterface implementation to run.
+ * @param[in,out] cycleCnt - milliseconds counted towards the next thermal
+ * cycle.
+ */
+void pidControlCycle(const std::shared_ptr<ZoneInterface>& zone,
+                     uint64_t& cycleCnt);
+
 /**
  * Main pid control loop for a given zone.
  * This function calls itself indefinitely in an async loop to calculate
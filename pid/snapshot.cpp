@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright 2026 Google Inc
+
+#include "pid/snapshot.hpp"
+
+#include "pid/controller.hpp"
+#include "util.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+namespace pid_control
+{
+
+static constexpr int snapshotVersion = 1;
+
+/* NaN is written as null, which can't be read back as a double. */
+static double getDouble(const nlohmann::json& j, const char* key)
+{
+    const auto& value = j.at(key);
+    if (value.is_null())
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return value.get<double>();
+}
+
+bool isFresh(const ZoneSnapshot& zone,
+             std::chrono::steady_clock::time_point now,
+             std::chrono::steady_clock::duration maxAge)
+{
+    auto age = now - zone.taken;
+    return age >= std::chrono::steady_clock::duration::zero() && age <= maxAge;
+}
+
+nlohmann::json snapshotToJson(const Snapshot& snapshot)
+{
+    nlohmann::json zones = nlohmann::json::array();
+
+    for (const auto& [id, zone] : snapshot)
+    {
+        nlohmann::json controllers = nlohmann::json::array();
+        for (const auto& [name, state] : zone.controllers)
+        {
+            controllers.push_back({{"name", name},
+                                   {"kind", state.kind},
+                                   {"initialized", state.initialized},
+                                   {"integral", state.integral},
+                                   {"lastError", state.lastError},
+                                   {"lastInput", state.lastInput},
+                                   {"lastOutput", state.lastOutput},
+                                   {"direction", state.direction}});
+        }
+
+        zones.push_back(
+            {{"id", id},
+             {"taken", std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           zone.taken.time_since_epoch())
+                           .count()},
+             {"controllers", controllers}});
+    }
+
+    return {{"version", snapshotVersion}, {"zones", zones}};
+}
+
+Snapshot snapshotFromJson(const nlohmann::json& data)
+{
+    Snapshot snapshot;
+
+    if (data.at("version").get<int>() != snapshotVersion)
+    {
+        return snapshot;
+    }
+
+    for (const auto& z : data.at("zones"))
+    {
+        ZoneSnapshot& zone = snapshot[z.at("id").get<int64_t>()];
+        zone.taken = std::chrono::steady_clock::time_point(
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::nanoseconds(z.at("taken").get<int64_t>())));
+
+        for (const auto& c : z.at("controllers"))
+        {
+            ControllerState& state =
+                zone.controllers[c.at("name").get<std::string>()];
+            state.kind = c.at("kind").get<std::string>();
+            state.initialized = c.at("initialized").get<bool>();
+            state.integral = getDouble(c, "integral");
+            state.lastError = getDouble(c, "lastError");
+            state.lastInput = getDouble(c, "lastInput");
+            state.lastOutput = getDouble(c, "lastOutput");
+            state.direction = c.at("direction").get<int>();
+        }
+    }
+
+    return snapshot;
+}
+
+void writeSnapshot(const std::string& path, const Snapshot& snapshot)
+{
+    writeFileAtomic(path, snapshotToJson(snapshot).dump());
+}
+
+Snapshot readSnapshot(const std::string& path,
+                      std::chrono::steady_clock::duration maxAge)
+{
+    Snapshot snapshot;
+
+    std::ifstream in(path);
+    if (!in)
+    {
+        return snapshot;
+    }
+
+    try
+    {
+        snapshot = snapshotFromJson(nlohmann::json::parse(in));
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Ignoring controller state in " << path << ": "
+                  << e.what() << "\n";
+        return {};
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    std::erase_if(snapshot, [now, maxAge](const auto& zone) {
+        return !isFresh(zone.second, now, maxAge);
+    });
+
+    return snapshot;
+}
+
+} // namespace pid_control
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "pid/controller.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace pid_control
+{
+
+/* Where the controller state is kept across daemon restarts. */
+constexpr auto snapshotPath = "/run/phosphor-pid-control/state.json";
+/* How often the state of the running zones is written out. */
+constexpr auto snapshotInterval = std::chrono::seconds(10);
+/* State older than this is too stale to restore. */
+constexpr auto snapshotMaxAge = std::chrono::seconds(30);
+
+/*
+ * The state of a zone's controllers, by controller ID, and when it was taken.
+ */
+struct ZoneSnapshot
+{
+    std::chrono::steady_clock::time_point taken;
+    std::map<std::string, ControllerState> controllers;
+};
+
+/* <zone id, snapshot> */
+using Snapshot = std::map<int64_t, ZoneSnapshot>;
+
+/*
+ * Whether the zone snapshot was taken no more than maxAge before now.
+ */
+bool isFresh(const ZoneSnapshot& zone,
+             std::chrono::steady_clock::time_point now,
+             std::chrono::steady_clock::duration maxAge);
+
+nlohmann::json snapshotToJson(const Snapshot& snapshot);
+
+/*
+ * @throw nlohmann::json::exception if data isn't a snapshot.
+ */
+Snapshot snapshotFromJson(const nlohmann::json& data);
+
+/*
+ * Write the snapshot to path, replacing any previous one atomically.
+ *
+ * @throw std::runtime_error or std::filesystem::filesystem_error on failure.
+ */
+void writeSnapshot(const std::string& path, const Snapshot& snapshot);
+
+/*
+ * Read a snapshot written by writeSnapshot(), leaving out zones older than
+ * maxAge.  A missing or unreadable file gives an empty snapshot.
+ */
+Snapshot readSnapshot(const std::string& path,
+                      std::chrono::steady_clock::duration maxAge);
+
+} // namespace pid_control
@@ -39,7 +39,15 @@ void StepwiseController::process(void)
     // Get input value
     double input = inputProc();
 
-    ec::StepwiseInfo info = getStepwiseInfo();
+    // Output new value
+    outputProc(step(input));
+
+    return;
+}
+
+double StepwiseController::step(double input)
+{
+    const ec::StepwiseInfo& info = getStepwiseInfo();
 
     double output = lastOutput;
 
@@ -61,10 +69,8 @@ void StepwiseController::process(void)
     }
 
     lastOutput = output;
-    // Output new value
-    outputProc(output);
 
-    return;
+    return output;
 }
 
 std::unique_ptr<Controller> StepwiseController::createStepwiseController(
@@ -76,9 +82,15 @@ std::unique_ptr<Controller> StepwiseController::createStepwiseController(
     {
         throw ControllerBuildException("Stepwise controller missing inputs");
     }
+    if (initial.reading.size() != initial.output.size())
+    {
+        throw ControllerBuildException(
+            "Stepwise controller readings and outputs differ in number");
+    }
 
     auto thermal = std::make_unique<StepwiseController>(id, inputs, owner);
     thermal->setStepwiseInfo(initial);
+    ec::sortStepwise(thermal->getStepwiseInfo());
 
     return thermal;
 }
@@ -103,6 +115,20 @@ double StepwiseController::inputProc(void)
 void StepwiseController::outputProc(double value)
 {
     if (getStepwiseInfo().isCeiling)
+    {
+        writeOutput<true>(value);
+    }
+    else
+    {
+        writeOutput<false>(value);
+    }
+    return;
+}
+
+template <bool Ceiling>
+void StepwiseController::writeOutput(double value)
+{
+    if constexpr (Ceiling)
     {
         _owner->addRPMCeiling(value);
     }
@@ -114,7 +140,42 @@ void StepwiseController::outputProc(double value)
             std::cerr << getID() << " stepwise output pwm: " << value << "\n";
         }
     }
-    return;
+}
+
+template <bool Ceiling>
+void StepwiseController::processDirect(void)
+{
+    double input = StepwiseController::inputProc();
+    writeOutput<Ceiling>(step(input));
+}
+
+template void StepwiseController::processDirect<false>(void);
+template void StepwiseController::processDirect<true>(void);
+
+ControllerState StepwiseController::getState(void)
+{
+    ControllerState state;
+
+    state.kind = "stepwise";
+    state.lastInput = lastInput;
+    state.lastOutput = lastOutput;
+
+    return state;
+}
+
+bool StepwiseController::setState(const ControllerState& state)
+{
+    // A NaN lastOutput means the controller hasn't run yet.
+    if (state.kind != "stepwise" || std::isinf(state.lastInput) ||
+        std::isinf(state.lastOutput))
+    {
+        return false;
+    }
+
+    lastInput = state.lastInput;
+    lastOutput = state.lastOutput;
+
+    return true;
 }
 
 } // namespace pid_control
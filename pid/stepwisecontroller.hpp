@@ -2,6 +2,7 @@
 
 #include "controller.hpp"
 #include "ec/stepwise.hpp"
+#include "symbols.hpp"
 
 #include <limits>
 #include <memory>
@@ -24,7 +25,7 @@ class StepwiseController : public Controller
     StepwiseController(const std::string& id,
                        const std::vector<std::string>& inputs,
                        ZoneInterface* owner) :
-        Controller(), _owner(owner), _id(id), _inputs(inputs)
+        Controller(), _owner(owner), _id(id), _inputs(intern(inputs))
     {}
 
     double inputProc(void) override;
@@ -33,6 +34,12 @@ class StepwiseController : public Controller
 
     void process(void) override;
 
+    /* process() with this class's procs called directly, for a controller
+     * whose isCeiling is Ceiling.
+     */
+    template <bool Ceiling>
+    void processDirect(void);
+
     std::string getID(void) override
     {
         return _id;
@@ -48,14 +55,22 @@ class StepwiseController : public Controller
         _stepwise_info = value;
     }
 
+    ControllerState getState(void) override;
+    bool setState(const ControllerState& state) override;
+
   protected:
     ZoneInterface* _owner;
 
   private:
+    /* The output for input, applying the hysteresis. */
+    double step(double input);
+    template <bool Ceiling>
+    void writeOutput(double value);
+
     // parameters
     ec::StepwiseInfo _stepwise_info;
     std::string _id;
-    std::vector<std::string> _inputs;
+    std::vector<SymbolId> _inputs;
     double lastInput = std::numeric_limits<double>::quiet_NaN();
     double lastOutput = std::numeric_limits<double>::quiet_NaN();
 };
@@ -7,12 +7,14 @@
 #include "ec/pid.hpp"
 #include "errors/exception.hpp"
 #include "pidcontroller.hpp"
+#include "symbols.hpp"
 #include "tuning.hpp"
 #include "util.hpp"
 #include "zone_interface.hpp"
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <iostream>
 #include <limits>
 #include <memory>
@@ -64,112 +66,213 @@ std::unique_ptr<PIDController> ThermalController::createThermalPid(
     thermal->setSetpoint(setpoint);
 
     initializePIDStruct(info, initial);
+    thermal->selectKernel();
 
     return thermal;
 }
 
-// bmc_host_sensor_value_double
-double ThermalController::inputProc(void)
+ThermalController::ThermalController(
+    const std::string& id,
+    const std::vector<pid_control::conf::SensorInput>& inputs,
+    const ThermalType& type, ZoneInterface* owner) :
+    PIDController(id, owner), type(type),
+    _values(inputs.size())
 {
-    double value;
-    const double& (*compare)(const double&, const double&);
-    bool doSummation = false;
-
     if (type == ThermalType::margin)
     {
-        value = std::numeric_limits<double>::max();
-        compare = std::min<double>;
+        _reduce = reduce<ThermalType::margin>;
     }
     else if (type == ThermalType::absolute)
     {
-        value = std::numeric_limits<double>::lowest();
-        compare = std::max<double>;
+        _reduce = reduce<ThermalType::absolute>;
     }
     else if (type == ThermalType::summation)
     {
-        doSummation = true;
-        value = 0.0;
+        _reduce = reduce<ThermalType::summation>;
     }
     else
     {
         throw ControllerBuildException("Unrecognized ThermalType");
     }
 
-    std::string leaderName = _inputs.begin()->name;
-
-    bool acceptable = false;
-    for (const auto& in : _inputs)
+    for (const auto& in : inputs)
     {
-        double cachedValue = _owner->getCachedValue(in.name);
+        _inputs.push_back(intern(in.name));
 
-        // Less than 0 is perfectly OK for temperature, but must not be NAN
-        if (!(std::isfinite(cachedValue)))
+        double marginZero = std::numeric_limits<double>::quiet_NaN();
+
+        // TempToMargin conversion only applies to margin controllers
+        if (type == ThermalType::margin && in.convertTempToMargin)
         {
-            continue;
+            if (!(std::isfinite(in.convertMarginZero)))
+            {
+                throw ControllerBuildException("Unrecognized TempToMargin");
+            }
+            marginZero = in.convertMarginZero;
         }
 
-        // Perform TempToMargin conversion before further processing
-        if (type == ThermalType::margin)
+        _marginZero.push_back(marginZero);
+    }
+}
+
+/*
+ * Each reduction is a single pass without calls, and without branches
+ * other than the loop's.  The leader is the input that last changed the
+ * value, as if the values were combined one by one.
+ */
+template <ThermalType T>
+ThermalController::Reduction ThermalController::reduce(
+    const std::vector<double>& values)
+{
+    const size_t count = values.size();
+    Reduction r = {0.0, count, false};
+
+    if constexpr (T == ThermalType::summation)
+    {
+        // Four running sums, so the loop vectorizes.  With more than three
+        // inputs the total may differ in the last bit from adding in order.
+        double sums[4] = {0.0, 0.0, 0.0, 0.0};
+        size_t ii = 0;
+        for (; ii + 4 <= count; ii += 4)
         {
-            if (in.convertTempToMargin)
+            for (size_t jj = 0; jj < 4; jj++)
             {
-                if (!(std::isfinite(in.convertMarginZero)))
-                {
-                    throw ControllerBuildException("Unrecognized TempToMargin");
-                }
-
-                double marginValue = in.convertMarginZero - cachedValue;
+                double v = values[ii + jj];
+                sums[jj] += std::isfinite(v) ? v : 0.0;
+            }
+        }
+        for (; ii < count; ii++)
+        {
+            double v = values[ii];
+            sums[0] += std::isfinite(v) ? v : 0.0;
+        }
+        r.value = (sums[0] + sums[1]) + (sums[2] + sums[3]);
 
-                if (debugEnabled)
+        // The last input that added anything leads.
+        for (size_t kk = count; kk-- > 0 && r.leader == count;)
+        {
+            if (std::isfinite(values[kk]))
+            {
+                r.acceptable = true;
+                if (values[kk] != 0.0)
                 {
-                    std::cerr
-                        << "Converting temp to margin: temp " << cachedValue
-                        << ", Tjmax " << in.convertMarginZero << ", margin "
-                        << marginValue << "\n";
+                    r.leader = kk;
                 }
-
-                cachedValue = marginValue;
             }
         }
+    }
+    else
+    {
+        // Smallest margin, or largest absolute value.  Less than 0 is
+        // perfectly OK for temperature, but must not be NAN
+        constexpr bool margin = (T == ThermalType::margin);
+        r.value = margin ? std::numeric_limits<double>::max()
+                         : std::numeric_limits<double>::lowest();
 
-        double oldValue = value;
-
-        if (doSummation)
+        for (size_t ii = 0; ii < count; ii++)
         {
-            value += cachedValue;
+            double v = values[ii];
+            bool finite = std::isfinite(v);
+            bool leads = finite && (margin ? (v < r.value) : (v > r.value));
+
+            r.value = leads ? v : r.value;
+            r.leader = leads ? ii : r.leader;
+            r.acceptable = r.acceptable || finite;
         }
-        else
+    }
+
+    return r;
+}
+
+void ThermalController::gatherInputs(void)
+{
+    _owner->resolveCachedValueSlots(_inputs, _slots);
+
+    for (size_t ii = 0; ii < _inputs.size(); ii++)
+    {
+        const ValueCacheEntry* slot = _slots[ii];
+        _values[ii] = slot ? slot->scaled : _owner->getCachedValue(_inputs[ii]);
+    }
+
+    if (type != ThermalType::margin)
+    {
+        return;
+    }
+
+    // Perform TempToMargin conversion before further processing
+    for (size_t ii = 0; ii < _values.size(); ii++)
+    {
+        if (std::isnan(_marginZero[ii]))
         {
-            value = compare(value, cachedValue);
+            continue;
         }
 
-        if (oldValue != value)
+        double marginValue = _marginZero[ii] - _values[ii];
+
+        if (debugEnabled && std::isfinite(_values[ii]))
         {
-            leaderName = in.name;
-            _owner->updateThermalPowerDebugInterface(_id, leaderName, value, 0);
+            std::cerr << "Converting temp to margin: temp " << _values[ii]
+                      << ", Tjmax " << _marginZero[ii] << ", margin "
+                      << marginValue << "\n";
         }
 
-        acceptable = true;
+        _values[ii] = marginValue;
     }
+}
 
-    if (!acceptable)
+// bmc_host_sensor_value_double
+double ThermalController::inputProc(void)
+{
+    gatherInputs();
+
+    return reducedInput(_reduce(_values));
+}
+
+double ThermalController::reducedInput(const Reduction& r)
+{
+    double value = r.value;
+
+    // The first input stands in for the leader if none led.
+    SymbolId leader = _inputs[(r.leader < _inputs.size()) ? r.leader : 0];
+    if (r.leader < _inputs.size())
+    {
+        _owner->updateThermalPowerDebugInterface(_id, symbolName(leader), value,
+                                                 0);
+    }
+
+    if (!r.acceptable)
     {
         // If none of the inputs were acceptable, use the setpoint as
         // the input value. This will continue to run the PID loop, but
         // make it a no-op, as the error will be zero. This provides safe
         // behavior until the inputs become acceptable.
-        value = setptProc();
+        value = ThermalController::setptProc();
     }
 
     if (debugEnabled)
     {
         std::cerr << getID() << " choose the temperature value: " << value
-                  << " " << leaderName << "\n";
+                  << " " << symbolName(leader) << "\n";
     }
 
     return value;
 }
 
+template <ThermalType T>
+void ThermalController::processDirect(void)
+{
+    double setpt = ThermalController::setptProc();
+
+    gatherInputs();
+    double input = reducedInput(reduce<T>(_values));
+
+    ThermalController::outputProc(computeOutput(setpt, input));
+}
+
+template void ThermalController::processDirect<ThermalType::margin>(void);
+template void ThermalController::processDirect<ThermalType::absolute>(void);
+template void ThermalController::processDirect<ThermalType::summation>(void);
+
 // bmc_get_setpt
 double ThermalController::setptProc(void)
 {
@@ -2,8 +2,11 @@
 
 #include "conf.hpp"
 #include "ec/pid.hpp"
+#include "interfaces.hpp"
 #include "pidcontroller.hpp"
+#include "symbols.hpp"
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <vector>
@@ -52,17 +55,51 @@ class ThermalController : public PIDController
 
     ThermalController(const std::string& id,
                       const std::vector<pid_control::conf::SensorInput>& inputs,
-                      const ThermalType& type, ZoneInterface* owner) :
-        PIDController(id, owner), _inputs(inputs), type(type)
-    {}
+                      const ThermalType& type, ZoneInterface* owner);
 
     double inputProc(void) override;
     double setptProc(void) override;
     void outputProc(double value) override;
 
+    ThermalType getType(void) const
+    {
+        return type;
+    }
+
+    /* process() with this class's procs and the reduction for T, which must
+     * be getType(), called directly.
+     */
+    template <ThermalType T>
+    void processDirect(void);
+
   private:
-    std::vector<pid_control::conf::SensorInput> _inputs;
+    /* The result of reducing the input values. */
+    struct Reduction
+    {
+        double value;
+        size_t leader;   // index of the leading input, or the input count
+        bool acceptable; // whether any input was finite
+    };
+
+    template <ThermalType T>
+    static Reduction reduce(const std::vector<double>& values);
+
+    void gatherInputs(void);
+    /* The input for a reduction of the gathered values. */
+    double reducedInput(const Reduction& r);
+
+    std::vector<SymbolId> _inputs;
     ThermalType type;
+
+    /* Chosen for the type at construction. */
+    Reduction (*_reduce)(const std::vector<double>& values);
+
+    /* Per input: the cache entry, found on the first inputProc(); the
+     * TempToMargin zero, NaN if not converted; and the value this cycle.
+     */
+    std::vector<const ValueCacheEntry*> _slots;
+    std::vector<double> _marginZero;
+    std::vector<double> _values;
 };
 
 } // namespace pid_control
@@ -2,32 +2,40 @@
 // SPDX-FileCopyrightText: Copyright 2017 Google Inc
 
 /* Configuration. */
+#include "config.h"
+
 #include "zone.hpp"
 
+#include "clock.hpp"
 #include "conf.hpp"
 #include "failsafeloggers/failsafe_logger_utility.hpp"
 #include "interfaces.hpp"
 #include "pid/controller.hpp"
 #include "pid/tuning.hpp"
+#include "symbols.hpp"
 
 #include <sdbusplus/bus.hpp>
 
 #include <algorithm>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <exception>
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <map>
 #include <memory>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <string_view>
+#include <typeinfo>
 #include <utility>
 #include <vector>
 
-using tstamp = std::chrono::high_resolution_clock::time_point;
+using tstamp = std::chrono::steady_clock::time_point;
 using namespace std::literals::chrono_literals;
 
 // Enforces minimum duration between events
@@ -91,36 +99,47 @@ bool DbusPidZone::getFailSafeMode(void) const
 
 FailSafeSensorsMap DbusPidZone::getFailSafeSensors(void) const
 {
-    return _failSafeSensors;
+    FailSafeSensorsMap sensors;
+    for (const auto& [id, failSafe] : _failSafeSensors)
+    {
+        sensors.emplace(symbolName(id), failSafe);
+    }
+    return sensors;
 }
 
 void DbusPidZone::markSensorMissing(const std::string& name,
                                     const std::string& failReason)
 {
-    if (_missingAcceptable.find(name) != _missingAcceptable.end())
+    markSensorMissing(intern(name), failReason);
+}
+
+void DbusPidZone::markSensorMissing(SymbolId id, const std::string& failReason)
+{
+    if (_missingAcceptable.find(id) != _missingAcceptable.end())
     {
         // Disallow sensors in MissingIsAcceptable list from causing failsafe
-        outputFailsafeLogWithZone(_zoneId, this->getFailSafeMode(), name,
+        outputFailsafeLogWithZone(_zoneId, this->getFailSafeMode(),
+                                  symbolName(id),
                                   "The sensor is missing but is acceptable.");
         return;
     }
 
-    if (_sensorFailSafePercent[name] == 0)
+    if (_sensorFailSafePercent[id] == 0)
     {
-        _failSafeSensors[name] = std::pair(failReason, _zoneFailSafePercent);
+        _failSafeSensors[id] = std::pair(failReason, _zoneFailSafePercent);
     }
     else
     {
-        _failSafeSensors[name] =
-            std::pair(failReason, _sensorFailSafePercent[name]);
+        _failSafeSensors[id] =
+            std::pair(failReason, _sensorFailSafePercent[id]);
     }
 
-    outputFailsafeLogWithZone(_zoneId, this->getFailSafeMode(), name,
+    outputFailsafeLogWithZone(_zoneId, this->getFailSafeMode(), symbolName(id),
                               "The sensor is missing.");
 
     if (debugEnabled)
     {
-        std::cerr << "Sensor " << name << " marked missing\n";
+        std::cerr << "Sensor " << symbolName(id) << " marked missing\n";
     }
 }
 
@@ -190,10 +209,9 @@ double DbusPidZone::getFailSafePercent(void)
         return _zoneFailSafePercent;
     }
 
-    FailSafeSensorsMap::iterator maxData = std::max_element(
+    auto maxData = std::max_element(
         _failSafeSensors.begin(), _failSafeSensors.end(),
-        [](const FailSafeSensorPair& firstData,
-           const FailSafeSensorPair& secondData) {
+        [](const auto& firstData, const auto& secondData) {
             return firstData.second.second < secondData.second.second;
         });
 
@@ -224,39 +242,200 @@ uint64_t DbusPidZone::getUpdateThermalsCycle(void) const
     return _cycleTime.updateThermalsTimeMS;
 }
 
+void ThermalSegments::append(Kind kind, Controller* controller)
+{
+    if (_segments.empty() || _segments.back().kind != kind)
+    {
+        _segments.push_back({kind, {}});
+    }
+    _segments.back().controllers.push_back(controller);
+}
+
+void ThermalSegments::add(Controller* controller)
+{
+    // Only the exact type, a subclass may override its procs.
+    if (typeid(*controller) == typeid(ThermalController))
+    {
+        switch (static_cast<ThermalController*>(controller)->getType())
+        {
+            case ThermalType::margin:
+                append(Kind::margin, controller);
+                return;
+            case ThermalType::absolute:
+                append(Kind::absolute, controller);
+                return;
+            case ThermalType::summation:
+                append(Kind::summation, controller);
+                return;
+        }
+    }
+    else if (typeid(*controller) == typeid(StepwiseController))
+    {
+        auto* step = static_cast<StepwiseController*>(controller);
+        append(step->getStepwiseInfo().isCeiling ? Kind::ceiling
+                                                 : Kind::stepwise,
+               controller);
+        return;
+    }
+
+    append(Kind::other, controller);
+}
+
+void ThermalSegments::addBatched(PIDController* pid)
+{
+    append(Kind::batched, pid);
+}
+
+void ThermalSegments::clear(void)
+{
+    _segments.clear();
+}
+
+template <ThermalType T>
+static void processThermal(const std::vector<Controller*>& controllers)
+{
+    for (auto* p : controllers)
+    {
+        static_cast<ThermalController*>(p)->processDirect<T>();
+    }
+}
+
+template <bool Ceiling>
+static void processStepwise(const std::vector<Controller*>& controllers)
+{
+    for (auto* p : controllers)
+    {
+        static_cast<StepwiseController*>(p)->processDirect<Ceiling>();
+    }
+}
+
+void ThermalSegments::process(std::span<const double> batchInputs,
+                              std::span<const double> batchOutputs)
+{
+    size_t batched = 0;
+
+    for (const auto& segment : _segments)
+    {
+        switch (segment.kind)
+        {
+            case Kind::margin:
+                processThermal<ThermalType::margin>(segment.controllers);
+                break;
+            case Kind::absolute:
+                processThermal<ThermalType::absolute>(segment.controllers);
+                break;
+            case Kind::summation:
+                processThermal<ThermalType::summation>(segment.controllers);
+                break;
+            case Kind::stepwise:
+                processStepwise<false>(segment.controllers);
+                break;
+            case Kind::ceiling:
+                processStepwise<true>(segment.controllers);
+                break;
+            case Kind::batched:
+                for (auto* p : segment.controllers)
+                {
+                    static_cast<PIDController*>(p)->finishBatched(
+                        batchInputs[batched], batchOutputs[batched]);
+                    batched++;
+                }
+                break;
+            case Kind::other:
+                for (auto* p : segment.controllers)
+                {
+                    p->process();
+                }
+                break;
+        }
+    }
+}
+
 void DbusPidZone::addFanPID(std::unique_ptr<Controller> pid)
 {
+    auto* controller = pid.get();
+    if (typeid(*controller) == typeid(FanController))
+    {
+        _fanPids.push_back(static_cast<FanController*>(controller));
+    }
+    else
+    {
+        _otherFans.push_back(controller);
+    }
+
     _fans.push_back(std::move(pid));
 }
 
 void DbusPidZone::addThermalPID(std::unique_ptr<Controller> pid)
 {
+    _thermalSegments.add(pid.get());
     _thermals.push_back(std::move(pid));
+    _thermalBatchBuilt = false;
 }
 
 double DbusPidZone::getCachedValue(const std::string& name)
 {
-    return _cachedValuesByName.at(name).scaled;
+    return getCachedValues(name).scaled;
+}
+
+double DbusPidZone::getCachedValue(SymbolId id)
+{
+    return _cachedValues.at(id).scaled;
+}
+
+const ValueCacheEntry* DbusPidZone::getCachedValueSlot(const std::string& name)
+{
+    auto id = symbols().find(name);
+    return id ? getCachedValueSlot(*id) : nullptr;
+}
+
+const ValueCacheEntry* DbusPidZone::getCachedValueSlot(SymbolId id)
+{
+    auto it = _cachedValues.find(id);
+    return (it != _cachedValues.end()) ? &it->second : nullptr;
 }
 
 ValueCacheEntry DbusPidZone::getCachedValues(const std::string& name)
 {
-    return _cachedValuesByName.at(name);
+    auto id = symbols().find(name);
+    if (!id)
+    {
+        throw std::out_of_range("No cached value for " + name);
+    }
+    return getCachedValues(*id);
+}
+
+ValueCacheEntry DbusPidZone::getCachedValues(SymbolId id)
+{
+    return _cachedValues.at(id);
 }
 
 void DbusPidZone::setOutputCache(std::string_view name,
                                  const ValueCacheEntry& values)
 {
-    _cachedFanOutputs[std::string{name}] = values;
+    _cachedFanOutputs[intern(name)] = values;
+}
+
+ValueCacheEntry* DbusPidZone::getOutputCacheSlot(const std::string& name)
+{
+    auto id = symbols().find(name);
+    return id ? getOutputCacheSlot(*id) : nullptr;
+}
+
+ValueCacheEntry* DbusPidZone::getOutputCacheSlot(SymbolId id)
+{
+    auto it = _cachedFanOutputs.find(id);
+    return (it != _cachedFanOutputs.end()) ? &it->second : nullptr;
 }
 
 void DbusPidZone::addFanInput(const std::string& fan, bool missingAcceptable)
 {
-    _fanInputs.push_back(fan);
+    SymbolId id = intern(fan);
+    _fanInputs.push_back(id);
 
     if (missingAcceptable)
     {
-        _missingAcceptable.emplace(fan);
+        _missingAcceptable.emplace(id);
     }
 }
 
@@ -268,15 +447,16 @@ void DbusPidZone::addThermalInput(const std::string& therm,
      * Searching the sensor name before inserting it to avoid duplicated sensor
      * names.
      */
-    if (std::find(_thermalInputs.begin(), _thermalInputs.end(), therm) ==
+    SymbolId id = intern(therm);
+    if (std::find(_thermalInputs.begin(), _thermalInputs.end(), id) ==
         _thermalInputs.end())
     {
-        _thermalInputs.push_back(therm);
+        _thermalInputs.push_back(id);
     }
 
     if (missingAcceptable)
     {
-        _missingAcceptable.emplace(therm);
+        _missingAcceptable.emplace(id);
     }
 }
 
@@ -321,7 +501,7 @@ static bool fileParseRpm(const std::string& fileName, double& rpmValue)
     // The file is optional, intentionally not an error if file not found
     if (!(errText.empty()))
     {
-        tstamp now = std::chrono::high_resolution_clock::now();
+        tstamp now = std::chrono::steady_clock::now();
         if (allowThrottle(now, throttlePace))
         {
             std::cerr << "Unable to read from '" << fileName << "': " << errText
@@ -393,9 +573,10 @@ void DbusPidZone::determineMaxSetPointRequest(void)
                   << _maximumSetPointName;
         for (const auto& sensor : _failSafeSensors)
         {
-            if (sensor.first.find("Fan") == std::string::npos)
+            const auto& name = symbolName(sensor.first);
+            if (name.find("Fan") == std::string::npos)
             {
-                std::cerr << " " << sensor.first;
+                std::cerr << " " << name;
             }
         }
         std::cerr << "\n";
@@ -430,13 +611,15 @@ void DbusPidZone::initializeLog(void)
 
     _log << "epoch_ms,setpt,requester";
 
-    for (const auto& f : _fanInputs)
+    for (const auto& id : _fanInputs)
     {
+        const auto& f = symbolName(id);
         _log << "," << f << "," << f << "_raw";
         _log << "," << f << "_pwm," << f << "_pwm_raw";
     }
-    for (const auto& t : _thermalInputs)
+    for (const auto& id : _thermalInputs)
     {
+        const auto& t = symbolName(id);
         _log << "," << t << "," << t << "_raw";
     }
 
@@ -468,23 +651,25 @@ void DbusPidZone::updateFanTelemetry(void)
      * is disabled?  I think it's a waste to try and log things even if the
      * data is just being dropped though.
      */
-    const auto now = std::chrono::high_resolution_clock::now();
+    const auto now = clockNow();
     if (loggingEnabled)
     {
+        // The log keeps wall clock timestamps, staleness uses clockNow().
         _log << std::chrono::duration_cast<std::chrono::milliseconds>(
-                    now.time_since_epoch())
+                    std::chrono::system_clock::now().time_since_epoch())
                     .count();
         _log << "," << _maximumSetPoint;
         _log << "," << _maximumSetPointName;
     }
 
-    processSensorInputs</* fanSensorLogging */ true>(_fanInputs, now);
+    processSensorInputs</* fanSensorLogging */ true>(_fanInputs, now,
+                                                     _fanGeneration);
 
     if (loggingEnabled)
     {
         for (const auto& t : _thermalInputs)
         {
-            const auto& v = _cachedValuesByName[t];
+            const auto& v = _cachedValues[t];
             _log << "," << v.scaled << "," << v.unscaled;
         }
     }
@@ -495,7 +680,7 @@ void DbusPidZone::updateFanTelemetry(void)
 void DbusPidZone::updateSensors(void)
 {
     processSensorInputs</* fanSensorLogging */ false>(
-        _thermalInputs, std::chrono::high_resolution_clock::now());
+        _thermalInputs, clockNow(), _thermalGeneration);
 
     return;
 }
@@ -506,7 +691,7 @@ void DbusPidZone::initializeCache(void)
 
     for (const auto& f : _fanInputs)
     {
-        _cachedValuesByName[f] = {nan, nan};
+        _cachedValues[f] = {nan, nan};
         _cachedFanOutputs[f] = {nan, nan};
 
         // Start all fans in fail-safe mode.
@@ -515,7 +700,7 @@ void DbusPidZone::initializeCache(void)
 
     for (const auto& t : _thermalInputs)
     {
-        _cachedValuesByName[t] = {nan, nan};
+        _cachedValues[t] = {nan, nan};
 
         // Start all sensors in fail-safe mode.
         markSensorMissing(t, "");
@@ -525,23 +710,27 @@ void DbusPidZone::initializeCache(void)
 void DbusPidZone::dumpCache(void)
 {
     std::cerr << "Cache values now: \n";
-    for (const auto& [name, value] : _cachedValuesByName)
+    for (const auto& [id, value] : _cachedValues)
     {
-        std::cerr << name << ": " << value.scaled << " " << value.unscaled
-                  << "\n";
+        std::cerr << symbolName(id) << ": " << value.scaled << " "
+                  << value.unscaled << "\n";
     }
 
     std::cerr << "Fan outputs now: \n";
-    for (const auto& [name, value] : _cachedFanOutputs)
+    for (const auto& [id, value] : _cachedFanOutputs)
     {
-        std::cerr << name << ": " << value.scaled << " " << value.unscaled
-                  << "\n";
+        std::cerr << symbolName(id) << ": " << value.scaled << " "
+                  << value.unscaled << "\n";
     }
 }
 
 void DbusPidZone::processFans(void)
 {
-    for (auto& p : _fans)
+    for (auto* p : _fanPids)
+    {
+        p->processDirect();
+    }
+    for (auto* p : _otherFans)
     {
         p->process();
     }
@@ -553,12 +742,102 @@ void DbusPidZone::processFans(void)
     }
 }
 
+void DbusPidZone::buildThermalBatch(void)
+{
+    _thermalBatch.clear();
+    _batchedThermals.clear();
+    _batchSegments.clear();
+
+    for (auto& t : _thermals)
+    {
+        auto* pid = dynamic_cast<PIDController*>(t.get());
+        if (pid && pid->isBatchable())
+        {
+            _thermalBatch.add(*pid->getPIDInfo());
+            _batchedThermals.push_back(pid);
+            _batchSegments.addBatched(pid);
+        }
+        else
+        {
+            _batchSegments.add(t.get());
+        }
+    }
+
+    _batchInputs.resize(_batchedThermals.size());
+    _batchSetpoints.resize(_batchedThermals.size());
+    _batchOutputs.resize(_batchedThermals.size());
+    _thermalBatchBuilt = true;
+}
+
 void DbusPidZone::processThermals(void)
 {
-    for (auto& p : _thermals)
+    // Core logging is done in ec::pid(), which the batch doesn't call.
+    if (!BATCH_PID || coreLoggingEnabled)
     {
-        p->process();
+        _thermalSegments.process();
+        return;
+    }
+
+    if (!_thermalBatchBuilt)
+    {
+        buildThermalBatch();
+    }
+
+    // The state is kept in the controllers, where getState() and setState()
+    // see it, and copied in and out around the batch.  The batch is run
+    // first, and the outputs are finished with the other controllers, in
+    // configuration order.
+    for (size_t i = 0; i < _batchedThermals.size(); i++)
+    {
+        auto* pid = _batchedThermals[i];
+        _batchSetpoints[i] = pid->setptProc();
+        _batchInputs[i] = pid->inputProc();
+        _thermalBatch.loadState(i, *pid->getPIDInfo());
     }
+
+    _thermalBatch.run(_batchInputs, _batchSetpoints, _batchOutputs);
+
+    for (size_t i = 0; i < _batchedThermals.size(); i++)
+    {
+        _thermalBatch.storeState(i, _batchedThermals[i]->getPIDInfo());
+    }
+
+    _batchSegments.process(_batchInputs, _batchOutputs);
+}
+
+std::map<std::string, ControllerState> DbusPidZone::getControllerStates(void)
+{
+    std::map<std::string, ControllerState> states;
+
+    for (const auto* controllers : {&_fans, &_thermals})
+    {
+        for (const auto& p : *controllers)
+        {
+            states[p->getID()] = p->getState();
+        }
+    }
+
+    return states;
+}
+
+size_t DbusPidZone::setControllerStates(
+    const std::map<std::string, ControllerState>& states)
+{
+    size_t restored = 0;
+
+    for (const auto* controllers : {&_fans, &_thermals})
+    {
+        for (const auto& p : *controllers)
+        {
+            auto state = states.find(p->getID());
+            if (state != states.end() && p->setState(state->second))
+            {
+                ++restored;
+            }
+        }
+    }
+
+    return restored;
 }
 
 Sensor* DbusPidZone::getSensor(const std::string& name)
@@ -566,9 +845,24 @@ Sensor* DbusPidZone::getSensor(const std::string& name)
     return _mgr.getSensor(name);
 }
 
+Sensor* DbusPidZone::getSensor(SymbolId id)
+{
+    return _mgr.getSensor(id);
+}
+
+uint64_t DbusPidZone::getSensorsVersion(void) const
+{
+    return _mgr.getVersion();
+}
+
 std::vector<std::string> DbusPidZone::getSensorNames(void)
 {
-    return _thermalInputs;
+    std::vector<std::string> names;
+    for (const auto& id : _thermalInputs)
+    {
+        names.push_back(symbolName(id));
+    }
+    return names;
 }
 
 bool DbusPidZone::getRedundantWrite(void) const
@@ -628,21 +922,21 @@ void DbusPidZone::addPidFailSafePercent(const std::vector<std::string>& inputs,
 {
     for (const auto& sensorName : inputs)
     {
-        if (_sensorFailSafePercent.find(sensorName) !=
-            _sensorFailSafePercent.end())
+        SymbolId id = intern(sensorName);
+        if (_sensorFailSafePercent.find(id) != _sensorFailSafePercent.end())
         {
-            _sensorFailSafePercent[sensorName] =
-                std::max(_sensorFailSafePercent[sensorName], percent);
+            _sensorFailSafePercent[id] =
+                std::max(_sensorFailSafePercent[id], percent);
             if (debugEnabled)
             {
                 std::cerr << "Sensor " << sensorName
                           << " failsafe percent updated to "
-                          << _sensorFailSafePercent[sensorName] << "\n";
+                          << _sensorFailSafePercent[id] << "\n";
             }
         }
         else
         {
-            _sensorFailSafePercent[sensorName] = percent;
+            _sensorFailSafePercent[id] = percent;
             if (debugEnabled)
             {
                 std::cerr << "Sensor " << sensorName
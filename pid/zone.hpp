@@ -2,11 +2,16 @@
 
 #include "conf.hpp"
 #include "controller.hpp"
+#include "ec/pidbatch.hpp"
 #include "failsafeloggers/failsafe_logger_utility.hpp"
+#include "fancontroller.hpp"
 #include "interfaces.hpp"
 #include "pidcontroller.hpp"
 #include "sensors/manager.hpp"
 #include "sensors/sensor.hpp"
+#include "stepwisecontroller.hpp"
+#include "symbols.hpp"
+#include "thermalcontroller.hpp"
 #include "tuning.hpp"
 #include "zone_interface.hpp"
 
@@ -18,12 +23,14 @@
 #include <xyz/openbmc_project/Object/Enable/server.hpp>
 
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <map>
 #include <memory>
 #include <set>
+#include <span>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -43,12 +50,56 @@ using ProcessObject =
     ServerObject<ProcessInterface, DebugThermalPowerInterface>;
 using FailSafeSensorsMap =
     std::map<std::string, std::pair<std::string, double>>;
-using FailSafeSensorPair =
-    std::pair<std::string, std::pair<std::string, double>>;
 
 namespace pid_control
 {
 
+/*
+ * A zone's thermal controllers in the order they were added, split into
+ * segments of consecutive controllers of the same concrete type.  Each
+ * segment is run with its type's procs called directly, and the segments in
+ * order, so the setpoints are added, and ties between them won, in
+ * configuration order.  Controllers of any other type, such as a subclass or
+ * a mock, are run through Controller.
+ */
+class ThermalSegments
+{
+  public:
+    void add(Controller* controller);
+    /* Add a PID whose output the zone's ec::PidBatch computes, the next one
+     * in the batch.
+     */
+    void addBatched(PIDController* pid);
+    void clear(void);
+    /* Run the controllers, finishing the batched ones with the batch's
+     * inputs and outputs.
+     */
+    void process(std::span<const double> batchInputs = {},
+                 std::span<const double> batchOutputs = {});
+
+  private:
+    enum class Kind
+    {
+        margin,
+        absolute,
+        summation,
+        stepwise,
+        ceiling,
+        batched,
+        other
+    };
+
+    struct Segment
+    {
+        Kind kind;
+        std::vector<Controller*> controllers;
+    };
+
+    void append(Kind kind, Controller* controller);
+
+    std::vector<Segment> _segments;
+};
+
 /*
  * The DbusPidZone inherits from the Mode object so that it can listen for
  * control mode changes.  It primarily holds all PID loops and holds the sensor
@@ -84,6 +135,7 @@ class DbusPidZone : public ZoneInterface, public ModeObject
     bool getFailSafeMode(void) const override;
     void markSensorMissing(const std::string& name,
                            const std::string& failReason);
+    void markSensorMissing(SymbolId id, const std::string& failReason);
     bool getAccSetPoint(void) const override;
 
     int64_t getZoneID(void) const override;
@@ -99,21 +151,34 @@ class DbusPidZone : public ZoneInterface, public ModeObject
     uint64_t getUpdateThermalsCycle(void) const override;
 
     Sensor* getSensor(const std::string& name) override;
+    Sensor* getSensor(SymbolId id) override;
+    uint64_t getSensorsVersion(void) const override;
     std::vector<std::string> getSensorNames(void) override;
     void determineMaxSetPointRequest(void) override;
     void updateFanTelemetry(void) override;
     void updateSensors(void) override;
     void initializeCache(void) override;
     void setOutputCache(std::string_view, const ValueCacheEntry&) override;
+    ValueCacheEntry* getOutputCacheSlot(const std::string& name) override;
+    ValueCacheEntry* getOutputCacheSlot(SymbolId id) override;
     void dumpCache(void);
 
     void processFans(void) override;
     void processThermals(void) override;
 
+    std::map<std::string, ControllerState> getControllerStates(void) override;
+    size_t setControllerStates(
+        const std::map<std::string, ControllerState>& states) override;
+
     void addFanPID(std::unique_ptr<Controller> pid);
     void addThermalPID(std::unique_ptr<Controller> pid);
     double getCachedValue(const std::string& name) override;
+    double getCachedValue(SymbolId id) override;
+    const ValueCacheEntry* getCachedValueSlot(
+        const std::string& name) override;
+    const ValueCacheEntry* getCachedValueSlot(SymbolId id) override;
     ValueCacheEntry getCachedValues(const std::string& name) override;
+    ValueCacheEntry getCachedValues(SymbolId id) override;
 
     void addFanInput(const std::string& fan, bool missingAcceptable);
     void addThermalInput(const std::string& therm, bool missingAcceptable);
@@ -141,22 +206,28 @@ class DbusPidZone : public ZoneInterface, public ModeObject
                                           double output) override;
 
   private:
+    void buildThermalBatch(void);
+
+    /*
+     * Read sensorInputs from the manager's read cache, where a sensor shared
+     * with another zone is read and checked once a generation.
+     * lastGeneration is the one the inputs were last read in.
+     */
     template <bool fanSensorLogging>
-    void processSensorInputs(const std::vector<std::string>& sensorInputs,
-                             std::chrono::high_resolution_clock::time_point now)
+    void processSensorInputs(const std::vector<SymbolId>& sensorInputs,
+                             std::chrono::steady_clock::time_point now,
+                             uint64_t& lastGeneration)
     {
+        auto& readCache = _mgr.getReadCache();
+        lastGeneration = readCache.begin(lastGeneration, now);
+
         for (const auto& sensorInput : sensorInputs)
         {
-            auto sensor = _mgr.getSensor(sensorInput);
-            ReadReturn r = sensor->read();
-            _cachedValuesByName[sensorInput] = {r.value, r.unscaled};
-            int64_t timeout = sensor->getTimeout();
-            std::chrono::high_resolution_clock::time_point then = r.updated;
-
-            auto duration =
-                std::chrono::duration_cast<std::chrono::seconds>(now - then)
-                    .count();
-            auto period = std::chrono::seconds(timeout).count();
+            const SensorReading& reading =
+                readCache.read(sensorInput, _mgr.getSensor(sensorInput),
+                               lastGeneration, now);
+            const ReadReturn& r = reading.read;
+            _cachedValues[sensorInput] = {r.value, r.unscaled};
             /*
              * TODO(venture): We should check when these were last read.
              * However, these are the fans, so if I'm not getting updated values
@@ -166,7 +237,7 @@ class DbusPidZone : public ZoneInterface, public ModeObject
             {
                 if (loggingEnabled)
                 {
-                    const auto& v = _cachedValuesByName[sensorInput];
+                    const auto& v = _cachedValues[sensorInput];
                     _log << "," << v.scaled << "," << v.unscaled;
                     const auto& p = _cachedFanOutputs[sensorInput];
                     _log << "," << p.scaled << "," << p.unscaled;
@@ -175,30 +246,31 @@ class DbusPidZone : public ZoneInterface, public ModeObject
 
             if (debugEnabled)
             {
-                std::cerr << sensorInput << " sensor reading: " << r.value
-                          << "\n";
+                std::cerr << symbolName(sensorInput)
+                          << " sensor reading: " << r.value << "\n";
             }
 
             // check if fan fail.
-            if (sensor->getFailed())
+            if (reading.failed)
             {
-                markSensorMissing(sensorInput, sensor->getFailReason());
+                markSensorMissing(sensorInput, reading.failReason);
 
                 if (debugEnabled)
                 {
-                    std::cerr << sensorInput << " sensor get failed\n";
+                    std::cerr << symbolName(sensorInput)
+                              << " sensor get failed\n";
                 }
             }
-            else if (timeout != 0 && duration >= period)
+            else if (reading.timedOut)
             {
                 markSensorMissing(sensorInput, "Sensor timeout");
 
                 if (debugEnabled)
                 {
-                    std::cerr << sensorInput << " sensor timeout\n";
+                    std::cerr << symbolName(sensorInput) << " sensor timeout\n";
                 }
                 outputFailsafeLogWithZone(_zoneId, this->getFailSafeMode(),
-                                          sensorInput,
+                                          symbolName(sensorInput),
                                           "The sensor has timed out.");
             }
             else
@@ -209,13 +281,13 @@ class DbusPidZone : public ZoneInterface, public ModeObject
                 {
                     if (debugEnabled)
                     {
-                        std::cerr << sensorInput
+                        std::cerr << symbolName(sensorInput)
                                   << " is erased from failsafe sensor set\n";
                     }
 
                     _failSafeSensors.erase(kt);
                     outputFailsafeLogWithZone(_zoneId, this->getFailSafeMode(),
-                                              sensorInput,
+                                              symbolName(sensorInput),
                                               "The sensor has recovered.");
                 }
             }
@@ -237,28 +309,50 @@ class DbusPidZone : public ZoneInterface, public ModeObject
     const conf::CycleTime _cycleTime;
 
     /*
-     * <map key = sensor name, value = sensor fail reason and failsafe percent>
+     * <map key = sensor, value = sensor fail reason and failsafe percent>
      */
-    FailSafeSensorsMap _failSafeSensors;
-    std::set<std::string> _missingAcceptable;
+    std::map<SymbolId, std::pair<std::string, double>> _failSafeSensors;
+    std::set<SymbolId> _missingAcceptable;
 
     std::map<std::string, double> setPoints;
     std::vector<double> rpmCeilings;
-    std::vector<std::string> _fanInputs;
-    std::vector<std::string> _thermalInputs;
-    std::map<std::string, ValueCacheEntry> _cachedValuesByName;
-    std::map<std::string, ValueCacheEntry> _cachedFanOutputs;
+    std::vector<SymbolId> _fanInputs;
+    std::vector<SymbolId> _thermalInputs;
+    std::map<SymbolId, ValueCacheEntry> _cachedValues;
+    std::map<SymbolId, ValueCacheEntry> _cachedFanOutputs;
+    /* The read cache generations the inputs were last read in. */
+    uint64_t _fanGeneration = 0;
+    uint64_t _thermalGeneration = 0;
     const SensorManager& _mgr;
 
     std::vector<std::unique_ptr<Controller>> _fans;
     std::vector<std::unique_ptr<Controller>> _thermals;
 
+    /* The controllers above, segmented as they're added. */
+    std::vector<FanController*> _fanPids;
+    std::vector<Controller*> _otherFans;
+    ThermalSegments _thermalSegments;
+
+    /*
+     * With batch-pid, the thermal PIDs that can be batched run in
+     * _thermalBatch, and the rest on their own.  _batchSegments has them all
+     * in order, to finish the batched ones and run the rest.  Built on the
+     * first cycle.
+     */
+    bool _thermalBatchBuilt = false;
+    ec::PidBatch _thermalBatch;
+    std::vector<PIDController*> _batchedThermals;
+    ThermalSegments _batchSegments;
+    std::vector<double> _batchInputs;
+    std::vector<double> _batchSetpoints;
+    std::vector<double> _batchOutputs;
+
     std::map<std::string, std::unique_ptr<ProcessObject>> _pidsControlProcess;
     /*
-     * <key = sensor name, value = sensor failsafe percent>
+     * <key = sensor, value = sensor failsafe percent>
      * sensor fail safe Percent setting by each pid controller configuration.
      */
-    std::map<std::string, double> _sensorFailSafePercent;
+    std::map<SymbolId, double> _sensorFailSafePercent;
 };
 
 } // namespace pid_control
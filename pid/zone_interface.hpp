@@ -1,8 +1,11 @@
 #pragma once
 
 #include "interfaces.hpp"
+#include "pid/controller.hpp"
 #include "sensors/sensor.hpp"
+#include "symbols.hpp"
 
+#include <cstddef>
 #include <cstdint>
 #include <map>
 #include <string>
@@ -33,6 +36,20 @@ class ZoneInterface
     /** Return a pointer to the sensor specified by name. */
     virtual Sensor* getSensor(const std::string& name) = 0;
 
+    /* The lookups by name also take the name's SymbolId, which controllers
+     * keep instead of the name.  By default they look up the name, zones
+     * that key on ids override them.
+     */
+    virtual Sensor* getSensor(SymbolId id)
+    {
+        return getSensor(symbolName(id));
+    }
+
+    /** Changes whenever a sensor is added or replaced, after which sensors
+     * from getSensor() must be looked up again.
+     */
+    virtual uint64_t getSensorsVersion(void) const = 0;
+
     /** Return the list of sensor names in the zone. */
     virtual std::vector<std::string> getSensorNames(void) = 0;
 
@@ -63,14 +80,60 @@ class ZoneInterface
     virtual void setOutputCache(std::string_view name,
                                 const ValueCacheEntry& values) = 0;
 
+    /** Return the output cache entry for name, which stays put like those
+     * from getCachedValueSlot(), or nullptr if there's none.
+     */
+    virtual ValueCacheEntry* getOutputCacheSlot(const std::string& name) = 0;
+    virtual ValueCacheEntry* getOutputCacheSlot(SymbolId id)
+    {
+        return getOutputCacheSlot(symbolName(id));
+    }
+
     /** Return cached value for sensor by name. */
     virtual double getCachedValue(const std::string& name) = 0;
+    virtual double getCachedValue(SymbolId id)
+    {
+        return getCachedValue(symbolName(id));
+    }
+    /** Return the cache entry for sensor by name, which stays put for the
+     * life of the zone once the cache is initialized, or nullptr if there's
+     * none.  Lets controllers skip the lookup by name each cycle.
+     */
+    virtual const ValueCacheEntry* getCachedValueSlot(
+        const std::string& name) = 0;
+    virtual const ValueCacheEntry* getCachedValueSlot(SymbolId id)
+    {
+        return getCachedValueSlot(symbolName(id));
+    }
+    /** Fill slots with the cache entry of each of ids, on a controller's
+     * first cycle; later calls leave them be.  The zone's cache entries
+     * don't move once it's initialized, which it is before any controller
+     * runs.
+     */
+    void resolveCachedValueSlots(const std::vector<SymbolId>& ids,
+                                 std::vector<const ValueCacheEntry*>& slots)
+    {
+        if (!slots.empty())
+        {
+            return;
+        }
+
+        slots.reserve(ids.size());
+        for (const auto& id : ids)
+        {
+            slots.push_back(getCachedValueSlot(id));
+        }
+    }
     /** Return cached values, both scaled and original unscaled values,
      * for sensor by name. Subclasses can add trivial return {value, value},
      * for subclasses that only implement getCachedValue() and do not care
      * about maintaining the distinction between scaled and unscaled values.
      */
     virtual ValueCacheEntry getCachedValues(const std::string& name) = 0;
+    virtual ValueCacheEntry getCachedValues(SymbolId id)
+    {
+        return getCachedValues(symbolName(id));
+    }
 
     /** Add a set point value for the Max Set Point computation. */
     virtual void addSetPoint(double setpoint, const std::string& name) = 0;
@@ -127,6 +190,17 @@ class ZoneInterface
     /** For each thermal pid, do processing. */
     virtual void processThermals(void) = 0;
 
+    /** Return the state of each controller by ID, to carry over when the
+     * zone is rebuilt.
+     */
+    virtual std::map<std::string, ControllerState> getControllerStates(
+        void) = 0;
+    /** Restore the controllers found in states, returns how many were
+     * restored.
+     */
+    virtual size_t setControllerStates(
+        const std::map<std::string, ControllerState>& states) = 0;
+
     /** Update thermal/power debug dbus properties */
     virtual void updateThermalPowerDebugInterface(
         std::string pidName, std::string leader, double input,
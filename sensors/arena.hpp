@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace pid_control
+{
+
+/*
+ * Deletes an object made by makeInArena() back into its memory resource.
+ * One made from a std::default_delete, as when a std::unique_ptr from
+ * std::make_unique is handed over, has no resource and uses delete, so
+ * sensors and interfaces can come from either.
+ */
+class ArenaDelete
+{
+  public:
+    ArenaDelete() = default;
+
+    template <typename U>
+    ArenaDelete(const std::default_delete<U>&)
+    {}
+
+    ArenaDelete(std::pmr::memory_resource* resource, size_t size,
+                size_t align) : _resource(resource), _size(size), _align(align)
+    {}
+
+    template <typename T>
+    void operator()(T* object) const
+    {
+        if (!_resource)
+        {
+            delete object;
+            return;
+        }
+
+        // The allocation is at the start of the most derived object, which
+        // a base class pointer may not be.
+        void* start = object;
+        if constexpr (std::is_polymorphic_v<T>)
+        {
+            start = dynamic_cast<void*>(object);
+        }
+
+        object->~T();
+        _resource->deallocate(start, _size, _align);
+    }
+
+  private:
+    std::pmr::memory_resource* _resource = nullptr;
+    size_t _size = 0;
+    size_t _align = 0;
+};
+
+/* An owning pointer to a sensor or interface, from an arena or the heap. */
+template <typename T>
+using SensorPtr = std::unique_ptr<T, ArenaDelete>;
+
+/*
+ * Construct a T in memory from resource, which must outlive it.
+ */
+template <typename T, typename... Args>
+SensorPtr<T> makeInArena(std::pmr::memory_resource* resource, Args&&... args)
+{
+    void* memory = resource->allocate(sizeof(T), alignof(T));
+
+    T* object;
+    try
+    {
+        object = new (memory) T(std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        resource->deallocate(memory, sizeof(T), alignof(T));
+        throw;
+    }
+
+    return SensorPtr<T>(object, ArenaDelete(resource, sizeof(T), alignof(T)));
+}
+
+} // namespace pid_control
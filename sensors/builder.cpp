@@ -9,6 +9,7 @@
 
 /* Configuration. */
 #include "conf.hpp"
+#include "config.h"
 #include "dbus/dbushelper.hpp"
 #include "dbus/dbuspassive.hpp"
 #include "dbus/dbuswrite.hpp"
@@ -17,11 +18,13 @@
 #include "interfaces.hpp"
 #include "notimpl/readonly.hpp"
 #include "notimpl/writeonly.hpp"
+#include "sensors/arena.hpp"
 #include "sensors/build_utils.hpp"
 #include "sensors/builder.hpp"
 #include "sensors/host.hpp"
 #include "sensors/manager.hpp"
 #include "sensors/pluggable.hpp"
+#include "sensors/variant.hpp"
 #include "sysfs/sysfsread.hpp"
 #include "sysfs/sysfswrite.hpp"
 
@@ -37,151 +40,268 @@ SensorManager buildSensors(
     sdbusplus::bus_t& passive, sdbusplus::bus_t& host)
 {
     SensorManager mgmr{passive, host};
-    auto& hostSensorBus = mgmr.getHostBus();
-    auto& passiveListeningBus = mgmr.getPassiveBus();
+    buildSensors(config, mgmr);
+    return mgmr;
+}
 
+void buildSensors(const std::map<std::string, conf::SensorConfig>& config,
+                  SensorManager& mgmr)
+{
     for (const auto& it : config)
     {
-        std::unique_ptr<ReadInterface> ri;
-        std::unique_ptr<WriteInterface> wi;
+        buildSensor(it.first, it.second, mgmr);
+    }
+}
 
-        std::string name = it.first;
-        const conf::SensorConfig* info = &it.second;
+static std::unique_ptr<DbusPassive> buildDbusPassive(
+    const std::string& name, const conf::SensorConfig* info,
+    sdbusplus::bus_t& passiveListeningBus)
+{
+    // we only need to make one match based on the dbus object
+    static std::shared_ptr<DbusPassiveRedundancy> redundancy =
+        std::make_shared<DbusPassiveRedundancy>(passiveListeningBus);
 
-        std::cerr << "Sensor: " << name << " " << info->type << " ";
-        std::cerr << info->readPath << " " << info->writePath << "\n";
+    std::unique_ptr<DbusPassive> ri;
+    if (info->type == "fan")
+    {
+        ri = DbusPassive::createDbusPassive(
+            passiveListeningBus, info->type, name,
+            std::make_unique<DbusHelper>(passiveListeningBus), info,
+            redundancy);
+    }
+    else
+    {
+        ri = DbusPassive::createDbusPassive(
+            passiveListeningBus, info->type, name,
+            std::make_unique<DbusHelper>(passiveListeningBus), info, nullptr);
+    }
+    if (ri == nullptr)
+    {
+        throw SensorBuildException("Failed to create dbus passive sensor: " +
+                                   name + " of type: " + info->type);
+    }
+
+    return ri;
+}
+
+static bool isReadOnlyType(const std::string& type)
+{
+    return type == "temp" || type == "margin" || type == "power" ||
+           type == "powersum";
+}
 
-        IOInterfaceType rtype = getReadInterfaceType(info->readPath);
-        IOInterfaceType wtype = getWriteInterfaceType(info->writePath);
+/*
+ * Build a sensor that would be a PluggableSensor as a VariantSensor
+ * instead.  Returns false for those it can't be, the host sensors and fans
+ * read externally, to be built as usual.
+ */
+static bool buildVariantSensor(const std::string& name,
+                               const conf::SensorConfig* info,
+                               IOInterfaceType rtype, IOInterfaceType wtype,
+                               SensorManager& mgmr)
+{
+    if (rtype == IOInterfaceType::EXTERNAL ||
+        (info->type != "fan" && !isReadOnlyType(info->type)))
+    {
+        return false;
+    }
 
-        // fan sensors can be ready any way and written others.
-        // fan sensors are the only sensors this is designed to write.
-        // Nothing here should be write-only, although, in theory a fan could
-        // be. I'm just not sure how that would fit together.
-        // TODO(venture): It should check with the ObjectMapper to check if
-        // that sensor exists on the Dbus.
+    auto& passiveListeningBus = mgmr.getPassiveBus();
+
+    auto reader = [&]() -> SensorReader {
         switch (rtype)
         {
             case IOInterfaceType::DBUSPASSIVE:
-                // we only need to make one match based on the dbus object
-                static std::shared_ptr<DbusPassiveRedundancy> redundancy =
-                    std::make_shared<DbusPassiveRedundancy>(
-                        passiveListeningBus);
+                return buildDbusPassive(name, info, passiveListeningBus);
+            case IOInterfaceType::SYSFS:
+                return SensorReader(std::in_place_type<SysFsRead>,
+                                    info->readPath);
+            default:
+                return SensorReader(std::in_place_type<WriteOnly>);
+        }
+    }();
+
+    auto writer = [&]() -> SensorWriter {
+        if (info->type != "fan")
+        {
+            return SensorWriter(std::in_place_type<ReadOnlyNoExcept>);
+        }
+
+        switch (wtype)
+        {
+            case IOInterfaceType::SYSFS:
+                if (info->max > 0)
+                {
+                    return SensorWriter(std::in_place_type<SysFsWritePercent>,
+                                        info->writePath, info->min, info->max);
+                }
+                return SensorWriter(std::in_place_type<SysFsWrite>,
+                                    info->writePath, info->min, info->max);
+            case IOInterfaceType::DBUSACTIVE:
+                if (info->max > 0)
+                {
+                    auto wi = DbusWritePercent::createDbusWrite(
+                        info->writePath, info->min, info->max,
+                        std::make_unique<DbusHelper>(passiveListeningBus));
+                    if (wi)
+                    {
+                        return SensorWriter(std::move(*wi));
+                    }
+                }
+                else
+                {
+                    auto wi = DbusWrite::createDbusWrite(
+                        info->writePath, info->min, info->max,
+                        std::make_unique<DbusHelper>(passiveListeningBus));
+                    if (wi)
+                    {
+                        return SensorWriter(std::move(*wi));
+                    }
+                }
+
+                throw SensorBuildException(
+                    "Unable to create write dbus interface for path: " +
+                    info->writePath);
+            default:
+                return SensorWriter(std::in_place_type<ReadOnlyNoExcept>);
+        }
+    }();
+
+    auto sensor = mgmr.make<VariantSensor>(
+        name, info->timeoutMs, std::move(reader), std::move(writer),
+        info->ignoreFailIfHostOff, info->filters);
+    mgmr.addSensor(info->type, name, std::move(sensor));
+
+    return true;
+}
 
-                if (info->type == "fan")
+void buildSensor(const std::string& name, const conf::SensorConfig& config,
+                 SensorManager& mgmr)
+{
+    auto& hostSensorBus = mgmr.getHostBus();
+    auto& passiveListeningBus = mgmr.getPassiveBus();
+
+    // Sensors and the interfaces built here come from the manager's arena,
+    // those from the D-Bus factories from the heap.
+    SensorPtr<ReadInterface> ri;
+    SensorPtr<WriteInterface> wi;
+
+    const conf::SensorConfig* info = &config;
+
+    std::cerr << "Sensor: " << name << " " << info->type << " ";
+    std::cerr << info->readPath << " " << info->writePath << "\n";
+
+    IOInterfaceType rtype = getReadInterfaceType(info->readPath);
+    IOInterfaceType wtype = getWriteInterfaceType(info->writePath);
+
+    if constexpr (VARIANT_SENSORS)
+    {
+        if (buildVariantSensor(name, info, rtype, wtype, mgmr))
+        {
+            return;
+        }
+    }
+
+    // fan sensors can be ready any way and written others.
+    // fan sensors are the only sensors this is designed to write.
+    // Nothing here should be write-only, although, in theory a fan could
+    // be. I'm just not sure how that would fit together.
+    // TODO(venture): It should check with the ObjectMapper to check if
+    // that sensor exists on the Dbus.
+    switch (rtype)
+    {
+        case IOInterfaceType::DBUSPASSIVE:
+            ri = buildDbusPassive(name, info, passiveListeningBus);
+            break;
+        case IOInterfaceType::EXTERNAL:
+            // These are a special case for read-only.
+            break;
+        case IOInterfaceType::SYSFS:
+            ri = mgmr.make<SysFsRead>(info->readPath);
+            break;
+        default:
+            ri = mgmr.make<WriteOnly>();
+            break;
+    }
+
+    if (info->type == "fan")
+    {
+        switch (wtype)
+        {
+            case IOInterfaceType::SYSFS:
+                if (info->max > 0)
+                {
+                    wi = mgmr.make<SysFsWritePercent>(info->writePath,
+                                                      info->min, info->max);
+                }
+                else
+                {
+                    wi = mgmr.make<SysFsWrite>(info->writePath, info->min,
+                                               info->max);
+                }
+
+                break;
+            case IOInterfaceType::DBUSACTIVE:
+                if (info->max > 0)
                 {
-                    ri = DbusPassive::createDbusPassive(
-                        passiveListeningBus, info->type, name,
-                        std::make_unique<DbusHelper>(passiveListeningBus), info,
-                        redundancy);
+                    wi = DbusWritePercent::createDbusWrite(
+                        info->writePath, info->min, info->max,
+                        std::make_unique<DbusHelper>(passiveListeningBus));
                 }
                 else
                 {
-                    ri = DbusPassive::createDbusPassive(
-                        passiveListeningBus, info->type, name,
-                        std::make_unique<DbusHelper>(passiveListeningBus), info,
-                        nullptr);
+                    wi = DbusWrite::createDbusWrite(
+                        info->writePath, info->min, info->max,
+                        std::make_unique<DbusHelper>(passiveListeningBus));
                 }
-                if (ri == nullptr)
+
+                if (wi == nullptr)
                 {
                     throw SensorBuildException(
-                        "Failed to create dbus passive sensor: " + name +
-                        " of type: " + info->type);
+                        "Unable to create write dbus interface for path: " +
+                        info->writePath);
                 }
-                break;
-            case IOInterfaceType::EXTERNAL:
-                // These are a special case for read-only.
-                break;
-            case IOInterfaceType::SYSFS:
-                ri = std::make_unique<SysFsRead>(info->readPath);
+
                 break;
             default:
-                ri = std::make_unique<WriteOnly>();
+                wi = mgmr.make<ReadOnlyNoExcept>();
                 break;
         }
 
-        if (info->type == "fan")
-        {
-            switch (wtype)
-            {
-                case IOInterfaceType::SYSFS:
-                    if (info->max > 0)
-                    {
-                        wi = std::make_unique<SysFsWritePercent>(
-                            info->writePath, info->min, info->max);
-                    }
-                    else
-                    {
-                        wi = std::make_unique<SysFsWrite>(info->writePath,
-                                                          info->min, info->max);
-                    }
-
-                    break;
-                case IOInterfaceType::DBUSACTIVE:
-                    if (info->max > 0)
-                    {
-                        wi = DbusWritePercent::createDbusWrite(
-                            info->writePath, info->min, info->max,
-                            std::make_unique<DbusHelper>(passiveListeningBus));
-                    }
-                    else
-                    {
-                        wi = DbusWrite::createDbusWrite(
-                            info->writePath, info->min, info->max,
-                            std::make_unique<DbusHelper>(passiveListeningBus));
-                    }
-
-                    if (wi == nullptr)
-                    {
-                        throw SensorBuildException(
-                            "Unable to create write dbus interface for path: " +
-                            info->writePath);
-                    }
+        auto sensor = mgmr.make<PluggableSensor>(
+            name, info->timeoutMs, std::move(ri), std::move(wi),
+            info->ignoreFailIfHostOff, info->filters);
+        mgmr.addSensor(info->type, name, std::move(sensor));
+    }
+    else if (isReadOnlyType(info->type))
+    {
+        // These sensors are read-only, but only for this application
+        // which only writes to fan sensors.
+        std::cerr << info->type << " readPath: " << info->readPath << "\n";
 
-                    break;
-                default:
-                    wi = std::make_unique<ReadOnlyNoExcept>();
-                    break;
-            }
+        if (IOInterfaceType::EXTERNAL == rtype)
+        {
+            std::cerr << "Creating HostSensor: " << name
+                      << " path: " << info->readPath << "\n";
 
-            auto sensor = std::make_unique<PluggableSensor>(
-                name, info->timeout, std::move(ri), std::move(wi),
-                info->ignoreFailIfHostOff);
+            /*
+             * The reason we handle this as a HostSensor is because it's
+             * not quite pluggable; but maybe it could be.
+             */
+            auto sensor = HostSensor::createTemp(
+                name, info->timeoutMs, hostSensorBus, info->readPath.c_str(),
+                deferSignals);
             mgmr.addSensor(info->type, name, std::move(sensor));
         }
-        else if (info->type == "temp" || info->type == "margin" ||
-                 info->type == "power" || info->type == "powersum")
+        else
         {
-            // These sensors are read-only, but only for this application
-            // which only writes to fan sensors.
-            std::cerr << info->type << " readPath: " << info->readPath << "\n";
-
-            if (IOInterfaceType::EXTERNAL == rtype)
-            {
-                std::cerr << "Creating HostSensor: " << name
-                          << " path: " << info->readPath << "\n";
-
-                /*
-                 * The reason we handle this as a HostSensor is because it's
-                 * not quite pluggable; but maybe it could be.
-                 */
-                auto sensor = HostSensor::createTemp(
-                    name, info->timeout, hostSensorBus, info->readPath.c_str(),
-                    deferSignals);
-                mgmr.addSensor(info->type, name, std::move(sensor));
-            }
-            else
-            {
-                wi = std::make_unique<ReadOnlyNoExcept>();
-                auto sensor = std::make_unique<PluggableSensor>(
-                    name, info->timeout, std::move(ri), std::move(wi),
-                    info->ignoreFailIfHostOff);
-                mgmr.addSensor(info->type, name, std::move(sensor));
-            }
+            wi = mgmr.make<ReadOnlyNoExcept>();
+            auto sensor = mgmr.make<PluggableSensor>(
+                name, info->timeoutMs, std::move(ri), std::move(wi),
+                info->ignoreFailIfHostOff, info->filters);
+            mgmr.addSensor(info->type, name, std::move(sensor));
         }
     }
-
-    return mgmr;
 }
 
 } // namespace pid_control
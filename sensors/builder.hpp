@@ -18,4 +18,21 @@ SensorManager buildSensors(
     const std::map<std::string, conf::SensorConfig>& config,
     sdbusplus::bus_t& passive, sdbusplus::bus_t& host);
 
+/**
+ * Build the sensors and add them to an existing SensorManager, which replaces
+ * any sensor already there with the same name.
+ */
+void buildSensors(const std::map<std::string, conf::SensorConfig>& config,
+                  SensorManager& mgmr);
+
+/**
+ * Build one sensor and add it to an existing SensorManager, which replaces
+ * any sensor already there with the same name.  If the sensor can't be built
+ * the SensorManager is left as it was.
+ *
+ * @throw SensorBuildException if the sensor can't be built.
+ */
+void buildSensor(const std::string& name, const conf::SensorConfig& config,
+                 SensorManager& mgmr);
+
 } // namespace pid_control
@@ -8,6 +8,7 @@
 
 #include <nlohmann/json.hpp>
 
+#include <cstdint>
 #include <cstdio>
 #include <map>
 
@@ -17,6 +18,37 @@ namespace pid_control
 {
 namespace conf
 {
+void from_json(const json& j, conf::SensorFilterConfig& f)
+{
+    j.at("type").get_to(f.type);
+
+    /* Each type only reads its own parameters, an unknown type is rejected
+     * when the sensor is built.
+     */
+    if (f.type == "ema")
+    {
+        j.at("alpha").get_to(f.alpha);
+    }
+    else if (f.type == "median")
+    {
+        j.at("window").get_to(f.window);
+    }
+    else if (f.type == "rateLimit")
+    {
+        j.at("maxRate").get_to(f.maxRate);
+    }
+    else if (f.type == "spike")
+    {
+        j.at("threshold").get_to(f.threshold);
+
+        auto maxRejects = j.find("maxRejects");
+        if (maxRejects != j.end())
+        {
+            maxRejects->get_to(f.maxRejects);
+        }
+    }
+}
+
 void from_json(const json& j, conf::SensorConfig& s)
 {
     j.at("type").get_to(s.type);
@@ -88,15 +120,32 @@ void from_json(const json& j, conf::SensorConfig& s)
         }
     }
 
-    /* The timeout field is optional in a configuration. */
+    /* The timeout fields are optional in a configuration.  timeout is in
+     * seconds, timeout_ms is in milliseconds and wins if both are given.
+     */
+    auto timeoutMs = j.find("timeout_ms");
     auto timeout = j.find("timeout");
-    if (timeout == j.end())
+    if (timeoutMs != j.end())
     {
-        s.timeout = Sensor::getDefaultTimeout(s.type);
+        timeoutMs->get_to(s.timeoutMs);
+    }
+    else if (timeout != j.end())
+    {
+        int64_t seconds;
+        timeout->get_to(seconds);
+        s.timeoutMs = seconds * 1000;
     }
     else
     {
-        j.at("timeout").get_to(s.timeout);
+        s.timeoutMs = Sensor::getDefaultTimeout(s.type);
+    }
+
+    /* The filters field is optional in a configuration. */
+    s.filters.clear();
+    auto filters = j.find("filters");
+    if (filters != j.end())
+    {
+        filters->get_to(s.filters);
     }
 }
 } // namespace conf
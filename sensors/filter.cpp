@@ -0,0 +1,257 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright 2026 Google Inc
+
+#include "filter.hpp"
+
+#include "conf.hpp"
+#include "errors/exception.hpp"
+#include "interfaces.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pid_control
+{
+
+double EmaFilter::apply(
+    double value, [[maybe_unused]] std::chrono::steady_clock::time_point updated)
+{
+    if (!_primed)
+    {
+        _average = value;
+        _primed = true;
+        return _average;
+    }
+
+    _average += _alpha * (value - _average);
+    return _average;
+}
+
+double MedianFilter::apply(
+    double value, [[maybe_unused]] std::chrono::steady_clock::time_point updated)
+{
+    _samples[_next] = value;
+    _next = (_next + 1) % _window;
+    _count = std::min(_count + 1, _window);
+
+    std::copy_n(_samples.begin(), _count, _scratch.begin());
+
+    auto begin = _scratch.begin();
+    auto end = begin + _count;
+    auto middle = begin + _count / 2;
+    std::nth_element(begin, middle, end);
+    if (_count % 2)
+    {
+        return *middle;
+    }
+
+    // With an even count, average the two middle samples.
+    double lower = *std::max_element(begin, middle);
+    return (lower + *middle) / 2.0;
+}
+
+double RateLimitFilter::apply(double value,
+                              std::chrono::steady_clock::time_point updated)
+{
+    if (!_primed)
+    {
+        _output = value;
+        _updated = updated;
+        _primed = true;
+        return _output;
+    }
+
+    std::chrono::duration<double> elapsed = updated - _updated;
+    _updated = updated;
+
+    double step = _maxRate * std::max(elapsed.count(), 0.0);
+    _output += std::clamp(value - _output, -step, step);
+    return _output;
+}
+
+double SpikeFilter::apply(
+    double value, [[maybe_unused]] std::chrono::steady_clock::time_point updated)
+{
+    if (_primed && std::abs(value - _accepted) > _threshold &&
+        _rejects < _maxRejects)
+    {
+        ++_rejects;
+        return _accepted;
+    }
+
+    _accepted = value;
+    _rejects = 0;
+    _primed = true;
+    return _accepted;
+}
+
+static std::unique_ptr<SensorFilter> buildFilter(
+    const conf::SensorFilterConfig& config)
+{
+    if (config.type == "ema")
+    {
+        if (!(config.alpha > 0.0 && config.alpha <= 1.0))
+        {
+            throw SensorBuildException("ema filter alpha must be in (0, 1]");
+        }
+        return std::make_unique<EmaFilter>(config.alpha);
+    }
+    if (config.type == "median")
+    {
+        if (config.window < 1 || config.window > maxFilterWindow)
+        {
+            throw SensorBuildException(
+                "median filter window must be in [1, " +
+                std::to_string(maxFilterWindow) + "]");
+        }
+        return std::make_unique<MedianFilter>(config.window);
+    }
+    if (config.type == "rateLimit")
+    {
+        if (!(config.maxRate > 0.0))
+        {
+            throw SensorBuildException(
+                "rateLimit filter maxRate must be positive");
+        }
+        return std::make_unique<RateLimitFilter>(config.maxRate);
+    }
+    if (config.type == "spike")
+    {
+        if (!(config.threshold > 0.0))
+        {
+            throw SensorBuildException(
+                "spike filter threshold must be positive");
+        }
+        if (config.maxRejects == 0)
+        {
+            throw SensorBuildException(
+                "spike filter maxRejects must be positive");
+        }
+        return std::make_unique<SpikeFilter>(config.threshold,
+                                             config.maxRejects);
+    }
+
+    throw SensorBuildException("unknown sensor filter type: " + config.type);
+}
+
+SensorFilterChain::SensorFilterChain(
+    const std::vector<conf::SensorFilterConfig>& config)
+{
+    for (const auto& stage : config)
+    {
+        _stages.push_back(buildFilter(stage));
+    }
+}
+
+double SensorFilterChain::apply(double value,
+                                std::chrono::steady_clock::time_point updated)
+{
+    if (!std::isfinite(value))
+    {
+        return value;
+    }
+
+    for (const auto& stage : _stages)
+    {
+        value = stage->apply(value, updated);
+    }
+
+    return value;
+}
+
+ReadReturn ReadingFilter::apply(const ReadReturn& r,
+                                const ReadInterface& reader)
+{
+    if (!_filteredAny || r.updated != _filtered.updated)
+    {
+        _filteredAny = true;
+        _filtered.updated = r.updated;
+        _filtered.unscaled = _chain.apply(r.unscaled, r.updated);
+        // A failed reading is passed through as it was read.
+        _filtered.value = std::isfinite(r.unscaled)
+                              ? reader.scale(_filtered.unscaled)
+                              : r.value;
+    }
+
+    return _filtered;
+}
+
+/* A count field of a filter spec, which stoul() would let wrap. */
+static uint32_t parseCount(const std::string& field)
+{
+    unsigned long value = std::stoul(field);
+    if (field.find('-') != std::string::npos ||
+        value > std::numeric_limits<uint32_t>::max())
+    {
+        throw std::out_of_range("count out of range");
+    }
+    return value;
+}
+
+conf::SensorFilterConfig parseSensorFilter(std::string_view spec)
+{
+    std::vector<std::string> fields;
+    size_t start = 0;
+    while (true)
+    {
+        size_t end = spec.find(':', start);
+        fields.emplace_back(spec.substr(start, end - start));
+        if (end == std::string_view::npos)
+        {
+            break;
+        }
+        start = end + 1;
+    }
+
+    conf::SensorFilterConfig config;
+    config.type = fields[0];
+
+    try
+    {
+        if (config.type == "ema" && fields.size() == 2)
+        {
+            config.alpha = std::stod(fields[1]);
+            return config;
+        }
+        if (config.type == "median" && fields.size() == 2)
+        {
+            config.window = parseCount(fields[1]);
+            return config;
+        }
+        if (config.type == "rateLimit" && fields.size() == 2)
+        {
+            config.maxRate = std::stod(fields[1]);
+            return config;
+        }
+        if (config.type == "spike" &&
+            (fields.size() == 2 || fields.size() == 3))
+        {
+            config.threshold = std::stod(fields[1]);
+            if (fields.size() == 3)
+            {
+                config.maxRejects = parseCount(fields[2]);
+            }
+            return config;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        throw SensorBuildException("invalid sensor filter '" +
+                                   std::string(spec) + "': " + e.what());
+    }
+
+    throw SensorBuildException("invalid sensor filter '" + std::string(spec) +
+                               "'");
+}
+
+} // namespace pid_control
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "conf.hpp"
+#include "interfaces.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace pid_control
+{
+
+/* The largest window a median filter can be configured with. */
+constexpr size_t maxFilterWindow = 15;
+
+/*
+ * A single stage of a sensor filter chain.  Stages keep their history in
+ * fixed-size storage, so filtering a sample never allocates.
+ *
+ * Non-finite samples aren't passed to the stages, they go straight through
+ * the chain so that failure detection still sees them.
+ */
+class SensorFilter
+{
+  public:
+    virtual ~SensorFilter() = default;
+
+    virtual double apply(double value,
+                         std::chrono::steady_clock::time_point updated) = 0;
+};
+
+/* Exponential moving average, alpha is the weight of the newest sample. */
+class EmaFilter : public SensorFilter
+{
+  public:
+    explicit EmaFilter(double alpha) : _alpha(alpha) {}
+
+    double apply(double value,
+                 std::chrono::steady_clock::time_point updated) override;
+
+  private:
+    const double _alpha;
+    double _average = 0.0;
+    bool _primed = false;
+};
+
+/* Median of the last window samples. */
+class MedianFilter : public SensorFilter
+{
+  public:
+    explicit MedianFilter(size_t window) : _window(window) {}
+
+    double apply(double value,
+                 std::chrono::steady_clock::time_point updated) override;
+
+  private:
+    const size_t _window;
+    std::array<double, maxFilterWindow> _samples{};
+    std::array<double, maxFilterWindow> _scratch{};
+    size_t _next = 0;
+    size_t _count = 0;
+};
+
+/* Limits how fast the output can move, in units per second. */
+class RateLimitFilter : public SensorFilter
+{
+  public:
+    explicit RateLimitFilter(double maxRate) : _maxRate(maxRate) {}
+
+    double apply(double value,
+                 std::chrono::steady_clock::time_point updated) override;
+
+  private:
+    const double _maxRate;
+    double _output = 0.0;
+    std::chrono::steady_clock::time_point _updated;
+    bool _primed = false;
+};
+
+/*
+ * Holds the last accepted sample when a new one jumps by more than threshold.
+ * After maxRejects jumps in a row the new level is accepted as real.
+ */
+class SpikeFilter : public SensorFilter
+{
+  public:
+    SpikeFilter(double threshold, uint32_t maxRejects) :
+        _threshold(threshold), _maxRejects(maxRejects)
+    {}
+
+    double apply(double value,
+                 std::chrono::steady_clock::time_point updated) override;
+
+  private:
+    const double _threshold;
+    const uint32_t _maxRejects;
+    double _accepted = 0.0;
+    uint32_t _rejects = 0;
+    bool _primed = false;
+};
+
+/*
+ * The filters configured for a sensor, applied in order.
+ */
+class SensorFilterChain
+{
+  public:
+    /*
+     * @throw SensorBuildException on an unknown type or bad parameter.
+     */
+    explicit SensorFilterChain(
+        const std::vector<conf::SensorFilterConfig>& config);
+
+    double apply(double value, std::chrono::steady_clock::time_point updated);
+
+  private:
+    std::vector<std::unique_ptr<SensorFilter>> _stages;
+};
+
+/*
+ * A sensor's filters, run over the unscaled values of its readings, so their
+ * parameters are in the sensor's own units, such as RPM for a fan.  The
+ * filtered value is the filtered unscaled value scaled by the reader.
+ * Passive readers return the same reading until a new one arrives, so each
+ * reading (one with a new updated timestamp) is only fed to the filters once.
+ */
+class ReadingFilter
+{
+  public:
+    /*
+     * @throw SensorBuildException on an unknown type or bad parameter.
+     */
+    explicit ReadingFilter(
+        const std::vector<conf::SensorFilterConfig>& config) : _chain(config)
+    {}
+
+    /* Filter r, read from reader. */
+    ReadReturn apply(const ReadReturn& r, const ReadInterface& reader);
+
+  private:
+    SensorFilterChain _chain;
+    /* The last reading run through the filters. */
+    ReadReturn _filtered;
+    bool _filteredAny = false;
+};
+
+/*
+ * Parse the compact form used by the D-Bus configuration: "ema:<alpha>",
+ * "median:<window>", "rateLimit:<maxRate>" or
+ * "spike:<threshold>[:<maxRejects>]".
+ *
+ * @throw SensorBuildException if the string can't be parsed.
+ */
+conf::SensorFilterConfig parseSensorFilter(std::string_view spec);
+
+} // namespace pid_control
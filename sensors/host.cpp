@@ -3,6 +3,7 @@
 
 #include "host.hpp"
 
+#include "clock.hpp"
 #include "failsafeloggers/failsafe_logger_utility.hpp"
 #include "hoststatemonitor.hpp"
 #include "interfaces.hpp"
@@ -10,11 +11,12 @@
 
 #include <sdbusplus/bus.hpp>
 
+#include <atomic>
 #include <chrono>
 #include <cmath>
 #include <cstdint>
+#include <map>
 #include <memory>
-#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
@@ -22,6 +24,45 @@
 namespace pid_control
 {
 
+/*
+ * HostSensors by name, so a batch update can find them without going through
+ * the SensorManager that owns them.  During a reload the replacement sensor
+ * registers before the old one is destroyed, so an entry is only dropped by
+ * the sensor it points at.
+ */
+static std::map<std::string, HostSensor*>& hostSensorsByName()
+{
+    static std::map<std::string, HostSensor*> sensors;
+    return sensors;
+}
+
+HostSensor* HostSensor::find(const std::string& name)
+{
+    auto& sensors = hostSensorsByName();
+    auto it = sensors.find(name);
+    if (it == sensors.end())
+    {
+        return nullptr;
+    }
+
+    return it->second;
+}
+
+void HostSensor::registerSensor(void)
+{
+    hostSensorsByName()[getName()] = this;
+}
+
+HostSensor::~HostSensor()
+{
+    auto& sensors = hostSensorsByName();
+    auto it = sensors.find(getName());
+    if (it != sensors.end() && it->second == this)
+    {
+        sensors.erase(it);
+    }
+}
+
 std::unique_ptr<Sensor> HostSensor::createTemp(
     const std::string& name, int64_t timeout, sdbusplus::bus_t& bus,
     const char* objPath, bool defer, bool ignoreFailIfHostOff)
@@ -48,22 +89,51 @@ std::unique_ptr<Sensor> HostSensor::createTemp(
     return sensor;
 }
 
-double HostSensor::value(double value)
+void HostSensor::store(double value)
 {
-    std::lock_guard<std::mutex> guard(_lock);
+    auto now = clockNow();
+    uint32_t sequence = _sequence.load(std::memory_order_relaxed);
+
+    _sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _value.store(value, std::memory_order_relaxed);
+    _updated.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+    _sequence.store(sequence + 2, std::memory_order_release);
+}
 
-    _updated = std::chrono::high_resolution_clock::now();
-    _value = value * pow(10, 0); /* scale value */
+double HostSensor::value(double value)
+{
+    store(value);
 
     return ValueObject::value(value);
 }
 
+void HostSensor::update(double value)
+{
+    store(value);
+
+    ValueObject::value(value, true);
+}
+
 ReadReturn HostSensor::read(void)
 {
-    std::lock_guard<std::mutex> guard(_lock);
+    uint32_t before;
+    uint32_t after;
+    double value;
+    std::chrono::steady_clock::rep updated;
+
+    do
+    {
+        before = _sequence.load(std::memory_order_acquire);
+        value = _value.load(std::memory_order_relaxed);
+        updated = _updated.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = _sequence.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
 
     /* This doesn't sanity check anything, that's the caller's job. */
-    ReadReturn r = {_value, _updated};
+    ReadReturn r = {value, std::chrono::steady_clock::time_point(
+                               std::chrono::steady_clock::duration(updated))};
 
     return r;
 }
@@ -75,7 +145,7 @@ void HostSensor::write([[maybe_unused]] double value)
 
 bool HostSensor::getFailed(void)
 {
-    if (std::isfinite(_value))
+    if (std::isfinite(_value.load(std::memory_order_relaxed)))
     {
         return false;
     }
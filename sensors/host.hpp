@@ -7,10 +7,10 @@
 #include <sdbusplus/server/object.hpp>
 #include <xyz/openbmc_project/Sensor/Value/server.hpp>
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <memory>
-#include <mutex>
 #include <string>
 
 template <typename... T>
@@ -40,22 +40,40 @@ class HostSensor : public Sensor, public ValueObject
         ValueObject(bus, objPath,
                     defer ? ValueObject::action::defer_emit
                           : ValueObject::action::emit_object_added)
-    {}
+    {
+        registerSensor();
+    }
+
+    ~HostSensor() override;
 
     double value(double value) override;
 
+    /*
+     * Update the reading without emitting PropertiesChanged.  This is the path
+     * taken by HostSensorBatch, where a host pushes many readings at once.
+     */
+    void update(double value);
+
     ReadReturn read(void) override;
     void write(double value) override;
     bool getFailed(void) override;
 
+    /* Return the HostSensor with this name, or nullptr if there isn't one. */
+    static HostSensor* find(const std::string& name);
+
   private:
+    void registerSensor(void);
+    void store(double value);
+
     /*
-     * _lock will be used to make sure _updated & _value are updated
-     * together.
+     * _value and _updated are published together as a snapshot guarded by
+     * _sequence: store() makes _sequence odd while it writes and even again
+     * once both fields are in place, and read() retries until it sees the
+     * same even sequence before and after its loads.
      */
-    std::mutex _lock;
-    std::chrono::high_resolution_clock::time_point _updated;
-    double _value = 0;
+    std::atomic<uint32_t> _sequence = 0;
+    std::atomic<double> _value = 0;
+    std::atomic<std::chrono::steady_clock::rep> _updated = 0;
 };
 
 } // namespace pid_control
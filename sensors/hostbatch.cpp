@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright 2026 Google Inc
+
+#include "hostbatch.hpp"
+
+#include "host.hpp"
+#include "pid/tuning.hpp"
+
+#include <systemd/sd-bus.h>
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/exception.hpp>
+#include <sdbusplus/message.hpp>
+#include <sdbusplus/server/interface.hpp>
+#include <sdbusplus/vtable.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace pid_control
+{
+
+const sdbusplus::vtable_t HostSensorBatch::_vtable[] = {
+    sdbusplus::vtable::start(),
+    sdbusplus::vtable::method("SetValues", "a(sd)", "u",
+                              HostSensorBatch::setValuesCallback),
+    sdbusplus::vtable::end(),
+};
+
+HostSensorBatch::HostSensorBatch(sdbusplus::bus_t& bus, const char* objPath) :
+    _interface(bus, objPath, interface, _vtable, this)
+{}
+
+uint32_t HostSensorBatch::setValues(
+    const std::vector<std::tuple<std::string, double>>& values)
+{
+    uint32_t applied = 0;
+
+    for (const auto& [name, value] : values)
+    {
+        HostSensor* sensor = HostSensor::find(name);
+        if (sensor == nullptr)
+        {
+            if (debugEnabled)
+            {
+                std::cerr << "SetValues: no host sensor named " << name
+                          << "\n";
+            }
+            continue;
+        }
+
+        sensor->update(value);
+        ++applied;
+    }
+
+    return applied;
+}
+
+int HostSensorBatch::setValuesCallback(
+    sd_bus_message* msg, [[maybe_unused]] void* context, sd_bus_error* error)
+{
+    try
+    {
+        auto m = sdbusplus::message_t(msg);
+        std::vector<std::tuple<std::string, double>> values;
+        m.read(values);
+
+        auto reply = m.new_method_return();
+        reply.append(setValues(values));
+        reply.method_return();
+    }
+    catch (const sdbusplus::exception_t& e)
+    {
+        return sd_bus_error_set(error, e.name(), e.description());
+    }
+
+    return 1;
+}
+
+} // namespace pid_control
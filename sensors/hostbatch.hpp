@@ -0,0 +1,45 @@
+#pragma once
+
+#include <systemd/sd-bus.h>
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/server/interface.hpp>
+#include <sdbusplus/vtable.hpp>
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace pid_control
+{
+
+/*
+ * HostSensorBatch adds a SetValues method to the extsensors root object so a
+ * host agent can push every HostSensor reading in a single message instead of
+ * issuing one Properties.Set per sensor.
+ *
+ * SetValues takes an array of (sensor name, value) pairs, a(sd), and replies
+ * with the number of readings applied.  Names that aren't HostSensors are
+ * skipped.  Readings applied this way do not emit PropertiesChanged.
+ */
+class HostSensorBatch
+{
+  public:
+    static constexpr auto interface =
+        "xyz.openbmc_project.Hwmon.External.Batch";
+
+    HostSensorBatch(sdbusplus::bus_t& bus, const char* objPath);
+
+    static uint32_t setValues(
+        const std::vector<std::tuple<std::string, double>>& values);
+
+  private:
+    static int setValuesCallback(sd_bus_message* msg, void* context,
+                                 sd_bus_error* error);
+
+    static const sdbusplus::vtable_t _vtable[];
+    sdbusplus::server::interface_t _interface;
+};
+
+} // namespace pid_control
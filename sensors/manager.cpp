@@ -5,7 +5,11 @@
 #include "sensors/manager.hpp"
 
 #include "sensor.hpp"
+#include "sensors/arena.hpp"
+#include "sensors/readcache.hpp"
+#include "symbols.hpp"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -14,9 +18,18 @@ namespace pid_control
 {
 
 void SensorManager::addSensor(const std::string& type, const std::string& name,
-                              std::unique_ptr<Sensor> sensor)
+                              SensorPtr<Sensor> sensor)
 {
-    _sensorMap[name] = std::move(sensor);
+    SymbolId id = intern(name);
+
+    // A sensor replacing one with the same name takes over its entry.
+    removeSensor(id);
+    if (id >= _sensors.size())
+    {
+        _sensors.resize(id + 1);
+    }
+    _sensors[id] = std::move(sensor);
+    _version++;
 
     auto entry = _sensorTypeList.find(type);
     if (entry == _sensorTypeList.end())
@@ -24,7 +37,31 @@ void SensorManager::addSensor(const std::string& type, const std::string& name,
         _sensorTypeList[type] = {};
     }
 
-    _sensorTypeList[type].push_back(name);
+    _sensorTypeList[type].push_back(id);
+}
+
+void SensorManager::removeSensor(const std::string& name)
+{
+    auto id = symbols().find(name);
+    if (id)
+    {
+        removeSensor(*id);
+    }
+}
+
+void SensorManager::removeSensor(SymbolId id)
+{
+    if (id < _sensors.size() && _sensors[id])
+    {
+        _sensors[id].reset();
+        _version++;
+    }
+    _readCache.invalidate(id);
+
+    for (auto& [type, ids] : _sensorTypeList)
+    {
+        std::erase(ids, id);
+    }
 }
 
 } // namespace pid_control
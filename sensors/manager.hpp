@@ -1,14 +1,21 @@
 #pragma once
 
+#include "sensors/arena.hpp"
+#include "sensors/readcache.hpp"
 #include "sensors/sensor.hpp"
+#include "symbols.hpp"
 
 #include <sdbusplus/bus.hpp>
 #include <sdbusplus/server.hpp>
 
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
+#include <memory_resource>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace pid_control
@@ -16,11 +23,20 @@ namespace pid_control
 
 /*
  * The SensorManager holds all sensors across all zones.
+ *
+ * Sensors and their interfaces made with make() come from the manager's
+ * arena, close together in the order they're built, with the space of a
+ * removed sensor reused by the next one its size.  They mustn't outlive the
+ * manager.  Sensors are found by their name's SymbolId in a table indexed
+ * by it, names are only looked up when building.
  */
 class SensorManager
 {
   public:
+    static constexpr auto SensorRoot = "/xyz/openbmc_project/extsensors";
+
     SensorManager(sdbusplus::bus_t& pass, sdbusplus::bus_t& host) :
+        _arena(std::make_unique<std::pmr::unsynchronized_pool_resource>()),
         _passiveListeningBus(pass), _hostSensorBus(host)
     {
         // manager gets its interface from the bus. :D
@@ -32,18 +48,78 @@ class SensorManager
     SensorManager(const SensorManager&) = delete;
     SensorManager& operator=(const SensorManager&) = delete;
     SensorManager(SensorManager&&) = default;
-    SensorManager& operator=(SensorManager&&) = default;
+
+    SensorManager& operator=(SensorManager&& other) noexcept
+    {
+        // The sensors are in the arena, so they're released, into the old
+        // arena, before it's replaced.
+        _sensors = std::move(other._sensors);
+        _arena = std::move(other._arena);
+        _sensorTypeList = std::move(other._sensorTypeList);
+        _version = other._version;
+        _readCache = std::move(other._readCache);
+        _passiveListeningBus = other._passiveListeningBus;
+        _hostSensorBus = other._hostSensorBus;
+        return *this;
+    }
+
+    /*
+     * Make a sensor or interface in the manager's arena.
+     */
+    template <typename T, typename... Args>
+    SensorPtr<T> make(Args&&... args)
+    {
+        return makeInArena<T>(_arena.get(), std::forward<Args>(args)...);
+    }
 
     /*
-     * Add a Sensor to the Manager.
+     * Add a Sensor to the Manager, replacing any sensor with the same name.
      */
     void addSensor(const std::string& type, const std::string& name,
-                   std::unique_ptr<Sensor> sensor);
+                   SensorPtr<Sensor> sensor);
+
+    /*
+     * Remove a Sensor from the Manager, if it's there.
+     */
+    void removeSensor(const std::string& name);
+    void removeSensor(SymbolId id);
 
     // TODO(venture): Should implement read/write by name.
     Sensor* getSensor(const std::string& name) const
     {
-        return _sensorMap.at(name).get();
+        auto id = symbols().find(name);
+        if (!id)
+        {
+            throw std::out_of_range("No sensor named " + name);
+        }
+        return getSensor(*id);
+    }
+
+    Sensor* getSensor(SymbolId id) const
+    {
+        Sensor* sensor = (id < _sensors.size()) ? _sensors[id].get() : nullptr;
+        if (!sensor)
+        {
+            throw std::out_of_range("No sensor named " + symbolName(id));
+        }
+        return sensor;
+    }
+
+    /*
+     * Changes whenever a sensor is added or removed, after which pointers
+     * from getSensor() may no longer be valid.
+     */
+    uint64_t getVersion(void) const
+    {
+        return _version;
+    }
+
+    /*
+     * The readings the zones share, each sensor read once a generation.
+     */
+    SensorReadCache& getReadCache(void) const
+    {
+        return _readCache;
     }
 
     sdbusplus::bus_t& getPassiveBus(void)
@@ -57,13 +133,18 @@ class SensorManager
     }
 
   private:
-    std::map<std::string, std::unique_ptr<Sensor>> _sensorMap;
-    std::map<std::string, std::vector<std::string>> _sensorTypeList;
+    // Declared first, so the sensors in it are gone before it is.
+    std::unique_ptr<std::pmr::unsynchronized_pool_resource> _arena;
+    // Indexed by SymbolId, nullptr for names that aren't sensors here.
+    std::vector<SensorPtr<Sensor>> _sensors;
+    std::map<std::string, std::vector<SymbolId>> _sensorTypeList;
+    uint64_t _version = 0;
+    // Reading doesn't change the sensors, so it's done through a const
+    // manager.
+    mutable SensorReadCache _readCache;
 
     std::reference_wrapper<sdbusplus::bus_t> _passiveListeningBus;
     std::reference_wrapper<sdbusplus::bus_t> _hostSensorBus;
-
-    static constexpr auto SensorRoot = "/xyz/openbmc_project/extsensors";
 };
 
 } // namespace pid_control
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "clock.hpp"
+#include "interfaces.hpp"
+#include "sensors/sensor.hpp"
+
+#include <string>
+
+namespace pid_control
+{
+
+/*
+ * Stands in for a sensor that couldn't be built.  It always reads as failed,
+ * so the zones using it run in failsafe until the real sensor replaces it.
+ */
+class MissingSensor : public Sensor
+{
+  public:
+    explicit MissingSensor(const std::string& name) : Sensor(name, 0) {}
+
+    ReadReturn read(void) override
+    {
+        ReadReturn r;
+        r.updated = clockNow();
+        return r;
+    }
+
+    void write([[maybe_unused]] double value) override {}
+
+    bool getFailed(void) override
+    {
+        return true;
+    }
+
+    std::string getFailReason(void) override
+    {
+        return "Sensor not available";
+    }
+};
+
+} // namespace pid_control
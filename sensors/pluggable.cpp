@@ -14,7 +14,8 @@ namespace pid_control
 
 ReadReturn PluggableSensor::read(void)
 {
-    return _reader->read();
+    ReadReturn r = _reader->read();
+    return _filter ? _filter->apply(r, *_reader) : r;
 }
 
 void PluggableSensor::write(double value)
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "arena.hpp"
+#include "conf.hpp"
+#include "filter.hpp"
 #include "interfaces.hpp"
 #include "sensor.hpp"
 
@@ -7,23 +10,33 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace pid_control
 {
 
 /*
  * A Sensor that can use any reader or writer you provide.
+ *
+ * If filters are given, each new reading (one with a new updated timestamp)
+ * is run through them before it's returned.  See ReadingFilter.
  */
 class PluggableSensor : public Sensor
 {
   public:
     PluggableSensor(const std::string& name, int64_t timeout,
-                    std::unique_ptr<ReadInterface> reader,
-                    std::unique_ptr<WriteInterface> writer,
-                    bool ignoreFailIfHostOff = false) :
+                    SensorPtr<ReadInterface> reader,
+                    SensorPtr<WriteInterface> writer,
+                    bool ignoreFailIfHostOff = false,
+                    const std::vector<conf::SensorFilterConfig>& filters = {}) :
         Sensor(name, timeout, ignoreFailIfHostOff), _reader(std::move(reader)),
         _writer(std::move(writer))
-    {}
+    {
+        if (!filters.empty())
+        {
+            _filter = std::make_unique<ReadingFilter>(filters);
+        }
+    }
 
     ReadReturn read(void) override;
     void write(double value) override;
@@ -32,8 +45,10 @@ class PluggableSensor : public Sensor
     std::string getFailReason(void) override;
 
   private:
-    std::unique_ptr<ReadInterface> _reader;
-    std::unique_ptr<WriteInterface> _writer;
+    SensorPtr<ReadInterface> _reader;
+    SensorPtr<WriteInterface> _writer;
+
+    std::unique_ptr<ReadingFilter> _filter;
 };
 
 } // namespace pid_control
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright 2026 Google Inc
+
+#include "sensors/readcache.hpp"
+
+#include "interfaces.hpp"
+#include "sensors/sensor.hpp"
+#include "symbols.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+namespace pid_control
+{
+
+uint64_t SensorReadCache::begin(uint64_t lastGeneration,
+                                std::chrono::steady_clock::time_point now)
+{
+    if (lastGeneration == _generation || now - _generationStart >= window)
+    {
+        _generation++;
+        _generationStart = now;
+    }
+
+    return _generation;
+}
+
+const SensorReading& SensorReadCache::read(
+    SymbolId id, Sensor* sensor, uint64_t generation,
+    std::chrono::steady_clock::time_point now)
+{
+    if (id >= _readings.size())
+    {
+        _readings.resize(id + 1);
+    }
+
+    SensorReading& reading = _readings[id];
+    if (reading.generation == generation)
+    {
+        return reading;
+    }
+
+    reading.read = sensor->read();
+    reading.generation = generation;
+
+    auto timeout = sensor->getTimeout();
+    reading.failed = sensor->getFailed();
+    reading.failReason = reading.failed ? sensor->getFailReason() : "";
+    reading.timedOut = !reading.failed && timeout.count() != 0 &&
+                       now - reading.read.updated >= timeout;
+
+    return reading;
+}
+
+void SensorReadCache::invalidate(SymbolId id)
+{
+    if (id < _readings.size())
+    {
+        _readings[id].generation = 0;
+    }
+}
+
+} // namespace pid_control
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "interfaces.hpp"
+#include "sensors/sensor.hpp"
+#include "symbols.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pid_control
+{
+
+/* A sensor's reading and health, as every zone sees it in a generation. */
+struct SensorReading
+{
+    ReadReturn read;
+    bool failed = false;
+    /* Only set when failed. */
+    std::string failReason;
+    bool timedOut = false;
+    uint64_t generation = 0;
+};
+
+/*
+ * The readings of the zones' sensors, each read and checked at most once a
+ * generation however many zones use it, so zones cycling together read a
+ * sensor shared between them once and see the same value for it.
+ *
+ * A generation starts when a zone reads its inputs and the current one is
+ * older than window, or was already read in by that zone, so a zone never
+ * sees a reading older than its previous cycle.
+ */
+class SensorReadCache
+{
+  public:
+    static constexpr auto window = std::chrono::milliseconds(10);
+
+    /*
+     * Start a zone's read of its inputs, returning the generation to read
+     * them in.  lastGeneration is the one the zone last read them in.
+     */
+    uint64_t begin(uint64_t lastGeneration,
+                   std::chrono::steady_clock::time_point now);
+
+    /*
+     * The reading of sensor id in generation, reading sensor and checking
+     * its health as of now if no zone has yet.
+     */
+    const SensorReading& read(SymbolId id, Sensor* sensor, uint64_t generation,
+                              std::chrono::steady_clock::time_point now);
+
+    /* Forget the reading of id, whose sensor is being replaced. */
+    void invalidate(SymbolId id);
+
+    uint64_t getGeneration(void) const
+    {
+        return _generation;
+    }
+
+  private:
+    uint64_t _generation = 0;
+    std::chrono::steady_clock::time_point _generationStart;
+    // Indexed by SymbolId.
+    std::vector<SensorReading> _readings;
+};
+
+} // namespace pid_control
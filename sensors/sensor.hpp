@@ -2,6 +2,7 @@
 
 #include "interfaces.hpp"
 
+#include <chrono>
 #include <cstdint>
 #include <string>
 
@@ -21,16 +22,19 @@ class Sensor
      * any of sensor is meant to be sampled once per second.  By default.
      *
      * @param[in] type - the sensor type (e.g. fan)
-     * @return the default timeout for that type (in seconds).
+     * @return the default timeout for that type (in milliseconds).
      */
     static int64_t getDefaultTimeout(const std::string& type)
     {
-        return (type == "fan") ? 0 : 2;
+        return (type == "fan") ? 0 : 2000;
     }
 
+    /*
+     * @param[in] timeout - the timeout in milliseconds, 0 disables it.
+     */
     Sensor(const std::string& name, int64_t timeout,
            bool ignoreFailIfHostOff = false) :
-        _name(name), _timeout(timeout),
+        _name(name), _timeout(std::chrono::milliseconds(timeout)),
         _ignoreFailIfHostOff(ignoreFailIfHostOff)
     {}
 
@@ -61,10 +65,11 @@ class Sensor
         return _name;
     }
 
-    /* Returns the configurable timeout period
-     * for this sensor in seconds (undecorated).
+    /* Returns the configurable timeout period for this sensor, already in
+     * steady_clock ticks so a staleness check is a single compare.  A zero
+     * duration means the sensor isn't checked for a timeout.
      */
-    int64_t getTimeout(void) const
+    std::chrono::steady_clock::duration getTimeout(void) const
     {
         return _timeout;
     }
@@ -76,7 +81,7 @@ class Sensor
 
   private:
     std::string _name;
-    int64_t _timeout;
+    std::chrono::steady_clock::duration _timeout;
     bool _ignoreFailIfHostOff;
 };
 
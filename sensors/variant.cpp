@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright 2026 Google Inc
+
+#include "variant.hpp"
+
+#include "dbus/dbuspassive.hpp"
+#include "dbus/dbuswrite.hpp"
+#include "hoststatemonitor.hpp"
+#include "interfaces.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <variant>
+
+namespace pid_control
+{
+
+/*
+ * The calls are qualified with the backend's type so they're made directly,
+ * not through its vtable.
+ */
+template <typename Reader>
+static Reader& backend(Reader& reader)
+{
+    return reader;
+}
+
+template <typename Reader>
+static Reader& backend(std::unique_ptr<Reader>& reader)
+{
+    return *reader;
+}
+
+ReadReturn VariantSensor::read(void)
+{
+    return std::visit(
+        [this](auto& reader) {
+            auto& b = backend(reader);
+            using Backend = std::remove_reference_t<decltype(b)>;
+            ReadReturn r = b.Backend::read();
+            return _filter ? _filter->apply(r, b) : r;
+        },
+        _reader);
+}
+
+void VariantSensor::write(double value)
+{
+    std::visit(
+        [value](auto& writer) {
+            using Backend = std::remove_reference_t<decltype(writer)>;
+            writer.Backend::write(value);
+        },
+        _writer);
+}
+
+void VariantSensor::write(double value, bool force, int64_t* written)
+{
+    std::visit(
+        [value, force, written](auto& writer) {
+            using Backend = std::remove_reference_t<decltype(writer)>;
+            // Only the D-Bus writers tell what they wrote, the others are
+            // written as WriteInterface would, ignoring force.
+            if constexpr (std::is_same_v<Backend, DbusWrite> ||
+                          std::is_same_v<Backend, DbusWritePercent>)
+            {
+                writer.Backend::write(value, force, written);
+            }
+            else
+            {
+                writer.Backend::write(value);
+            }
+        },
+        _writer);
+}
+
+bool VariantSensor::getFailed(void)
+{
+    bool isFailed = std::visit(
+        [](auto& reader) {
+            auto& b = backend(reader);
+            using Backend = std::remove_reference_t<decltype(b)>;
+            return b.Backend::getFailed();
+        },
+        _reader);
+
+    if (isFailed && getIgnoreFailIfHostOff())
+    {
+        auto& hostState = HostStateMonitor::getInstance();
+        if (!hostState.isPowerOn())
+        {
+            return false;
+        }
+    }
+
+    return isFailed;
+}
+
+std::string VariantSensor::getFailReason(void)
+{
+    return std::visit(
+        [](auto& reader) {
+            auto& b = backend(reader);
+            using Backend = std::remove_reference_t<decltype(b)>;
+            return b.Backend::getFailReason();
+        },
+        _reader);
+}
+
+} // namespace pid_control
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "conf.hpp"
+#include "dbus/dbuspassive.hpp"
+#include "dbus/dbuswrite.hpp"
+#include "filter.hpp"
+#include "interfaces.hpp"
+#include "notimpl/readonly.hpp"
+#include "notimpl/writeonly.hpp"
+#include "sensor.hpp"
+#include "sysfs/sysfsread.hpp"
+#include "sysfs/sysfswrite.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace pid_control
+{
+
+/*
+ * The readers and writers a VariantSensor can hold.  A DbusPassive is
+ * registered with the bus by address, so it's held by pointer.
+ */
+using SensorReader =
+    std::variant<SysFsRead, WriteOnly, std::unique_ptr<DbusPassive>>;
+using SensorWriter = std::variant<ReadOnlyNoExcept, SysFsWrite,
+                                  SysFsWritePercent, DbusWrite,
+                                  DbusWritePercent>;
+
+/*
+ * A PluggableSensor for the readers and writers swampd builds itself.  It
+ * holds them by value and calls them directly, instead of through the
+ * ReadInterface and WriteInterface, so a read or write is one virtual call
+ * into the sensor rather than two, with no pointer to follow to the reader.
+ *
+ * Built in place of PluggableSensor with -Dvariant-sensors=true.  Tests and
+ * mocks still plug into PluggableSensor.
+ */
+class VariantSensor final : public Sensor
+{
+  public:
+    VariantSensor(const std::string& name, int64_t timeout,
+                  SensorReader reader, SensorWriter writer,
+                  bool ignoreFailIfHostOff = false,
+                  const std::vector<conf::SensorFilterConfig>& filters = {}) :
+        Sensor(name, timeout, ignoreFailIfHostOff), _reader(std::move(reader)),
+        _writer(std::move(writer))
+    {
+        if (!filters.empty())
+        {
+            _filter = std::make_unique<ReadingFilter>(filters);
+        }
+    }
+
+    ReadReturn read(void) override;
+    void write(double value) override;
+    void write(double value, bool force, int64_t* written) override;
+    bool getFailed(void) override;
+    std::string getFailReason(void) override;
+
+  private:
+    SensorReader _reader;
+    SensorWriter _writer;
+
+    std::unique_ptr<ReadingFilter> _filter;
+};
+
+} // namespace pid_control
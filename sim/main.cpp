@@ -0,0 +1,285 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright 2026 Google Inc
+
+#include "buildjson/buildjson.hpp"
+#include "clock.hpp"
+#include "conf.hpp"
+#include "notimpl/readonly.hpp"
+#include "pid/builder.hpp"
+#include "pid/buildjson.hpp"
+#include "pid/pidloop.hpp"
+#include "pid/tuning.hpp"
+#include "pid/zone_interface.hpp"
+#include "plant.hpp"
+#include "sensors/buildjson.hpp"
+#include "sensors/manager.hpp"
+#include "sensors/pluggable.hpp"
+#include "simsensor.hpp"
+
+#include <CLI/CLI.hpp>
+#include <nlohmann/json.hpp>
+#include <sdbusplus/bus.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace pid_control
+{
+namespace sim
+{
+
+/* A zone and when its next fan cycle is due, in simulated milliseconds. */
+struct ZoneRun
+{
+    std::shared_ptr<ZoneInterface> zone;
+    uint64_t nextMs;
+    uint64_t cycleCnt;
+};
+
+/* Build each configured sensor on top of the plant. */
+static void buildSimSensors(
+    const std::map<std::string, conf::SensorConfig>& config,
+    ThermalPlant& plant, SensorManager& mgr)
+{
+    for (const auto& [name, info] : config)
+    {
+        if (!plant.hasFan(name) && !plant.hasThermal(name))
+        {
+            throw std::runtime_error("Sensor missing from the plant: " + name);
+        }
+
+        // Like the real fans, only those with a writePath are written.
+        std::unique_ptr<WriteInterface> wi;
+        if (info.type == "fan" && !info.writePath.empty() &&
+            plant.hasFan(name))
+        {
+            wi = std::make_unique<SimWrite>(plant, name, info.min, info.max);
+        }
+        else
+        {
+            wi = std::make_unique<ReadOnlyNoExcept>();
+        }
+
+        // The simulated host is always on.
+        auto sensor = std::make_unique<PluggableSensor>(
+            name, info.timeoutMs, std::make_unique<SimRead>(plant, name),
+            std::move(wi), false, info.filters);
+        mgr.addSensor(info.type, name, std::move(sensor));
+    }
+}
+
+static void writeHeader(std::ostream& out, const PlantConfig& config,
+                        const std::vector<ZoneRun>& runs)
+{
+    out << "time";
+    for (const auto& thermal : config.thermals)
+    {
+        out << "," << thermal.name;
+    }
+    for (const auto& fan : config.fans)
+    {
+        out << "," << fan.name << "_pwm," << fan.name << "_rpm";
+    }
+    for (const auto& run : runs)
+    {
+        out << ",zone" << run.zone->getZoneID() << "_failsafe";
+    }
+    out << "\n";
+}
+
+static void writeRow(std::ostream& out, const ThermalPlant& plant,
+                     const PlantConfig& config,
+                     const std::vector<ZoneRun>& runs)
+{
+    out << plant.getTime();
+    for (const auto& thermal : config.thermals)
+    {
+        out << "," << plant.getReading(thermal.name);
+    }
+    for (const auto& fan : config.fans)
+    {
+        out << "," << plant.getFanPwm(fan.name) * 100.0 << ","
+            << plant.getFanRpm(fan.name);
+    }
+    for (const auto& run : runs)
+    {
+        out << "," << run.zone->getFailSafeMode();
+    }
+    out << "\n";
+}
+
+/*
+ * Run every zone's control loop against the plant for durationMs of
+ * simulated time, writing a row of readings every reportMs.  Zones run in
+ * order of their next fan cycle, with the plant and the control clock
+ * advanced to that time before each one, so sensor timeouts and failsafe
+ * logging see simulated time.
+ */
+static void runSimulation(ThermalPlant& plant, const PlantConfig& config,
+                          std::vector<ZoneRun>& runs, uint64_t durationMs,
+                          uint64_t reportMs, std::ostream& out)
+{
+    uint64_t nowMs = 0;
+    uint64_t nextReportMs = 0;
+
+    ManualClock clock;
+    ScopedClock useClock(clock);
+
+    writeHeader(out, config, runs);
+
+    for (auto& run : runs)
+    {
+        if (run.zone->getCycleIntervalTime() == 0)
+        {
+            throw std::runtime_error("Zone has no cycle interval");
+        }
+        pidControlStart(run.zone);
+        run.nextMs = run.zone->getCycleIntervalTime();
+    }
+
+    while (!runs.empty())
+    {
+        auto next = std::min_element(
+            runs.begin(), runs.end(),
+            [](const ZoneRun& a, const ZoneRun& b) {
+                return a.nextMs < b.nextMs;
+            });
+        if (next->nextMs > durationMs)
+        {
+            break;
+        }
+
+        while (nextReportMs <= next->nextMs)
+        {
+            plant.step((nextReportMs - nowMs) / 1000.0);
+            nowMs = nextReportMs;
+            writeRow(out, plant, config, runs);
+            nextReportMs += reportMs;
+        }
+
+        plant.step((next->nextMs - nowMs) / 1000.0);
+        nowMs = next->nextMs;
+        clock.set(Clock::time_point(std::chrono::milliseconds(nowMs)));
+
+        pidControlCycle(next->zone, next->cycleCnt);
+        next->nextMs += next->zone->getCycleIntervalTime();
+    }
+}
+
+} // namespace sim
+} // namespace pid_control
+
+int main(int argc, char* argv[])
+{
+    using namespace pid_control;
+
+    std::string configPath;
+    std::string plantPath;
+    std::string outputPath;
+    double duration = 3600.0;
+    double report = 1.0;
+
+    loggingPath = "";
+    loggingEnabled = false;
+    tuningEnabled = false;
+    debugEnabled = false;
+    coreLoggingEnabled = false;
+
+    CLI::App app{"OpenBMC Fan Control Simulator"};
+
+    app.add_option("-c,--conf", configPath, "Fan control configuration")
+        ->required()
+        ->check(CLI::ExistingFile);
+    app.add_option("-p,--plant", plantPath, "Simulated plant description")
+        ->required()
+        ->check(CLI::ExistingFile);
+    // Simulated time advances in whole milliseconds.
+    auto atLeastOneMs = CLI::Range(0.001, std::numeric_limits<double>::max());
+    app.add_option("-s,--seconds", duration,
+                   "Simulated seconds to run for, at least 0.001, default 3600")
+        ->check(atLeastOneMs);
+    app.add_option("-r,--report", report,
+                   "Simulated seconds between output rows, at least 0.001, "
+                   "default 1")
+        ->check(atLeastOneMs);
+    app.add_option("-o,--output", outputPath,
+                   "Optional file for the output rows, default stdout");
+    app.add_option("-l,--log", loggingPath,
+                   "Optional parameter to specify logging folder")
+        ->check(CLI::ExistingDirectory);
+    app.add_flag("-t,--tuning", tuningEnabled, "Enable or disable tuning");
+    app.add_flag("-d,--debug", debugEnabled, "Enable or disable debug mode");
+    app.add_flag("-g,--corelogging", coreLoggingEnabled,
+                 "Enable or disable logging of core PID loop computations");
+
+    CLI11_PARSE(app, argc, argv);
+
+    loggingEnabled = !loggingPath.empty();
+
+    try
+    {
+        auto jsonData = parseValidateJson(configPath);
+        auto sensorConfig = buildSensorsFromJson(jsonData);
+        auto [zoneConfig, zoneDetailsConfig] = buildPIDsFromJson(jsonData);
+
+        std::ifstream plantFile(plantPath);
+        auto plantConfig = sim::buildPlantFromJson(json::parse(plantFile));
+        sim::ThermalPlant plant(plantConfig);
+
+        /* The zones and sensors still put their objects on a bus, which may
+         * be any bus the user can own names on, such as a session bus from
+         * dbus-run-session.
+         */
+        auto bus = sdbusplus::bus::new_default();
+        SensorManager mgr(bus, bus);
+        sim::buildSimSensors(sensorConfig, plant, mgr);
+
+        auto zones = buildZones(zoneConfig, zoneDetailsConfig, mgr, bus);
+        std::vector<sim::ZoneRun> runs;
+        for (const auto& [id, zone] : zones)
+        {
+            runs.push_back({zone, 0, 0});
+        }
+        std::sort(runs.begin(), runs.end(),
+                  [](const sim::ZoneRun& a, const sim::ZoneRun& b) {
+                      return a.zone->getZoneID() < b.zone->getZoneID();
+                  });
+
+        std::ofstream outputFile;
+        if (!outputPath.empty())
+        {
+            outputFile.open(outputPath);
+        }
+        std::ostream& out = outputPath.empty() ? std::cout : outputFile;
+
+        auto start = std::chrono::steady_clock::now();
+        sim::runSimulation(plant, plantConfig, runs,
+                           static_cast<uint64_t>(duration * 1000.0),
+                           static_cast<uint64_t>(report * 1000.0), out);
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        std::cerr << "Simulated " << plant.getTime() << " seconds in "
+                  << elapsed.count() << " seconds\n";
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Simulation failed: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,223 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright 2026 Google Inc
+
+#include "plant.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+using json = nlohmann::json;
+
+namespace pid_control
+{
+namespace sim
+{
+
+void from_json(const json& j, FanConfig& f)
+{
+    j.at("name").get_to(f.name);
+    f.maxRpm = j.value("maxRpm", f.maxRpm);
+    f.timeConstant = j.value("timeConstant", f.timeConstant);
+    f.failAt = j.value("failAt", f.failAt);
+
+    if (f.maxRpm <= 0.0 || f.timeConstant < 0.0)
+    {
+        throw std::runtime_error("Invalid fan in plant: " + f.name);
+    }
+}
+
+void from_json(const json& j, PowerStep& p)
+{
+    j.at("time").get_to(p.time);
+    j.at("power").get_to(p.power);
+}
+
+void from_json(const json& j, ThermalConfig& t)
+{
+    j.at("name").get_to(t.name);
+    t.power = j.value("power", t.power);
+    t.stillResistance = j.value("stillResistance", t.stillResistance);
+    t.fullResistance = j.value("fullResistance", t.fullResistance);
+    t.timeConstant = j.value("timeConstant", t.timeConstant);
+    t.tjMax = j.value("tjMax", t.tjMax);
+    t.failAt = j.value("failAt", t.failAt);
+
+    auto profile = j.find("powerProfile");
+    if (profile != j.end())
+    {
+        profile->get_to(t.powerProfile);
+        std::stable_sort(t.powerProfile.begin(), t.powerProfile.end(),
+                         [](const PowerStep& a, const PowerStep& b) {
+                             return a.time < b.time;
+                         });
+    }
+
+    if (t.timeConstant < 0.0)
+    {
+        throw std::runtime_error("Invalid thermal in plant: " + t.name);
+    }
+}
+
+PlantConfig buildPlantFromJson(const json& data)
+{
+    PlantConfig config;
+
+    config.ambient = data.value("ambient", config.ambient);
+    data.at("fans").get_to(config.fans);
+    data.at("thermals").get_to(config.thermals);
+
+    return config;
+}
+
+ThermalPlant::ThermalPlant(const PlantConfig& config) :
+    _ambient(config.ambient)
+{
+    for (const auto& fan : config.fans)
+    {
+        if (!_fans.emplace(fan.name, Fan{fan}).second)
+        {
+            throw std::runtime_error("Duplicate fan in plant: " + fan.name);
+        }
+    }
+
+    for (const auto& thermal : config.thermals)
+    {
+        if (_fans.contains(thermal.name) ||
+            !_thermals.emplace(thermal.name, Thermal{thermal, _ambient})
+                 .second)
+        {
+            throw std::runtime_error(
+                "Duplicate sensor in plant: " + thermal.name);
+        }
+    }
+}
+
+// The fraction of the first order response covered over dt seconds.
+static double approach(double dt, double timeConstant)
+{
+    return (timeConstant > 0.0) ? 1.0 - std::exp(-dt / timeConstant) : 1.0;
+}
+
+double ThermalPlant::airflow(void) const
+{
+    if (_fans.empty())
+    {
+        return 0.0;
+    }
+
+    double sum = 0.0;
+    for (const auto& [name, fan] : _fans)
+    {
+        sum += fan.rpm / fan.config.maxRpm;
+    }
+    return sum / _fans.size();
+}
+
+double ThermalPlant::power(const ThermalConfig& config, double time)
+{
+    double power = config.power;
+    for (const auto& step : config.powerProfile)
+    {
+        if (step.time > time)
+        {
+            break;
+        }
+        power = step.power;
+    }
+    return power;
+}
+
+void ThermalPlant::step(double seconds)
+{
+    if (seconds <= 0.0)
+    {
+        return;
+    }
+
+    // The heat sources see the airflow from the start of the step.
+    double flow = airflow();
+
+    for (auto& [name, fan] : _fans)
+    {
+        double target = (_time >= fan.config.failAt)
+                            ? 0.0
+                            : fan.pwm * fan.config.maxRpm;
+        fan.rpm += (target - fan.rpm) *
+                   approach(seconds, fan.config.timeConstant);
+    }
+
+    for (auto& [name, thermal] : _thermals)
+    {
+        const auto& config = thermal.config;
+        double resistance =
+            config.stillResistance +
+            (config.fullResistance - config.stillResistance) * flow;
+        double settled = _ambient + power(config, _time) * resistance;
+        thermal.temperature += (settled - thermal.temperature) *
+                               approach(seconds, config.timeConstant);
+    }
+
+    _time += seconds;
+}
+
+bool ThermalPlant::hasFan(const std::string& name) const
+{
+    return _fans.contains(name);
+}
+
+bool ThermalPlant::hasThermal(const std::string& name) const
+{
+    return _thermals.contains(name);
+}
+
+void ThermalPlant::setFanPwm(const std::string& name, double pwm)
+{
+    _fans.at(name).pwm = std::clamp(pwm, 0.0, 1.0);
+}
+
+double ThermalPlant::getFanPwm(const std::string& name) const
+{
+    return _fans.at(name).pwm;
+}
+
+double ThermalPlant::getFanRpm(const std::string& name) const
+{
+    return _fans.at(name).rpm;
+}
+
+double ThermalPlant::getFanMaxRpm(const std::string& name) const
+{
+    return _fans.at(name).config.maxRpm;
+}
+
+double ThermalPlant::getTemperature(const std::string& name) const
+{
+    return _thermals.at(name).temperature;
+}
+
+double ThermalPlant::getReading(const std::string& name) const
+{
+    const auto& thermal = _thermals.at(name);
+    if (std::isnan(thermal.config.tjMax))
+    {
+        return thermal.temperature;
+    }
+    return thermal.config.tjMax - thermal.temperature;
+}
+
+bool ThermalPlant::getFailed(const std::string& name) const
+{
+    auto fan = _fans.find(name);
+    if (fan != _fans.end())
+    {
+        return _time >= fan->second.config.failAt;
+    }
+    return _time >= _thermals.at(name).config.failAt;
+}
+
+} // namespace sim
+} // namespace pid_control
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace pid_control
+{
+namespace sim
+{
+
+/* A fan spinning towards maxRpm times its PWM, with a first order lag. */
+struct FanConfig
+{
+    std::string name;
+    double maxRpm = 10000.0;
+    /* Seconds for the fan to cover 63% of a change in speed. */
+    double timeConstant = 1.0;
+    /* Seconds into the run at which the fan stops and reads 0 RPM. */
+    double failAt = std::numeric_limits<double>::infinity();
+};
+
+/* From time seconds on, the heat source dissipates power watts. */
+struct PowerStep
+{
+    double time;
+    double power;
+};
+
+/*
+ * A thermal RC node: a heat source whose temperature settles at ambient plus
+ * power times a thermal resistance, which falls linearly from
+ * stillResistance with the fans stopped to fullResistance with them all at
+ * full speed.
+ */
+struct ThermalConfig
+{
+    std::string name;
+    double power = 0.0;
+    std::vector<PowerStep> powerProfile;
+    double stillResistance = 1.0;
+    double fullResistance = 0.1;
+    /* Seconds for the temperature to cover 63% of a change. */
+    double timeConstant = 30.0;
+    /* If set, the sensor reads the margin tjMax - temperature. */
+    double tjMax = std::numeric_limits<double>::quiet_NaN();
+    /* Seconds into the run at which the sensor fails. */
+    double failAt = std::numeric_limits<double>::infinity();
+};
+
+struct PlantConfig
+{
+    double ambient = 25.0;
+    std::vector<FanConfig> fans;
+    std::vector<ThermalConfig> thermals;
+};
+
+/**
+ * Given the json data of a plant description, build its configuration.
+ *
+ * @param[in] data - the json data.
+ * @return the plant configuration - throws exceptions on invalid bits.
+ */
+PlantConfig buildPlantFromJson(const json& data);
+
+/*
+ * The fans and heat sources of a simulated machine, advanced in steps of
+ * simulated time.  All fans share one airflow, so each heat source is
+ * cooled by the average speed of every fan.
+ */
+class ThermalPlant
+{
+  public:
+    explicit ThermalPlant(const PlantConfig& config);
+
+    /* Advance the plant by the given number of simulated seconds. */
+    void step(double seconds);
+
+    /* Simulated seconds since the start. */
+    double getTime(void) const
+    {
+        return _time;
+    }
+
+    bool hasFan(const std::string& name) const;
+    bool hasThermal(const std::string& name) const;
+
+    /* Set the fan's PWM, as a fraction from 0 to 1. */
+    void setFanPwm(const std::string& name, double pwm);
+    double getFanPwm(const std::string& name) const;
+    double getFanRpm(const std::string& name) const;
+    double getFanMaxRpm(const std::string& name) const;
+
+    double getTemperature(const std::string& name) const;
+    /* The temperature, or the margin for nodes with a tjMax. */
+    double getReading(const std::string& name) const;
+
+    /* Whether the named fan or thermal sensor has failed by now. */
+    bool getFailed(const std::string& name) const;
+
+  private:
+    struct Fan
+    {
+        FanConfig config;
+        double pwm = 0.0;
+        double rpm = 0.0;
+    };
+
+    struct Thermal
+    {
+        ThermalConfig config;
+        double temperature;
+    };
+
+    double airflow(void) const;
+    static double power(const ThermalConfig& config, double time);
+
+    double _ambient;
+    double _time = 0.0;
+    std::map<std::string, Fan> _fans;
+    std::map<std::string, Thermal> _thermals;
+};
+
+} // namespace sim
+} // namespace pid_control
@@ -0,0 +1,319 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright 2026 Google Inc
+
+#include "buildjson/buildjson.hpp"
+#include "clock.hpp"
+#include "conf.hpp"
+#include "notimpl/readonly.hpp"
+#include "pid/builder.hpp"
+#include "pid/buildjson.hpp"
+#include "pid/pidloop.hpp"
+#include "pid/tuning.hpp"
+#include "pid/zone_interface.hpp"
+#include "replaysensor.hpp"
+#include "sensors/buildjson.hpp"
+#include "sensors/manager.hpp"
+#include "sensors/pluggable.hpp"
+#include "zonelog.hpp"
+
+#include <CLI/CLI.hpp>
+#include <sdbusplus/bus.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pid_control
+{
+namespace sim
+{
+
+/* A fan written by the replayed zone, and what it was recorded doing. */
+struct ReplayFan
+{
+    std::string name;
+    ReplayWrite* writer;
+    std::optional<size_t> recordedColumn;
+
+    double pwmSum = 0.0;
+    double recordedSum = 0.0;
+    uint64_t recordedCount = 0;
+    uint64_t msAbove = 0;
+};
+
+/*
+ * Build each sensor the zone's controllers read on the log's recorded
+ * values.  Fans with a writePath are written through a ReplayWrite, which
+ * is added to fans.
+ */
+static void buildReplaySensors(
+    const std::map<std::string, conf::SensorConfig>& config,
+    const conf::PIDConf& pids, const ZoneLogReader& log, SensorManager& mgr,
+    std::vector<ReplayFan>& fans)
+{
+    std::set<std::string> used;
+    for (const auto& [name, info] : pids)
+    {
+        for (const auto& input : info.inputs)
+        {
+            used.insert(input.name);
+        }
+    }
+
+    for (const auto& name : used)
+    {
+        auto info = config.find(name);
+        if (info == config.end())
+        {
+            throw std::runtime_error("Sensor missing from the config: " + name);
+        }
+
+        auto scaled = log.findColumn(name);
+        auto raw = log.findColumn(name + "_raw");
+        if (!scaled || !raw)
+        {
+            throw std::runtime_error("Sensor missing from the log: " + name);
+        }
+
+        std::unique_ptr<WriteInterface> wi;
+        if (info->second.type == "fan" && !info->second.writePath.empty())
+        {
+            auto writer = std::make_unique<ReplayWrite>(info->second.min,
+                                                        info->second.max);
+            fans.push_back({name, writer.get(), log.findColumn(name + "_pwm")});
+            wi = std::move(writer);
+        }
+        else
+        {
+            wi = std::make_unique<ReadOnlyNoExcept>();
+        }
+
+        // The log has the values after any filters, so none are applied.
+        auto sensor = std::make_unique<PluggableSensor>(
+            name, info->second.timeoutMs,
+            std::make_unique<ReplayRead>(log, *scaled, *raw), std::move(wi));
+        mgr.addSensor(info->second.type, name, std::move(sensor));
+    }
+}
+
+/*
+ * Run the zone once per row of the log, with the clock at the row's time,
+ * writing the fans' PWM each cycle to out if it's given.  Returns the number
+ * of rows replayed.
+ */
+static uint64_t runReplay(const std::shared_ptr<ZoneInterface>& zone,
+                          ZoneLogReader& log, std::vector<ReplayFan>& fans,
+                          double threshold, std::ostream* out)
+{
+    ManualClock clock;
+    ScopedClock useClock(clock);
+
+    if (!log.next())
+    {
+        throw std::runtime_error("Zone log has no rows");
+    }
+
+    if (out)
+    {
+        *out << "epoch_ms";
+        for (const auto& fan : fans)
+        {
+            *out << "," << fan.name << "_pwm";
+        }
+        *out << ",failsafe\n";
+    }
+
+    uint64_t rows = 0;
+    uint64_t cycleCnt = 0;
+    uint64_t lastMs = log.getTimeMs();
+
+    clock.set(Clock::time_point(std::chrono::milliseconds(lastMs)));
+    pidControlStart(zone);
+
+    do
+    {
+        // epoch_ms is wall time, so the clock is held if it steps back.
+        uint64_t nowMs = std::max(lastMs, log.getTimeMs());
+        clock.set(Clock::time_point(std::chrono::milliseconds(nowMs)));
+
+        // Time above the threshold is counted until the PWM next changes.
+        uint64_t elapsedMs = nowMs - lastMs;
+        for (auto& fan : fans)
+        {
+            if (fan.writer->getValue() * 100.0 > threshold)
+            {
+                fan.msAbove += elapsedMs;
+            }
+        }
+        lastMs = nowMs;
+
+        pidControlCycle(zone, cycleCnt);
+        rows++;
+
+        if (out)
+        {
+            *out << nowMs;
+        }
+        for (auto& fan : fans)
+        {
+            double pwm = fan.writer->getValue() * 100.0;
+            fan.pwmSum += pwm;
+
+            if (fan.recordedColumn)
+            {
+                double recorded = log.getValue(*fan.recordedColumn);
+                if (std::isfinite(recorded))
+                {
+                    fan.recordedSum += recorded * 100.0;
+                    fan.recordedCount++;
+                }
+            }
+
+            if (out)
+            {
+                *out << "," << pwm;
+            }
+        }
+        if (out)
+        {
+            *out << "," << zone->getFailSafeMode() << "\n";
+        }
+    } while (log.next());
+
+    return rows;
+}
+
+static void writeSummary(std::ostream& out,
+                         const std::vector<ReplayFan>& fans, uint64_t rows,
+                         double threshold)
+{
+    out << "fan,mean_pwm,recorded_mean_pwm,seconds_above_" << threshold
+        << ",writes\n";
+    for (const auto& fan : fans)
+    {
+        out << fan.name << "," << fan.pwmSum / rows << ",";
+        if (fan.recordedCount)
+        {
+            out << fan.recordedSum / fan.recordedCount;
+        }
+        out << "," << fan.msAbove / 1000.0 << "," << fan.writer->getWrites()
+            << "\n";
+    }
+}
+
+} // namespace sim
+} // namespace pid_control
+
+int main(int argc, char* argv[])
+{
+    using namespace pid_control;
+
+    std::string configPath;
+    std::string logPath;
+    std::string outputPath;
+    int64_t zoneId = -1;
+    double threshold = 80.0;
+
+    loggingPath = "";
+    loggingEnabled = false;
+    tuningEnabled = false;
+    debugEnabled = false;
+    coreLoggingEnabled = false;
+
+    CLI::App app{"OpenBMC Fan Control Log Replay"};
+
+    app.add_option("-c,--conf", configPath, "Fan control configuration")
+        ->required()
+        ->check(CLI::ExistingFile);
+    app.add_option("-l,--log", logPath, "Zone log recorded with swampd -l")
+        ->required()
+        ->check(CLI::ExistingFile);
+    app.add_option("-z,--zone", zoneId,
+                   "Zone to replay, needed if the config has more than one");
+    app.add_option("-o,--output", outputPath,
+                   "Optional file for the PWM of each cycle");
+    app.add_option("-t,--threshold", threshold,
+                   "PWM percent to count the time above, default 80");
+
+    CLI11_PARSE(app, argc, argv);
+
+    try
+    {
+        auto jsonData = parseValidateJson(configPath);
+        auto sensorConfig = buildSensorsFromJson(jsonData);
+        auto [zoneConfig, zoneDetailsConfig] = buildPIDsFromJson(jsonData);
+
+        if (zoneId < 0)
+        {
+            if (zoneConfig.empty())
+            {
+                throw std::runtime_error("The config has no zones");
+            }
+            if (zoneConfig.size() != 1)
+            {
+                throw std::runtime_error(
+                    "The config has more than one zone, pick one with -z");
+            }
+            zoneId = zoneConfig.begin()->first;
+        }
+
+        auto pids = zoneConfig.find(zoneId);
+        if (pids == zoneConfig.end())
+        {
+            throw std::runtime_error(
+                "Zone missing from the config: " + std::to_string(zoneId));
+        }
+        std::map<int64_t, conf::PIDConf> replayPids = {*pids};
+
+        std::ifstream logFile(logPath);
+        sim::ZoneLogReader log(logFile);
+
+        /* The zone and sensors still put their objects on a bus, which may
+         * be any bus the user can own names on, such as a session bus from
+         * dbus-run-session.
+         */
+        auto bus = sdbusplus::bus::new_default();
+        SensorManager mgr(bus, bus);
+        std::vector<sim::ReplayFan> fans;
+        sim::buildReplaySensors(sensorConfig, pids->second, log, mgr, fans);
+
+        auto zones = buildZones(replayPids, zoneDetailsConfig, mgr, bus);
+
+        std::ofstream outputFile;
+        if (!outputPath.empty())
+        {
+            outputFile.open(outputPath);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        uint64_t rows =
+            sim::runReplay(zones.at(zoneId), log, fans, threshold,
+                           outputPath.empty() ? nullptr : &outputFile);
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        sim::writeSummary(std::cout, fans, rows, threshold);
+        std::cerr << "Replayed " << rows << " cycles in " << elapsed.count()
+                  << " seconds\n";
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Replay failed: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright 2026 Google Inc
+
+#include "replaysensor.hpp"
+
+#include "clock.hpp"
+#include "interfaces.hpp"
+
+#include <cstdint>
+
+namespace pid_control
+{
+namespace sim
+{
+
+ReadReturn ReplayRead::read(void)
+{
+    ReadReturn r;
+
+    r.value = _log.getValue(_scaledColumn);
+    r.unscaled = _log.getValue(_rawColumn);
+    r.updated = clockNow();
+
+    return r;
+}
+
+void ReplayWrite::write(double value)
+{
+    write(value, false, nullptr);
+}
+
+void ReplayWrite::write(double value, bool force, int64_t* written)
+{
+    double range = static_cast<double>(getMax() - getMin());
+    auto raw = static_cast<int64_t>(getMin() + value * range);
+
+    _value = value;
+    if (raw != _raw || force)
+    {
+        _raw = raw;
+        _writes++;
+    }
+
+    if (written)
+    {
+        *written = _raw;
+    }
+}
+
+} // namespace sim
+} // namespace pid_control
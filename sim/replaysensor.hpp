@@ -0,0 +1,67 @@
+#pragma once
+
+#include "interfaces.hpp"
+#include "zonelog.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pid_control
+{
+namespace sim
+{
+
+/*
+ * A ReadInterface reading a sensor's recorded values from the current row
+ * of a zone log, stamped with the current time.
+ */
+class ReplayRead : public ReadInterface
+{
+  public:
+    ReplayRead(const ZoneLogReader& log, size_t scaledColumn,
+               size_t rawColumn) :
+        _log(log), _scaledColumn(scaledColumn), _rawColumn(rawColumn)
+    {}
+
+    ReadReturn read(void) override;
+
+  private:
+    const ZoneLogReader& _log;
+    size_t _scaledColumn;
+    size_t _rawColumn;
+};
+
+/*
+ * A WriteInterface standing in for a fan's PWM, which keeps the last value
+ * written and counts the writes.  Like DbusWritePercent, the raw value is
+ * the PWM ranged to min and max, and isn't written again unchanged unless
+ * forced.
+ */
+class ReplayWrite : public WriteInterface
+{
+  public:
+    ReplayWrite(int64_t min, int64_t max) : WriteInterface(min, max) {}
+
+    void write(double value) override;
+    void write(double value, bool force, int64_t* written) override;
+
+    /* The PWM last asked for, as a fraction from 0 to 1. */
+    double getValue(void) const
+    {
+        return _value;
+    }
+
+    /* How many times the raw value was written. */
+    uint64_t getWrites(void) const
+    {
+        return _writes;
+    }
+
+  private:
+    double _value = 0.0;
+    int64_t _raw = -1;
+    uint64_t _writes = 0;
+};
+
+} // namespace sim
+} // namespace pid_control
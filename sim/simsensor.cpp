@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright 2026 Google Inc
+
+#include "simsensor.hpp"
+
+#include "clock.hpp"
+#include "interfaces.hpp"
+#include "plant.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+namespace pid_control
+{
+namespace sim
+{
+
+ReadReturn SimRead::read(void)
+{
+    ReadReturn r;
+
+    r.updated = clockNow();
+
+    if (_plant.hasFan(_name))
+    {
+        r.unscaled = _plant.getFanRpm(_name);
+    }
+    else
+    {
+        r.unscaled = _plant.getReading(_name);
+    }
+    r.value = scale(r.unscaled);
+
+    return r;
+}
+
+double SimRead::scale(double unscaled) const
+{
+    if (_plant.hasFan(_name))
+    {
+        return unscaled / _plant.getFanMaxRpm(_name);
+    }
+    return unscaled;
+}
+
+bool SimRead::getFailed(void) const
+{
+    return _plant.getFailed(_name);
+}
+
+std::string SimRead::getFailReason(void) const
+{
+    return getFailed() ? "Simulated failure" : "Simulated";
+}
+
+void SimWrite::write(double value)
+{
+    write(value, false, nullptr);
+}
+
+void SimWrite::write(double value, bool force, int64_t* written)
+{
+    (void)force;
+
+    _plant.setFanPwm(_name, value);
+
+    if (written)
+    {
+        double range = static_cast<double>(getMax() - getMin());
+        *written = static_cast<int64_t>(std::round(getMin() + value * range));
+    }
+}
+
+} // namespace sim
+} // namespace pid_control
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "interfaces.hpp"
+#include "plant.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace pid_control
+{
+namespace sim
+{
+
+/*
+ * A ReadInterface reading a fan or thermal sensor of a ThermalPlant.  Fans
+ * read as RPM, scaled by their maximum RPM.
+ */
+class SimRead : public ReadInterface
+{
+  public:
+    SimRead(const ThermalPlant& plant, const std::string& name) :
+        _plant(plant), _name(name)
+    {}
+
+    ReadReturn read(void) override;
+    bool getFailed(void) const override;
+    std::string getFailReason(void) const override;
+    double scale(double unscaled) const override;
+
+  private:
+    const ThermalPlant& _plant;
+    std::string _name;
+};
+
+/*
+ * A WriteInterface setting a fan's PWM in a ThermalPlant.  The raw value
+ * written is the PWM ranged to min and max, like SysFsWritePercent.
+ */
+class SimWrite : public WriteInterface
+{
+  public:
+    SimWrite(ThermalPlant& plant, const std::string& name, int64_t min,
+             int64_t max) : WriteInterface(min, max), _plant(plant), _name(name)
+    {}
+
+    void write(double value) override;
+    void write(double value, bool force, int64_t* written) override;
+
+  private:
+    ThermalPlant& _plant;
+    std::string _name;
+};
+
+} // namespace sim
+} // namespace pid_control
@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright 2026 Google Inc
+
+#include "zonelog.hpp"
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pid_control
+{
+namespace sim
+{
+
+static void splitFields(std::string_view text,
+                        std::vector<std::string_view>& fields)
+{
+    fields.clear();
+
+    size_t start = 0;
+    for (;;)
+    {
+        size_t comma = text.find(',', start);
+        if (comma == std::string_view::npos)
+        {
+            fields.push_back(text.substr(start));
+            return;
+        }
+        fields.push_back(text.substr(start, comma - start));
+        start = comma + 1;
+    }
+}
+
+ZoneLogReader::ZoneLogReader(std::istream& in) : _in(in)
+{
+    if (!std::getline(_in, _text))
+    {
+        throw std::runtime_error("Zone log has no header");
+    }
+    _line = 1;
+
+    splitFields(_text, _fields);
+    for (const auto& field : _fields)
+    {
+        _columns.emplace_back(field);
+    }
+
+    auto time = findColumn("epoch_ms");
+    if (!time)
+    {
+        throw std::runtime_error("Zone log header has no epoch_ms");
+    }
+    _timeColumn = *time;
+    _fields.clear();
+}
+
+std::optional<size_t> ZoneLogReader::findColumn(const std::string& name) const
+{
+    for (size_t i = 0; i < _columns.size(); i++)
+    {
+        if (_columns[i] == name)
+        {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+bool ZoneLogReader::next(void)
+{
+    do
+    {
+        if (!std::getline(_in, _text))
+        {
+            _fields.clear();
+            return false;
+        }
+        _line++;
+    } while (_text.empty());
+
+    splitFields(_text, _fields);
+    if (_fields.size() < _columns.size())
+    {
+        throw std::runtime_error(
+            "Zone log line " + std::to_string(_line) + " is missing fields");
+    }
+
+    return true;
+}
+
+double ZoneLogReader::getValue(size_t column) const
+{
+    std::string_view field = _fields.at(column);
+    double value;
+
+    auto [end, ec] =
+        std::from_chars(field.data(), field.data() + field.size(), value);
+    if (ec != std::errc() || end != field.data() + field.size())
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return value;
+}
+
+uint64_t ZoneLogReader::getTimeMs(void) const
+{
+    std::string_view field = _fields.at(_timeColumn);
+    uint64_t value;
+
+    auto [end, ec] =
+        std::from_chars(field.data(), field.data() + field.size(), value);
+    if (ec != std::errc() || end != field.data() + field.size())
+    {
+        throw std::runtime_error(
+            "Zone log line " + std::to_string(_line) + " has a bad epoch_ms");
+    }
+    return value;
+}
+
+} // namespace sim
+} // namespace pid_control
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pid_control
+{
+namespace sim
+{
+
+/*
+ * Reads a zone log, as swampd writes with --log, one row at a time.  The
+ * header names the columns: epoch_ms, setpt and requester, then for each fan
+ * <fan>, <fan>_raw, <fan>_pwm and <fan>_pwm_raw, for each thermal input
+ * <sensor> and <sensor>_raw, and last failsafe.  A row's fields are only
+ * parsed as they're asked for.
+ */
+class ZoneLogReader
+{
+  public:
+    /* Reads the header - throws if there's none. */
+    explicit ZoneLogReader(std::istream& in);
+
+    const std::vector<std::string>& getColumns(void) const
+    {
+        return _columns;
+    }
+
+    std::optional<size_t> findColumn(const std::string& name) const;
+
+    /*
+     * Move on to the next row, false at the end of the log.  Throws for a
+     * row without a field for every column.
+     */
+    bool next(void);
+
+    /* The current row's value in the column, NaN if it isn't a number. */
+    double getValue(size_t column) const;
+
+    /* The current row's epoch_ms. */
+    uint64_t getTimeMs(void) const;
+
+    /* The line number of the current row, counting the header as 1. */
+    size_t getLine(void) const
+    {
+        return _line;
+    }
+
+  private:
+    std::istream& _in;
+    std::vector<std::string> _columns;
+    size_t _timeColumn;
+
+    std::string _text;
+    std::vector<std::string_view> _fields;
+    size_t _line = 0;
+};
+
+} // namespace sim
+} // namespace pid_control
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace pid_control
+{
+
+/*
+ * A compact id for a sensor or controller name, the same for that name
+ * everywhere in the process, so the zones, sensor manager and controllers
+ * can key on an integer and keep one copy of each name.
+ */
+using SymbolId = uint32_t;
+
+/*
+ * Maps names to ids and back.  Ids are handed out in order from 0 and never
+ * reused; a name stays interned for the life of the process, which is fine
+ * as the names come from the configuration and a reload brings back the
+ * same ones.
+ */
+class SymbolTable
+{
+  public:
+    /* The id for name, adding it if it's new. */
+    SymbolId intern(std::string_view name)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        auto it = _ids.find(name);
+        if (it != _ids.end())
+        {
+            return it->second;
+        }
+
+        auto id = static_cast<SymbolId>(_names.size());
+        // The deque doesn't move its strings, so the key can point in it.
+        const std::string& stored = _names.emplace_back(name);
+        _ids.emplace(stored, id);
+        return id;
+    }
+
+    /* The id for name, if it's been interned. */
+    std::optional<SymbolId> find(std::string_view name) const
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        auto it = _ids.find(name);
+        if (it == _ids.end())
+        {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    /* The name for an id from intern(). */
+    const std::string& name(SymbolId id) const
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        return _names.at(id);
+    }
+
+    size_t size(void) const
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        return _names.size();
+    }
+
+  private:
+    mutable std::mutex _lock;
+    std::deque<std::string> _names;
+    std::unordered_map<std::string_view, SymbolId> _ids;
+};
+
+namespace detail
+{
+inline SymbolTable symbolTable;
+} // namespace detail
+
+/* The process-wide symbol table. */
+inline SymbolTable& symbols(void)
+{
+    return detail::symbolTable;
+}
+
+/* Shorthand for symbols().intern(). */
+inline SymbolId intern(std::string_view name)
+{
+    return symbols().intern(name);
+}
+
+/* The ids for a list of names, in order. */
+inline std::vector<SymbolId> intern(const std::vector<std::string>& names)
+{
+    std::vector<SymbolId> ids;
+    ids.reserve(names.size());
+    for (const auto& name : names)
+    {
+        ids.push_back(intern(name));
+    }
+    return ids;
+}
+
+/* Shorthand for symbols().name(). */
+inline const std::string& symbolName(SymbolId id)
+{
+    return symbols().name(id);
+}
+
+} // namespace pid_control
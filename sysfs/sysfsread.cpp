@@ -3,9 +3,9 @@
 
 #include "sysfs/sysfsread.hpp"
 
+#include "clock.hpp"
 #include "interfaces.hpp"
 
-#include <chrono>
 #include <cstdint>
 #include <fstream>
 #include <iostream>
@@ -22,8 +22,7 @@ ReadReturn SysFsRead::read(void)
     ifs >> value;
     ifs.close();
 
-    ReadReturn r = {static_cast<double>(value),
-                    std::chrono::high_resolution_clock::now()};
+    ReadReturn r = {static_cast<double>(value), clockNow()};
 
     return r;
 }
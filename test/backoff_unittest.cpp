@@ -0,0 +1,26 @@
+#include "util.hpp"
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+namespace pid_control
+{
+namespace
+{
+
+using std::chrono::seconds;
+
+TEST(BackoffTest, DoublesUpToMax)
+{
+    Backoff backoff(seconds(1), seconds(5));
+
+    EXPECT_EQ(seconds(1), backoff.next());
+    EXPECT_EQ(seconds(2), backoff.next());
+    EXPECT_EQ(seconds(4), backoff.next());
+    EXPECT_EQ(seconds(5), backoff.next());
+    EXPECT_EQ(seconds(5), backoff.next());
+}
+
+} // namespace
+} // namespace pid_control
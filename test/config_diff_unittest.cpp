@@ -0,0 +1,160 @@
+#include "conf.hpp"
+#include "util.hpp"
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace pid_control
+{
+namespace
+{
+
+class ConfigDiffTest : public ::testing::Test
+{
+  protected:
+    ConfigDiffTest()
+    {
+        conf::SensorConfig fan = {};
+        fan.type = "fan";
+        fan.readPath = "/xyz/openbmc_project/sensors/fan_tach/fan0";
+        sensorConfig["fan0"] = fan;
+
+        conf::SensorConfig temp = {};
+        temp.type = "temp";
+        temp.readPath = "/xyz/openbmc_project/sensors/temperature/cpu0";
+        temp.timeoutMs = 2000;
+        sensorConfig["cpu0"] = temp;
+        temp.readPath = "/xyz/openbmc_project/sensors/temperature/cpu1";
+        sensorConfig["cpu1"] = temp;
+
+        conf::ControllerInfo fanPid = {};
+        fanPid.type = "fan";
+        fanPid.inputs = {{"fan0"}};
+        fanPid.pidInfo.proportionalCoeff = 0.5;
+        zoneConfig[0]["fan pid"] = fanPid;
+
+        conf::ControllerInfo stepwise = {};
+        stepwise.type = "stepwise";
+        stepwise.inputs = {{"cpu0"}};
+        stepwise.stepwiseInfo.reading = {40.0};
+        stepwise.stepwiseInfo.output = {30.0};
+        zoneConfig[0]["cpu0 stepwise"] = stepwise;
+
+        conf::ControllerInfo thermal = {};
+        thermal.type = "temp";
+        thermal.inputs = {{"cpu1"}};
+        thermal.setpoint = 70.0;
+        zoneConfig[1]["cpu1 pid"] = thermal;
+
+        zoneDetailsConfig[0] = {3000.0, 100.0, {}, false};
+        zoneDetailsConfig[1] = {3000.0, 100.0, {}, false};
+    }
+
+    ConfigDiff diff(void) const
+    {
+        return diffConfiguration(sensorConfig, zoneConfig, zoneDetailsConfig,
+                                 newSensorConfig, newZoneConfig,
+                                 newZoneDetailsConfig);
+    }
+
+    void copy(void)
+    {
+        newSensorConfig = sensorConfig;
+        newZoneConfig = zoneConfig;
+        newZoneDetailsConfig = zoneDetailsConfig;
+    }
+
+    std::map<std::string, conf::SensorConfig> sensorConfig;
+    std::map<int64_t, conf::PIDConf> zoneConfig;
+    std::map<int64_t, conf::ZoneConfig> zoneDetailsConfig;
+
+    std::map<std::string, conf::SensorConfig> newSensorConfig;
+    std::map<int64_t, conf::PIDConf> newZoneConfig;
+    std::map<int64_t, conf::ZoneConfig> newZoneDetailsConfig;
+};
+
+TEST_F(ConfigDiffTest, StartingFromNothingBuildsEverything)
+{
+    copy();
+
+    ConfigDiff d = diffConfiguration({}, {}, {}, newSensorConfig,
+                                     newZoneConfig, newZoneDetailsConfig);
+
+    EXPECT_EQ((std::set<std::string>{"cpu0", "cpu1", "fan0"}), d.sensors);
+    EXPECT_EQ((std::set<int64_t>{0, 1}), d.zones);
+}
+
+TEST_F(ConfigDiffTest, IdenticalConfigurationChangesNothing)
+{
+    // Unused margin zero and stepwise tail points are NaN, they must still
+    // compare equal.
+    copy();
+
+    ConfigDiff d = diff();
+
+    EXPECT_TRUE(d.sensors.empty());
+    EXPECT_TRUE(d.zones.empty());
+}
+
+TEST_F(ConfigDiffTest, UnusedSensorAppearingRebuildsNoZone)
+{
+    copy();
+    newSensorConfig["cpu2"] = sensorConfig["cpu0"];
+
+    ConfigDiff d = diff();
+
+    EXPECT_EQ((std::set<std::string>{"cpu2"}), d.sensors);
+    EXPECT_TRUE(d.zones.empty());
+}
+
+TEST_F(ConfigDiffTest, ChangedSensorRebuildsOnlyZonesUsingIt)
+{
+    copy();
+    newSensorConfig["cpu1"].timeoutMs = 500;
+
+    ConfigDiff d = diff();
+
+    EXPECT_EQ((std::set<std::string>{"cpu1"}), d.sensors);
+    EXPECT_EQ((std::set<int64_t>{1}), d.zones);
+}
+
+TEST_F(ConfigDiffTest, ChangedControllerRebuildsItsZone)
+{
+    copy();
+    newZoneConfig[0]["cpu0 stepwise"].stepwiseInfo.output[0] = 35.0;
+
+    ConfigDiff d = diff();
+
+    EXPECT_TRUE(d.sensors.empty());
+    EXPECT_EQ((std::set<int64_t>{0}), d.zones);
+}
+
+TEST_F(ConfigDiffTest, ChangedZoneSettingsRebuildsZone)
+{
+    copy();
+    newZoneDetailsConfig[1].cycleTime.cycleIntervalTimeMS = 200;
+
+    ConfigDiff d = diff();
+
+    EXPECT_EQ((std::set<int64_t>{1}), d.zones);
+}
+
+TEST_F(ConfigDiffTest, RemovedZoneIsRebuilt)
+{
+    copy();
+    newZoneConfig.erase(1);
+    newZoneDetailsConfig.erase(1);
+    newSensorConfig.erase("cpu1");
+
+    ConfigDiff d = diff();
+
+    EXPECT_EQ((std::set<std::string>{"cpu1"}), d.sensors);
+    EXPECT_EQ((std::set<int64_t>{1}), d.zones);
+}
+
+} // namespace
+} // namespace pid_control
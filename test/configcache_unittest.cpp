@@ -0,0 +1,171 @@
+#include "conf.hpp"
+#include "configcache.hpp"
+#include "pid/ec/stepwise.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace pid_control
+{
+namespace
+{
+
+class ConfigCacheTest : public ::testing::Test
+{
+  protected:
+    ConfigCacheTest()
+    {
+        char dir[] = "/tmp/configcache_unittest.XXXXXX";
+        _dir = mkdtemp(dir);
+        _path = _dir + "/swampd/config.bin";
+
+        conf::SensorConfig fan = {};
+        fan.type = "fan";
+        fan.readPath = "/xyz/openbmc_project/sensors/fan_tach/fan0";
+        fan.timeoutMs = 2000;
+        fan.unavailableAsFailed = true;
+
+        conf::SensorConfig temp = {};
+        temp.type = "temp";
+        temp.readPath = "/xyz/openbmc_project/sensors/temperature/cpu";
+        temp.ignoreFailIfHostOff = true;
+        conf::SensorFilterConfig ema;
+        ema.type = "ema";
+        ema.alpha = 0.25;
+        temp.filters.push_back(ema);
+        _sensors = {{"fan0", fan}, {"cpu", temp}};
+
+        conf::ControllerInfo pid = {};
+        pid.type = "fan";
+        pid.inputs = {{"fan0"}};
+        pid.setpoint = 0.0;
+        pid.pidInfo.ts = 0.1;
+        pid.pidInfo.proportionalCoeff = 0.01;
+        pid.pidInfo.outLim = {30.0, 100.0};
+        pid.failSafePercent = 0.0;
+
+        conf::ControllerInfo stepwise = {};
+        stepwise.type = "stepwise";
+        stepwise.inputs = {{"cpu", 85.0, true, false}};
+        stepwise.setpoint = 0.0;
+        stepwise.failSafePercent = 80.0;
+        stepwise.stepwiseInfo.ts = 1.0;
+        stepwise.stepwiseInfo.positiveHysteresis = 1.0;
+        stepwise.stepwiseInfo.negativeHysteresis = 2.0;
+        stepwise.stepwiseInfo.isCeiling = false;
+        stepwise.stepwiseInfo.interpolate = true;
+        stepwise.stepwiseInfo.reading = {40.0, 60.0};
+        stepwise.stepwiseInfo.output = {2000.0, 4000.0};
+
+        _pids = {{0, {{"fan pid", pid}, {"cpu stepwise", stepwise}}}};
+        _zones = {{0, {3000.0, 100.0, {100, 1000}, true}}};
+    }
+
+    ~ConfigCacheTest() override
+    {
+        std::filesystem::remove_all(_dir);
+    }
+
+    std::string _dir;
+    std::string _path;
+    std::map<std::string, conf::SensorConfig> _sensors;
+    std::map<int64_t, conf::PIDConf> _pids;
+    std::map<int64_t, conf::ZoneConfig> _zones;
+};
+
+TEST_F(ConfigCacheTest, SerializeRoundTrip)
+{
+    std::map<std::string, conf::SensorConfig> sensors;
+    std::map<int64_t, conf::PIDConf> pids;
+    std::map<int64_t, conf::ZoneConfig> zones;
+
+    deserializeConfig(serializeConfig(_sensors, _pids, _zones), sensors, pids,
+                      zones);
+
+    EXPECT_EQ(_sensors, sensors);
+    EXPECT_EQ(_pids, pids);
+    EXPECT_EQ(_zones, zones);
+}
+
+TEST_F(ConfigCacheTest, HashFollowsContent)
+{
+    uint64_t hash = hashConfig(_sensors, _pids, _zones);
+    EXPECT_EQ(hash, hashConfig(_sensors, _pids, _zones));
+
+    _zones[0].failsafePercent = 90.0;
+    EXPECT_NE(hash, hashConfig(_sensors, _pids, _zones));
+}
+
+TEST_F(ConfigCacheTest, TruncatedDataThrows)
+{
+    std::map<std::string, conf::SensorConfig> sensors;
+    std::map<int64_t, conf::PIDConf> pids;
+    std::map<int64_t, conf::ZoneConfig> zones;
+
+    std::string data = serializeConfig(_sensors, _pids, _zones);
+    data.resize(data.size() - 1);
+
+    EXPECT_THROW(deserializeConfig(data, sensors, pids, zones),
+                 std::runtime_error);
+    EXPECT_TRUE(sensors.empty());
+}
+
+TEST_F(ConfigCacheTest, ReadChecksSource)
+{
+    writeConfigCache(_path, 42, _sensors, _pids, _zones);
+
+    std::map<std::string, conf::SensorConfig> sensors;
+    std::map<int64_t, conf::PIDConf> pids;
+    std::map<int64_t, conf::ZoneConfig> zones;
+
+    EXPECT_FALSE(readConfigCache(_path, 43, sensors, pids, zones));
+    EXPECT_TRUE(sensors.empty());
+
+    ASSERT_TRUE(readConfigCache(_path, 42, sensors, pids, zones));
+    EXPECT_EQ(_sensors, sensors);
+    EXPECT_EQ(_pids, pids);
+    EXPECT_EQ(_zones, zones);
+}
+
+TEST_F(ConfigCacheTest, ReadRejectsCorruptCache)
+{
+    writeConfigCache(_path, 42, _sensors, _pids, _zones);
+    {
+        std::fstream file(_path, std::ios::in | std::ios::out |
+                                     std::ios::binary);
+        file.seekp(-1, std::ios::end);
+        file.put('\xff');
+    }
+
+    std::map<std::string, conf::SensorConfig> sensors;
+    std::map<int64_t, conf::PIDConf> pids;
+    std::map<int64_t, conf::ZoneConfig> zones;
+
+    EXPECT_FALSE(readConfigCache(_path, 42, sensors, pids, zones));
+    EXPECT_FALSE(readConfigCache(_dir + "/missing.bin", 42, sensors, pids,
+                                 zones));
+    EXPECT_TRUE(sensors.empty());
+}
+
+TEST_F(ConfigCacheTest, HashFileMatchesContents)
+{
+    std::string path = _dir + "/config.json";
+    {
+        std::ofstream out(path);
+        out << "{}";
+    }
+
+    EXPECT_EQ(hashBytes("{}"), hashFile(path));
+    EXPECT_THROW(hashFile(_dir + "/missing.json"), std::runtime_error);
+}
+
+} // namespace
+} // namespace pid_control
@@ -2,8 +2,11 @@
 
 #include <xyz/openbmc_project/Sensor/Value/common.hpp>
 
+#include <chrono>
 #include <cstdint>
+#include <exception>
 #include <map>
+#include <stdexcept>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -215,5 +218,146 @@ TEST(SetZoneIndexTest, ZoneListNotEmptyAssignsIntoGap)
     EXPECT_THAT(zones, ContainerEq(expected_zones));
 }
 
+TEST(SensorPatternsTest, MatchesLikeFindSensors)
+{
+    SensorPatterns patterns({"cpu[0-9]_temp", "fan1"});
+
+    EXPECT_FALSE(patterns.empty());
+    EXPECT_TRUE(
+        patterns.matches("/xyz/openbmc_project/sensors/temperature/cpu0_temp"));
+    EXPECT_TRUE(patterns.matches("/xyz/openbmc_project/sensors/fan_tach/fan1"));
+    EXPECT_FALSE(
+        patterns.matches("/xyz/openbmc_project/sensors/fan_tach/fan10"));
+    EXPECT_FALSE(
+        patterns.matches("/xyz/openbmc_project/sensors/voltage/psu0_vin"));
+    EXPECT_TRUE(SensorPatterns().empty());
+}
+
+TEST(ReloadDebounceTest, LoneChangeReloadsQuickly)
+{
+    ReloadDebounce debounce;
+    auto now = ReloadDebounce::Clock::now();
+
+    EXPECT_FALSE(debounce.pending());
+    EXPECT_EQ(ReloadDebounce::minDelay, debounce.onEvent(now));
+    EXPECT_TRUE(debounce.pending());
+
+    debounce.reset();
+    EXPECT_FALSE(debounce.pending());
+    EXPECT_EQ(ReloadDebounce::minDelay, debounce.onEvent(now));
+}
+
+TEST(ReloadDebounceTest, BurstBacksOffUpToMaxWait)
+{
+    using std::chrono::milliseconds;
+
+    ReloadDebounce debounce;
+    auto start = ReloadDebounce::Clock::now();
+
+    EXPECT_EQ(milliseconds(500), debounce.onEvent(start));
+    EXPECT_EQ(milliseconds(1000), debounce.onEvent(start + milliseconds(100)));
+    EXPECT_EQ(milliseconds(2000), debounce.onEvent(start + milliseconds(200)));
+    EXPECT_EQ(milliseconds(4000), debounce.onEvent(start + milliseconds(300)));
+    EXPECT_EQ(milliseconds(4000), debounce.onEvent(start + milliseconds(400)));
+
+    // The burst has to reload by maxWait after it started.
+    EXPECT_EQ(milliseconds(1000), debounce.onEvent(start + milliseconds(9000)));
+    EXPECT_EQ(milliseconds(0), debounce.onEvent(start + milliseconds(11000)));
+}
+
+/*
+ * A discovery pass's build and completion, counting the calls and writing the
+ * configuration it found into the shared one.
+ */
+struct FakePass
+{
+    FakePass(std::map<int64_t, std::string>& configuration,
+             const std::string& found) :
+        configuration(configuration), found(found)
+    {}
+
+    bool build(void)
+    {
+        builds++;
+        configuration[1] = found;
+        return true;
+    }
+
+    void done(std::exception_ptr e, bool r)
+    {
+        calls++;
+        error = e;
+        ready = r;
+    }
+
+    void finish(const DiscoveryPasses& passes, uint64_t pass,
+                std::exception_ptr failed = nullptr)
+    {
+        passes.finish(
+            pass, failed, [this] { return build(); },
+            [this](std::exception_ptr e, bool r) { done(e, r); });
+    }
+
+    std::map<int64_t, std::string>& configuration;
+    std::string found;
+    int builds = 0;
+    int calls = 0;
+    std::exception_ptr error;
+    bool ready = false;
+};
+
+TEST(DiscoveryPassesTest, StalePassFinishingLastIsDropped)
+{
+    // A reload starts a second pass before the first finishes, and the
+    // second's replies arrive first.  The first, finishing later, mustn't
+    // build over the second's configuration or report it.
+
+    DiscoveryPasses passes;
+    std::map<int64_t, std::string> configuration;
+    FakePass first(configuration, "first");
+    FakePass second(configuration, "second");
+
+    uint64_t firstPass = passes.start();
+    uint64_t secondPass = passes.start();
+
+    second.finish(passes, secondPass);
+    first.finish(passes, firstPass);
+
+    EXPECT_EQ("second", configuration[1]);
+    EXPECT_EQ(1, second.builds);
+    EXPECT_EQ(1, second.calls);
+    EXPECT_TRUE(second.ready);
+    EXPECT_EQ(0, first.builds);
+    EXPECT_EQ(0, first.calls);
+
+    // Nor is a stale pass's failure reported.
+    first.finish(passes, firstPass,
+                 std::make_exception_ptr(std::runtime_error("stale")));
+    EXPECT_EQ(0, first.calls);
+}
+
+TEST(DiscoveryPassesTest, CurrentPassReportsFailures)
+{
+    DiscoveryPasses passes;
+    std::map<int64_t, std::string> configuration;
+    FakePass pass(configuration, "found");
+
+    // A failed query is reported without building.
+    pass.finish(passes, passes.start(),
+                std::make_exception_ptr(std::runtime_error("mapper")));
+    EXPECT_EQ(0, pass.builds);
+    EXPECT_EQ(1, pass.calls);
+    EXPECT_TRUE(pass.error);
+
+    // So is a build that throws.
+    passes.finish(
+        passes.start(), nullptr,
+        []() -> bool { throw std::runtime_error("bad config"); },
+        [&pass](std::exception_ptr e, bool r) { pass.done(e, r); });
+    EXPECT_EQ(2, pass.calls);
+    EXPECT_TRUE(pass.error);
+    EXPECT_FALSE(pass.ready);
+}
+
 } // namespace
 } // namespace pid_control
@@ -0,0 +1,122 @@
+#include "pid/ec/pid.hpp"
+#include "pid/ec/pidbatch.hpp"
+#include "test/pid_helpers.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace pid_control
+{
+namespace
+{
+
+bool sameBits(double a, double b)
+{
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+void expectSameState(const ec::pid_info_t& a, const ec::pid_info_t& b)
+{
+    EXPECT_EQ(a.initialized, b.initialized);
+    EXPECT_TRUE(sameBits(a.integral, b.integral));
+    EXPECT_TRUE(sameBits(a.lastOutput, b.lastOutput));
+    EXPECT_TRUE(sameBits(a.lastError, b.lastError));
+}
+
+TEST(PidBatchTest, MatchesReferenceBitForBit)
+{
+    // Runs the same controllers through ec::pid() and the batch for many
+    // cycles, and expects identical outputs and state throughout.
+
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<double> value(-150.0, 150.0);
+
+    std::vector<ec::pid_info_t> reference = makeRandomControllers(gen, 64);
+    ec::PidBatch batch;
+    for (const auto& info : reference)
+    {
+        batch.add(info);
+    }
+    ASSERT_EQ(reference.size(), batch.size());
+
+    std::vector<double> inputs(reference.size());
+    std::vector<double> setpoints(reference.size());
+    std::vector<double> outputs(reference.size());
+
+    for (int cycle = 0; cycle < 200; cycle++)
+    {
+        for (size_t i = 0; i < reference.size(); i++)
+        {
+            inputs[i] = value(gen);
+            setpoints[i] = value(gen);
+        }
+
+        batch.run(inputs, setpoints, outputs);
+
+        for (size_t i = 0; i < reference.size(); i++)
+        {
+            double expected = ec::pid(&reference[i], inputs[i], setpoints[i]);
+            ASSERT_TRUE(sameBits(expected, outputs[i]))
+                << "controller " << i << " cycle " << cycle;
+
+            ec::pid_info_t state = {};
+            batch.storeState(i, &state);
+            expectSameState(reference[i], state);
+        }
+    }
+}
+
+TEST(PidBatchTest, LoadStateResumesReference)
+{
+    // State loaded from a controller that ran on its own is picked up by the
+    // next batched cycle.
+
+    std::mt19937 gen(42);
+    std::vector<ec::pid_info_t> reference = makeRandomControllers(gen, 16);
+    ec::PidBatch batch;
+    for (const auto& info : reference)
+    {
+        batch.add(info);
+    }
+
+    std::vector<double> inputs(reference.size(), 40.0);
+    std::vector<double> setpoints(reference.size(), 50.0);
+    std::vector<double> outputs(reference.size());
+
+    for (size_t i = 0; i < reference.size(); i++)
+    {
+        ec::pid(&reference[i], 45.0, 50.0);
+        batch.loadState(i, reference[i]);
+    }
+
+    batch.run(inputs, setpoints, outputs);
+
+    for (size_t i = 0; i < reference.size(); i++)
+    {
+        double expected = ec::pid(&reference[i], inputs[i], setpoints[i]);
+        EXPECT_TRUE(sameBits(expected, outputs[i])) << "controller " << i;
+
+        ec::pid_info_t state = {};
+        batch.storeState(i, &state);
+        expectSameState(reference[i], state);
+    }
+}
+
+TEST(PidBatchTest, ClearEmptiesBatch)
+{
+    ec::PidBatch batch;
+    batch.add(ec::pid_info_t{});
+    batch.add(ec::pid_info_t{});
+    EXPECT_EQ(2U, batch.size());
+
+    batch.clear();
+    EXPECT_EQ(0U, batch.size());
+    EXPECT_EQ(0U, batch.add(ec::pid_info_t{}));
+}
+
+} // namespace
+} // namespace pid_control
@@ -1,5 +1,6 @@
 #include "config.h"
 
+#include "pid/controller.hpp"
 #include "pid/ec/pid.hpp"
 #include "pid/fan.hpp"
 #include "pid/fancontroller.hpp"
@@ -8,14 +9,50 @@
 #include "test/sensor_mock.hpp"
 #include "test/zone_mock.hpp"
 
+#include <cstddef>
 #include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <map>
 #include <memory>
+#include <new>
 #include <string>
 #include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+namespace
+{
+// Counts heap allocations while enabled, for the allocation-free tests.
+bool countAllocations = false;
+size_t allocations = 0;
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    if (countAllocations)
+    {
+        allocations++;
+    }
+    void* p = std::malloc(size ? size : 1);
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
 namespace pid_control
 {
 namespace
@@ -25,6 +62,86 @@ using ::testing::_;
 using ::testing::Return;
 using ::testing::StrEq;
 
+// A zone and fan without gmock in the way, since gmock allocates on each
+// call.
+class FakeFanZone : public ZoneMock
+{
+  public:
+    double getCachedValue(const std::string& name) override
+    {
+        return cache.at(name).unscaled;
+    }
+    const ValueCacheEntry* getCachedValueSlot(const std::string& name) override
+    {
+        return &cache.at(name);
+    }
+    ValueCacheEntry* getOutputCacheSlot(const std::string& name) override
+    {
+        return &outputs.at(name);
+    }
+    Sensor* getSensor(const std::string& name) override
+    {
+        return sensors.at(name);
+    }
+    uint64_t getSensorsVersion(void) const override
+    {
+        return version;
+    }
+    bool getRedundantWrite(void) const override
+    {
+        return false;
+    }
+    bool getFailSafeMode(void) const override
+    {
+        return false;
+    }
+    double getMaxSetPointRequest(void) const override
+    {
+        return 5000.0;
+    }
+    int64_t getZoneID(void) const override
+    {
+        return 0;
+    }
+    std::map<std::string, std::pair<std::string, double>>
+        getFailSafeSensors(void) const override
+    {
+        return {};
+    }
+
+    std::map<std::string, ValueCacheEntry> cache;
+    std::map<std::string, ValueCacheEntry> outputs;
+    std::map<std::string, Sensor*> sensors;
+    uint64_t version = 1;
+};
+
+class FakeFan : public Sensor
+{
+  public:
+    explicit FakeFan(const std::string& name) : Sensor(name, 0) {}
+
+    ReadReturn read(void) override
+    {
+        return {};
+    }
+    void write(double value) override
+    {
+        written = value;
+    }
+    void write(double value, bool, int64_t* rawWritten) override
+    {
+        written = value;
+        writes++;
+        if (rawWritten)
+        {
+            *rawWritten = static_cast<int64_t>(value * 255);
+        }
+    }
+
+    double written = 0.0;
+    int writes = 0;
+};
+
 TEST(FanControllerTest, BoringFactoryTest)
 {
     // Verify the factory will properly build the FanPIDController in the
@@ -176,9 +293,7 @@ TEST(FanControllerTest, OutputProc_VerifiesIfFailsafeEnabledInputIsIgnored)
     SensorMock* sm1 = reinterpret_cast<SensorMock*>(s1.get());
     SensorMock* sm2 = reinterpret_cast<SensorMock*>(s2.get());
 
-    EXPECT_CALL(z, getRedundantWrite())
-        .WillOnce(Return(false))
-        .WillOnce(Return(false));
+    EXPECT_CALL(z, getRedundantWrite()).WillOnce(Return(false));
     EXPECT_CALL(z, getSensor(StrEq("fan0"))).WillOnce(Return(s1.get()));
     EXPECT_CALL(*sm1, write(0.75, false, _));
     EXPECT_CALL(z, getSensor(StrEq("fan1"))).WillOnce(Return(s2.get()));
@@ -215,9 +330,7 @@ TEST(FanControllerTest, OutputProc_BehavesAsExpected)
     SensorMock* sm1 = reinterpret_cast<SensorMock*>(s1.get());
     SensorMock* sm2 = reinterpret_cast<SensorMock*>(s2.get());
 
-    EXPECT_CALL(z, getRedundantWrite())
-        .WillOnce(Return(false))
-        .WillOnce(Return(false));
+    EXPECT_CALL(z, getRedundantWrite()).WillOnce(Return(false));
     EXPECT_CALL(z, getSensor(StrEq("fan0"))).WillOnce(Return(s1.get()));
     EXPECT_CALL(*sm1, write(0.5, false, _));
     EXPECT_CALL(z, getSensor(StrEq("fan1"))).WillOnce(Return(s2.get()));
@@ -298,9 +411,7 @@ TEST(FanControllerTest, OutputProc_VerifyRedundantWrites)
     SensorMock* sm1 = reinterpret_cast<SensorMock*>(s1.get());
     SensorMock* sm2 = reinterpret_cast<SensorMock*>(s2.get());
 
-    EXPECT_CALL(z, getRedundantWrite())
-        .WillOnce(Return(true))
-        .WillOnce(Return(true));
+    EXPECT_CALL(z, getRedundantWrite()).WillOnce(Return(true));
     EXPECT_CALL(z, getSensor(StrEq("fan0"))).WillOnce(Return(s1.get()));
     EXPECT_CALL(*sm1, write(0.5, true, _));
     EXPECT_CALL(z, getSensor(StrEq("fan1"))).WillOnce(Return(s2.get()));
@@ -311,5 +422,144 @@ TEST(FanControllerTest, OutputProc_VerifyRedundantWrites)
     p->outputProc(50.0);
 }
 
+TEST(FanControllerTest, StateCarriesOverToRebuiltController)
+{
+    // The PID internals and fan direction move to a rebuilt controller, with
+    // the integral kept inside the new controller's limits.
+
+    ZoneMock z;
+
+    std::vector<std::string> inputs = {"fan0"};
+    ec::pidinfo initial;
+    initial.integralLimit.min = 0.0;
+    initial.integralLimit.max = 50.0;
+    initial.outLim.min = 0.0;
+    initial.outLim.max = 100.0;
+
+    std::unique_ptr<PIDController> p =
+        FanController::createFanPid(&z, "fan1", inputs, initial);
+    EXPECT_FALSE(p == nullptr);
+
+    ControllerState state;
+    state.kind = "fan";
+    state.initialized = true;
+    state.integral = 80.0;
+    state.lastError = -2.0;
+    state.lastOutput = 60.0;
+    state.direction = static_cast<int>(FanSpeedDirection::UP);
+
+    EXPECT_TRUE(p->setState(state));
+
+    ControllerState restored = p->getState();
+    EXPECT_EQ("fan", restored.kind);
+    EXPECT_TRUE(restored.initialized);
+    EXPECT_EQ(50.0, restored.integral);
+    EXPECT_EQ(-2.0, restored.lastError);
+    EXPECT_EQ(60.0, restored.lastOutput);
+    EXPECT_EQ(FanSpeedDirection::UP,
+              static_cast<FanController*>(p.get())->getFanDirection());
+}
+
+TEST(FanControllerTest, MismatchedOrInvalidStateIsNotRestored)
+{
+    ZoneMock z;
+
+    std::vector<std::string> inputs = {"fan0"};
+    ec::pidinfo initial;
+
+    std::unique_ptr<PIDController> p =
+        FanController::createFanPid(&z, "fan1", inputs, initial);
+    EXPECT_FALSE(p == nullptr);
+
+    ControllerState state;
+    state.kind = "pid";
+    state.initialized = true;
+    state.lastOutput = 10.0;
+    EXPECT_FALSE(p->setState(state));
+
+    state.kind = "fan";
+    state.integral = std::numeric_limits<double>::infinity();
+    EXPECT_FALSE(p->setState(state));
+
+    state.integral = 0.0;
+    state.direction = 7;
+    EXPECT_FALSE(p->setState(state));
+
+    EXPECT_FALSE(p->getState().initialized);
+}
+
+TEST(FanControllerTest, Process_DoesNotAllocate)
+{
+    // Once the first cycle has found its cache entries and sensors, a fan
+    // controller runs without touching the heap.
+
+    FakeFanZone z;
+    std::vector<std::string> inputs = {"fan0", "fan1", "fan2"};
+    std::vector<std::unique_ptr<FakeFan>> fans;
+    for (const auto& name : inputs)
+    {
+        fans.push_back(std::make_unique<FakeFan>(name));
+        z.cache[name] = {0.0, 4000.0};
+        z.outputs[name] = {0.0, 0.0};
+        z.sensors[name] = fans.back().get();
+    }
+    z.cache["fan1"].unscaled = 3500.0;
+
+    ec::pidinfo initial;
+    initial.ts = 1.0;
+    initial.proportionalCoeff = 0.01;
+    initial.integralLimit.max = 100.0;
+    initial.outLim.max = 100.0;
+
+    std::unique_ptr<PIDController> p =
+        FanController::createFanPid(&z, "fans", inputs, initial);
+    ASSERT_FALSE(p == nullptr);
+
+    p->process();
+
+    countAllocations = true;
+    allocations = 0;
+    for (int cycle = 0; cycle < 10; cycle++)
+    {
+        p->process();
+    }
+    countAllocations = false;
+
+    EXPECT_EQ(0U, allocations);
+    EXPECT_EQ(3500.0, p->getLastInput());
+    for (const auto& fan : fans)
+    {
+        EXPECT_EQ(11, fan->writes);
+        EXPECT_EQ(fan->written, z.outputs[fan->getName()].scaled);
+    }
+}
+
+TEST(FanControllerTest, OutputProc_FindsReplacedSensors)
+{
+    // When the zone's sensors change, the next cycle writes to the new ones.
+
+    FakeFanZone z;
+    std::vector<std::string> inputs = {"fan0"};
+    auto first = std::make_unique<FakeFan>("fan0");
+    auto second = std::make_unique<FakeFan>("fan0");
+    z.outputs["fan0"] = {0.0, 0.0};
+    z.sensors["fan0"] = first.get();
+
+    ec::pidinfo initial;
+    std::unique_ptr<PIDController> p =
+        FanController::createFanPid(&z, "fans", inputs, initial);
+    ASSERT_FALSE(p == nullptr);
+
+    p->outputProc(50.0);
+    EXPECT_EQ(1, first->writes);
+
+    z.sensors["fan0"] = second.get();
+    z.version++;
+    p->outputProc(60.0);
+    EXPECT_EQ(1, first->writes);
+    EXPECT_EQ(1, second->writes);
+    EXPECT_EQ(0.6, z.outputs["fan0"].scaled);
+}
+
 } // namespace
 } // namespace pid_control
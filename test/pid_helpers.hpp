@@ -0,0 +1,46 @@
+#pragma once
+
+#include "pid/ec/pid.hpp"
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace pid_control
+{
+
+/*
+ * count controllers with random coefficients and limits from gen.  The low
+ * bits of a controller's index pick which of the integral, derivative,
+ * feed-forward gain, negative and positive slew it uses, so the first 32
+ * cover every branch of ec::pid() and every ec::pidKernel(), and the next
+ * 32 repeat them with a longer sample time.  The limits are tight enough
+ * for the outputs to clamp.
+ */
+inline std::vector<ec::pid_info_t> makeRandomControllers(std::mt19937& gen,
+                                                         size_t count)
+{
+    std::uniform_real_distribution<double> coeff(-2.0, 2.0);
+    std::uniform_real_distribution<double> limit(0.0, 100.0);
+    std::vector<ec::pid_info_t> pids;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        ec::pid_info_t info = {};
+        info.ts = (i & 32) ? 1.0 : 0.1;
+        info.proportionalCoeff = coeff(gen);
+        info.integralCoeff = (i & 1) ? coeff(gen) : 0.0;
+        info.derivativeCoeff = (i & 2) ? coeff(gen) : 0.0;
+        info.feedFwdOffset = coeff(gen);
+        info.feedFwdGain = (i & 4) ? coeff(gen) : 0.0;
+        info.integralLimit = {-limit(gen), limit(gen)};
+        info.outLim = {-limit(gen), limit(gen)};
+        info.slewNeg = (i & 8) ? -limit(gen) : 0.0;
+        info.slewPos = (i & 16) ? limit(gen) : 0.0;
+        pids.push_back(info);
+    }
+
+    return pids;
+}
+
+} // namespace pid_control
@@ -275,6 +275,10 @@ TEST(ZoneFromJson, oneZoneOneStepwiseWithHysteresis)
     EXPECT_EQ(pidConfig[1]["temp1"].type, "stepwise");
     EXPECT_DOUBLE_EQ(pidConfig[1]["temp1"].stepwiseInfo.positiveHysteresis,
                      1.0);
+    EXPECT_EQ(pidConfig[1]["temp1"].stepwiseInfo.reading.size(), 20U);
+    EXPECT_EQ(pidConfig[1]["temp1"].stepwiseInfo.output.size(), 20U);
+    EXPECT_DOUBLE_EQ(pidConfig[1]["temp1"].stepwiseInfo.output[19], 6000.0);
+    EXPECT_FALSE(pidConfig[1]["temp1"].stepwiseInfo.interpolate);
 
     EXPECT_DOUBLE_EQ(zoneConfig[1].minThermalOutput, 3000.0);
 }
@@ -0,0 +1,67 @@
+#include "pid/ec/pid.hpp"
+#include "test/pid_helpers.hpp"
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace pid_control
+{
+namespace
+{
+
+TEST(PidKernelTest, KernelsMatchPid)
+{
+    // Each specialized kernel gives the same output and state as ec::pid()
+    // over many cycles.
+
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> value(-150.0, 150.0);
+
+    for (auto reference : makeRandomControllers(gen, 32))
+    {
+        ec::pid_info_t info = reference;
+        ec::pid_kernel_t kernel = ec::pidKernel(info);
+
+        for (int cycle = 0; cycle < 100; cycle++)
+        {
+            double input = value(gen);
+            double setpoint = value(gen);
+
+            EXPECT_EQ(ec::pid(&reference, input, setpoint),
+                      kernel(&info, input, setpoint));
+            EXPECT_EQ(reference.initialized, info.initialized);
+            EXPECT_EQ(reference.integral, info.integral);
+            EXPECT_EQ(reference.lastOutput, info.lastOutput);
+            EXPECT_EQ(reference.lastError, info.lastError);
+        }
+    }
+}
+
+TEST(PidKernelTest, KernelFollowsCoefficients)
+{
+    // Controllers using the same terms share a kernel, and using another
+    // term picks a different one.
+
+    ec::pid_info_t p = {};
+    p.proportionalCoeff = 1.0;
+
+    ec::pid_info_t p2 = {};
+    p2.proportionalCoeff = 2.0;
+    p2.feedFwdOffset = 5.0;
+
+    ec::pid_info_t pi = p;
+    pi.integralCoeff = 0.1;
+
+    ec::pid_info_t piSlew = pi;
+    piSlew.slewPos = 1.0;
+
+    EXPECT_EQ(ec::pidKernel(p), ec::pidKernel(p2));
+    EXPECT_NE(ec::pidKernel(p), ec::pidKernel(pi));
+    EXPECT_NE(ec::pidKernel(pi), ec::pidKernel(piSlew));
+}
+
+} // namespace
+} // namespace pid_control
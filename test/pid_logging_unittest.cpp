@@ -0,0 +1,70 @@
+#include "pid/ec/logging.hpp"
+#include "pid/ec/pid.hpp"
+#include "pid/tuning.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace pid_control
+{
+namespace
+{
+
+size_t countLines(const std::string& path)
+{
+    std::ifstream file(path);
+    std::string line;
+    size_t lines = 0;
+    while (std::getline(file, line))
+    {
+        lines++;
+    }
+    return lines;
+}
+
+TEST(PidLoggingTest, NoHandleWithoutCoreLogging)
+{
+    coreLoggingEnabled = false;
+    EXPECT_EQ(nullptr, ec::LogInit("fan1"));
+}
+
+TEST(PidLoggingTest, HandleLogsThroughPid)
+{
+    // A PID loop's handle is found once by name, and ec::pid() logs through
+    // it: the coefficients when the loop initializes, then its context.
+
+    char dir[] = "/tmp/pidlogXXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(dir));
+    loggingPath = dir;
+    coreLoggingEnabled = true;
+
+    ec::PidCoreLog* log = ec::LogInit("fan 2");
+    ASSERT_NE(nullptr, log);
+    EXPECT_EQ(log, ec::LogInit("fan 2"));
+    EXPECT_EQ(nullptr, ec::LogInit("fan2"));
+
+    ec::pid_info_t info = {};
+    info.ts = 1.0;
+    info.proportionalCoeff = 1.0;
+    info.outLim = {0.0, 100.0};
+
+    ec::pid(&info, 40.0, 50.0, log);
+    ec::pid(&info, 45.0, 50.0, log);
+
+    coreLoggingEnabled = false;
+    loggingPath.clear();
+
+    // Headers, then one line of coefficients and two of context.
+    EXPECT_EQ(2U, countLines(std::string(dir) + "/pidcoeffs.fan2"));
+    EXPECT_EQ(3U, countLines(std::string(dir) + "/pidcore.fan2"));
+
+    std::filesystem::remove_all(dir);
+}
+
+} // namespace
+} // namespace pid_control
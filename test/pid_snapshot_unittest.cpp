@@ -0,0 +1,111 @@
+#include "pid/controller.hpp"
+#include "pid/snapshot.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace pid_control
+{
+namespace
+{
+
+class SnapshotTest : public ::testing::Test
+{
+  protected:
+    SnapshotTest()
+    {
+        char dir[] = "/tmp/snapshot_unittest.XXXXXX";
+        _dir = mkdtemp(dir);
+        _path = _dir + "/state/state.json";
+    }
+
+    ~SnapshotTest() override
+    {
+        std::filesystem::remove_all(_dir);
+    }
+
+    static Snapshot makeSnapshot(std::chrono::steady_clock::time_point taken)
+    {
+        Snapshot snapshot;
+
+        ControllerState fan;
+        fan.kind = "fan";
+        fan.initialized = true;
+        fan.integral = 12.5;
+        fan.lastError = -3.0;
+        fan.lastInput = 4200.0;
+        fan.lastOutput = 45.0;
+        fan.direction = 1;
+
+        ControllerState stepwise;
+        stepwise.kind = "stepwise";
+
+        snapshot[0] = {taken, {{"fan pid", fan}, {"cpu stepwise", stepwise}}};
+        return snapshot;
+    }
+
+    std::string _dir;
+    std::string _path;
+};
+
+TEST_F(SnapshotTest, JsonRoundTripKeepsNaN)
+{
+    auto taken = std::chrono::steady_clock::now();
+    Snapshot snapshot = snapshotFromJson(snapshotToJson(makeSnapshot(taken)));
+
+    ASSERT_EQ(1U, snapshot.size());
+    const ZoneSnapshot& zone = snapshot.at(0);
+    EXPECT_EQ(taken, zone.taken);
+
+    const ControllerState& fan = zone.controllers.at("fan pid");
+    EXPECT_EQ("fan", fan.kind);
+    EXPECT_TRUE(fan.initialized);
+    EXPECT_EQ(12.5, fan.integral);
+    EXPECT_EQ(-3.0, fan.lastError);
+    EXPECT_EQ(4200.0, fan.lastInput);
+    EXPECT_EQ(45.0, fan.lastOutput);
+    EXPECT_EQ(1, fan.direction);
+
+    const ControllerState& stepwise = zone.controllers.at("cpu stepwise");
+    EXPECT_EQ("stepwise", stepwise.kind);
+    EXPECT_TRUE(std::isnan(stepwise.lastInput));
+    EXPECT_TRUE(std::isnan(stepwise.lastOutput));
+}
+
+TEST_F(SnapshotTest, WriteThenReadFreshSnapshot)
+{
+    writeSnapshot(_path, makeSnapshot(std::chrono::steady_clock::now()));
+
+    Snapshot snapshot = readSnapshot(_path, std::chrono::seconds(30));
+
+    ASSERT_EQ(1U, snapshot.size());
+    EXPECT_EQ(2U, snapshot.at(0).controllers.size());
+}
+
+TEST_F(SnapshotTest, StaleZonesAreDropped)
+{
+    writeSnapshot(_path, makeSnapshot(std::chrono::steady_clock::now() -
+                                      std::chrono::minutes(5)));
+
+    EXPECT_TRUE(readSnapshot(_path, std::chrono::seconds(30)).empty());
+}
+
+TEST_F(SnapshotTest, MissingOrCorruptFileGivesEmptySnapshot)
+{
+    EXPECT_TRUE(readSnapshot(_path, std::chrono::seconds(30)).empty());
+
+    std::filesystem::create_directories(_dir + "/state");
+    std::ofstream(_path) << "{\"version\": 1, \"zones\": [{\"id\": ";
+
+    EXPECT_TRUE(readSnapshot(_path, std::chrono::seconds(30)).empty());
+}
+
+} // namespace
+} // namespace pid_control
@@ -3,7 +3,9 @@
 #include "pid/stepwisecontroller.hpp"
 #include "test/zone_mock.hpp"
 
-#include <limits>
+#include <cmath>
+#include <cstddef>
+#include <exception>
 #include <memory>
 #include <string>
 #include <vector>
@@ -29,11 +31,8 @@ TEST(StepwiseControllerTest, HysteresisTestPositive)
     ec::StepwiseInfo initial;
     initial.negativeHysteresis = 3.0;
     initial.positiveHysteresis = 2.0;
-    initial.reading[0] = 20.0;
-    initial.reading[1] = 30.0;
-    initial.reading[2] = std::numeric_limits<double>::quiet_NaN();
-    initial.output[0] = 40.0;
-    initial.output[1] = 60.0;
+    initial.reading = {20.0, 30.0};
+    initial.output = {40.0, 60.0};
     initial.isCeiling = false;
 
     std::unique_ptr<Controller> p =
@@ -65,11 +64,8 @@ TEST(StepwiseControllerTest, HysteresisTestNegative)
     ec::StepwiseInfo initial;
     initial.negativeHysteresis = 3.0;
     initial.positiveHysteresis = 2.0;
-    initial.reading[0] = 20.0;
-    initial.reading[1] = 30.0;
-    initial.reading[2] = std::numeric_limits<double>::quiet_NaN();
-    initial.output[0] = 40.0;
-    initial.output[1] = 60.0;
+    initial.reading = {20.0, 30.0};
+    initial.output = {40.0, 60.0};
     initial.isCeiling = false;
 
     std::unique_ptr<Controller> p =
@@ -91,5 +87,118 @@ TEST(StepwiseControllerTest, HysteresisTestNegative)
     }
 }
 
+TEST(StepwiseControllerTest, RestoredStateKeepsHysteresis)
+{
+    // A rebuilt controller given the old one's state holds the last output
+    // instead of recomputing it on the first pass.
+
+    ZoneMock z;
+
+    std::vector<std::string> inputs = {"test"};
+    ec::StepwiseInfo initial;
+    initial.negativeHysteresis = 3.0;
+    initial.positiveHysteresis = 2.0;
+    initial.reading = {20.0, 30.0};
+    initial.output = {40.0, 60.0};
+    initial.isCeiling = false;
+
+    std::unique_ptr<Controller> old =
+        StepwiseController::createStepwiseController(&z, "foo", inputs,
+                                                     initial);
+    std::unique_ptr<Controller> p =
+        StepwiseController::createStepwiseController(&z, "foo", inputs,
+                                                     initial);
+
+    EXPECT_CALL(z, getCachedValue(StrEq("test")))
+        .WillOnce(Return(31.0))  // return 60
+        .WillOnce(Return(29.0)); // within hysteresis, still 60
+
+    EXPECT_CALL(z, addSetPoint(60.0, "foo")).Times(2);
+
+    old->process();
+    ControllerState state = old->getState();
+    EXPECT_EQ("stepwise", state.kind);
+    EXPECT_TRUE(p->setState(state));
+    p->process();
+
+    ControllerState pidState;
+    pidState.kind = "pid";
+    EXPECT_FALSE(p->setState(pidState));
+}
+
+TEST(StepwiseControllerTest, UnsortedPointsAreSorted)
+{
+    // The factory sorts the points, and rejects unmatched outputs.
+
+    ZoneMock z;
+
+    std::vector<std::string> inputs = {"test"};
+    ec::StepwiseInfo initial;
+    initial.reading = {30.0, 20.0, 40.0};
+    initial.output = {60.0, 40.0, 80.0};
+
+    std::unique_ptr<Controller> p =
+        StepwiseController::createStepwiseController(&z, "foo", inputs,
+                                                     initial);
+
+    auto& info = static_cast<StepwiseController*>(p.get())->getStepwiseInfo();
+    EXPECT_EQ(std::vector<double>({20.0, 30.0, 40.0}), info.reading);
+    EXPECT_EQ(std::vector<double>({40.0, 60.0, 80.0}), info.output);
+
+    initial.output.pop_back();
+    EXPECT_THROW(StepwiseController::createStepwiseController(&z, "foo",
+                                                              inputs, initial),
+                 std::exception);
+}
+
+TEST(StepwiseTest, LookupMatchesLinearScan)
+{
+    // A fine-grained curve with repeated readings gives what scanning the
+    // points in order does.
+
+    ec::StepwiseInfo info;
+    for (size_t ii = 0; ii < 150; ii++)
+    {
+        info.reading.push_back(20.0 + (ii / 2) * 0.5);
+        info.output.push_back(ii);
+    }
+
+    auto scan = [&info](double input) {
+        double value = info.output[0];
+        for (size_t ii = 1; ii < info.reading.size(); ii++)
+        {
+            if (info.reading[ii] > input)
+            {
+                break;
+            }
+            value = info.output[ii];
+        }
+        return value;
+    };
+
+    for (double input = 0.0; input < 80.0; input += 0.25)
+    {
+        EXPECT_EQ(scan(input), ec::stepwise(info, input)) << input;
+    }
+
+    EXPECT_TRUE(std::isnan(ec::stepwise(ec::StepwiseInfo{}, 30.0)));
+}
+
+TEST(StepwiseTest, InterpolatesBetweenPoints)
+{
+    ec::StepwiseInfo info;
+    info.reading = {20.0, 30.0, 40.0};
+    info.output = {40.0, 60.0, 100.0};
+    info.interpolate = true;
+
+    EXPECT_EQ(40.0, ec::stepwise(info, 10.0));
+    EXPECT_EQ(40.0, ec::stepwise(info, 20.0));
+    EXPECT_EQ(50.0, ec::stepwise(info, 25.0));
+    EXPECT_EQ(60.0, ec::stepwise(info, 30.0));
+    EXPECT_EQ(90.0, ec::stepwise(info, 37.5));
+    EXPECT_EQ(100.0, ec::stepwise(info, 40.0));
+    EXPECT_EQ(100.0, ec::stepwise(info, 50.0));
+}
+
 } // namespace
 } // namespace pid_control
@@ -1,10 +1,13 @@
 #include "conf.hpp"
+#include "interfaces.hpp"
 #include "pid/ec/pid.hpp"
 #include "pid/pidcontroller.hpp"
 #include "pid/thermalcontroller.hpp"
 #include "test/zone_mock.hpp"
 
+#include <cstddef>
 #include <exception>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
@@ -202,6 +205,104 @@ TEST(ThermalControllerTest, InputProc_MultipleInputsTempToMargin)
     EXPECT_EQ(3.0, p->inputProc());
 }
 
+TEST(ThermalControllerTest, InputProc_ReadsCacheSlots)
+{
+    // With cache entries from the zone, inputProc reads them directly
+    // instead of looking the values up by name.
+
+    ZoneMock z;
+
+    ValueCacheEntry cpu0 = {50.0, 50.0};
+    ValueCacheEntry cpu1 = {60.0, 60.0};
+    EXPECT_CALL(z, getCachedValueSlot(StrEq("cpu0"))).WillOnce(Return(&cpu0));
+    EXPECT_CALL(z, getCachedValueSlot(StrEq("cpu1"))).WillOnce(Return(&cpu1));
+    EXPECT_CALL(z, getCachedValue(_)).Times(0);
+
+    std::vector<pid_control::conf::SensorInput> inputs = {{"cpu0"}, {"cpu1"}};
+    ec::pidinfo initial;
+
+    std::unique_ptr<PIDController> p = ThermalController::createThermalPid(
+        &z, "therm1", inputs, 10.0, initial, ThermalType::absolute);
+
+    EXPECT_EQ(60.0, p->inputProc());
+
+    cpu0.scaled = 70.0;
+    EXPECT_EQ(70.0, p->inputProc());
+}
+
+TEST(ThermalControllerTest, InputProc_LeaderPublishedOnce)
+{
+    // However many times the minimum changes over the inputs, the leader is
+    // published once, with the final value.
+
+    ZoneMock z;
+
+    std::vector<pid_control::conf::SensorInput> inputs = {
+        {"margin0"}, {"margin1"}, {"margin2"}, {"margin3"}};
+    ec::pidinfo initial;
+
+    std::unique_ptr<PIDController> p = ThermalController::createThermalPid(
+        &z, "therm1", inputs, 10.0, initial, ThermalType::margin);
+
+    EXPECT_CALL(z, getCachedValue(StrEq("margin0"))).WillOnce(Return(9.0));
+    EXPECT_CALL(z, getCachedValue(StrEq("margin1"))).WillOnce(Return(7.0));
+    EXPECT_CALL(z, getCachedValue(StrEq("margin2"))).WillOnce(Return(5.0));
+    EXPECT_CALL(z, getCachedValue(StrEq("margin3"))).WillOnce(Return(5.0));
+    EXPECT_CALL(z, updateThermalPowerDebugInterface(_, _, _, _)).Times(0);
+    EXPECT_CALL(z, updateThermalPowerDebugInterface("therm1", "margin2", 5.0,
+                                                    0.0));
+
+    EXPECT_EQ(5.0, p->inputProc());
+}
+
+TEST(ThermalControllerTest, InputProc_ManySummationInputs)
+{
+    // Dozens of power inputs are summed, skipping ones that aren't finite,
+    // and the last that added to the sum leads.
+
+    ZoneMock z;
+
+    std::vector<pid_control::conf::SensorInput> inputs;
+    std::vector<ValueCacheEntry> values(43);
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        std::string name = "power" + std::to_string(i);
+        inputs.push_back({name});
+        values[i] = {static_cast<double>(i), 0.0};
+        EXPECT_CALL(z, getCachedValueSlot(StrEq(name)))
+            .WillOnce(Return(&values[i]));
+    }
+    values[5].scaled = std::numeric_limits<double>::quiet_NaN();
+    values[41].scaled = std::numeric_limits<double>::infinity();
+    values[42].scaled = 0.0;
+
+    ec::pidinfo initial;
+    std::unique_ptr<PIDController> p = ThermalController::createThermalPid(
+        &z, "therm1", inputs, 10.0, initial, ThermalType::summation);
+
+    // 0 + 1 + ... + 40, less 5
+    EXPECT_CALL(z, updateThermalPowerDebugInterface("therm1", "power40",
+                                                    815.0, 0.0));
+
+    EXPECT_EQ(815.0, p->inputProc());
+}
+
+TEST(ThermalControllerTest, VerifyFactoryFailsWithBadTempToMargin)
+{
+    // A TempToMargin input without a finite Tjmax is rejected when the
+    // controller is built.
+
+    ZoneMock z;
+
+    std::vector<pid_control::conf::SensorInput> inputs = {
+        {"absolute0", std::numeric_limits<double>::quiet_NaN(), true}};
+    ec::pidinfo initial;
+
+    EXPECT_THROW(ThermalController::createThermalPid(
+                     &z, "therm1", inputs, 10.0, initial, ThermalType::margin),
+                 std::exception);
+}
+
 TEST(ThermalControllerTest, NegHysteresis_BehavesAsExpected)
 {
     // This test verifies Negative hysteresis behaves as expected by
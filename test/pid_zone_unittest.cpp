@@ -1,8 +1,12 @@
+#include "clock.hpp"
 #include "conf.hpp"
 #include "failsafeloggers/builder.hpp"
 #include "interfaces.hpp"
 #include "pid/ec/pid.hpp"
+#include "pid/ec/stepwise.hpp"
 #include "pid/pidcontroller.hpp"
+#include "pid/stepwisecontroller.hpp"
+#include "pid/thermalcontroller.hpp"
 #include "pid/zone.hpp"
 #include "pid/zone_interface.hpp"
 #include "sensors/manager.hpp"
@@ -381,7 +385,7 @@ TEST_F(PidZoneTest, ThermalInputs_FailsafeToValid_ReadsSensors)
     buildFailsafeLoggers(empty_zone_map, 0);
 
     std::string name1 = "temp1";
-    int64_t timeout = 1;
+    int64_t timeout = 1000;
 
     std::unique_ptr<Sensor> sensor1 =
         std::make_unique<SensorMock>(name1, timeout);
@@ -410,12 +414,12 @@ TEST_F(PidZoneTest, ThermalInputs_FailsafeToValid_ReadsSensors)
 
     ReadReturn r1;
     r1.value = 10.0;
-    r1.updated = std::chrono::high_resolution_clock::now();
+    r1.updated = std::chrono::steady_clock::now();
     EXPECT_CALL(*sensor_ptr1, read()).WillOnce(Return(r1));
 
     ReadReturn r2;
     r2.value = 11.0;
-    r2.updated = std::chrono::high_resolution_clock::now();
+    r2.updated = std::chrono::steady_clock::now();
     EXPECT_CALL(*sensor_ptr2, read()).WillOnce(Return(r2));
 
     // Read the sensors, this will put the values into the cache.
@@ -437,7 +441,7 @@ TEST_F(PidZoneTest, FanInputTest_VerifiesFanValuesCached)
     buildFailsafeLoggers(empty_zone_map, 0);
 
     std::string name1 = "fan1";
-    int64_t timeout = 2;
+    int64_t timeout = 2000;
 
     std::unique_ptr<Sensor> sensor1 =
         std::make_unique<SensorMock>(name1, timeout);
@@ -463,12 +467,12 @@ TEST_F(PidZoneTest, FanInputTest_VerifiesFanValuesCached)
 
     ReadReturn r1;
     r1.value = 10.0;
-    r1.updated = std::chrono::high_resolution_clock::now();
+    r1.updated = std::chrono::steady_clock::now();
     EXPECT_CALL(*sensor_ptr1, read()).WillOnce(Return(r1));
 
     ReadReturn r2;
     r2.value = 11.0;
-    r2.updated = std::chrono::high_resolution_clock::now();
+    r2.updated = std::chrono::steady_clock::now();
     EXPECT_CALL(*sensor_ptr2, read()).WillOnce(Return(r2));
 
     // Method under test will read through each fan sensor for the zone and
@@ -488,7 +492,7 @@ TEST_F(PidZoneTest, ThermalInput_ValueTimeoutEntersFailSafeMode)
     std::unordered_map<int64_t, std::shared_ptr<ZoneInterface>> empty_zone_map;
     buildFailsafeLoggers(empty_zone_map, 0);
 
-    int64_t timeout = 1;
+    int64_t timeout = 1000;
 
     std::string name1 = "temp1";
     std::unique_ptr<Sensor> sensor1 =
@@ -517,12 +521,12 @@ TEST_F(PidZoneTest, ThermalInput_ValueTimeoutEntersFailSafeMode)
 
     ReadReturn r1;
     r1.value = 10.0;
-    r1.updated = std::chrono::high_resolution_clock::now();
+    r1.updated = std::chrono::steady_clock::now();
     EXPECT_CALL(*sensor_ptr1, read()).WillOnce(Return(r1));
 
     ReadReturn r2;
     r2.value = 11.0;
-    r2.updated = std::chrono::high_resolution_clock::now();
+    r2.updated = std::chrono::steady_clock::now();
     EXPECT_CALL(*sensor_ptr2, read()).WillOnce(Return(r2));
 
     zone->updateSensors();
@@ -532,7 +536,7 @@ TEST_F(PidZoneTest, ThermalInput_ValueTimeoutEntersFailSafeMode)
     // sensor1 will have an updated field older than its timeout value, but
     // sensor2 will be fine. :D
     r1.updated -= std::chrono::seconds(3);
-    r2.updated = std::chrono::high_resolution_clock::now();
+    r2.updated = std::chrono::steady_clock::now();
 
     EXPECT_CALL(*sensor_ptr1, read()).WillOnce(Return(r1));
     EXPECT_CALL(*sensor_ptr2, read()).WillOnce(Return(r2));
@@ -543,6 +547,47 @@ TEST_F(PidZoneTest, ThermalInput_ValueTimeoutEntersFailSafeMode)
     EXPECT_TRUE(zone->getFailSafeMode());
 }
 
+TEST_F(PidZoneTest, ThermalInput_TimeoutFollowsClock)
+{
+    // Sensor staleness is measured against the installed clock, so a reading
+    // times out once the clock moves past it, without any real time passing.
+
+    // Disable failsafe logger for the unit test.
+    std::unordered_map<int64_t, std::shared_ptr<ZoneInterface>> empty_zone_map;
+    buildFailsafeLoggers(empty_zone_map, 0);
+
+    ManualClock clock;
+    ScopedClock useClock(clock);
+
+    int64_t timeout = 1000;
+
+    std::string name1 = "temp1";
+    std::unique_ptr<Sensor> sensor1 =
+        std::make_unique<SensorMock>(name1, timeout);
+    SensorMock* sensor_ptr1 = reinterpret_cast<SensorMock*>(sensor1.get());
+
+    std::string type = "unchecked";
+    mgr->addSensor(type, name1, std::move(sensor1));
+    zone->addThermalInput(name1, false);
+    zone->initializeCache();
+
+    ReadReturn r1;
+    r1.value = 10.0;
+    r1.updated = clockNow();
+    EXPECT_CALL(*sensor_ptr1, read()).WillRepeatedly(Return(r1));
+
+    zone->updateSensors();
+    EXPECT_FALSE(zone->getFailSafeMode());
+
+    clock.advance(std::chrono::milliseconds(timeout / 2));
+    zone->updateSensors();
+    EXPECT_FALSE(zone->getFailSafeMode());
+
+    clock.advance(std::chrono::milliseconds(timeout));
+    zone->updateSensors();
+    EXPECT_TRUE(zone->getFailSafeMode());
+}
+
 TEST_F(PidZoneTest, ThermalInput_MissingIsAcceptableNoFailSafe)
 {
     // This is similar to the above test, but because missingIsAcceptable
@@ -554,7 +599,7 @@ TEST_F(PidZoneTest, ThermalInput_MissingIsAcceptableNoFailSafe)
     std::unordered_map<int64_t, std::shared_ptr<ZoneInterface>> empty_zone_map;
     buildFailsafeLoggers(empty_zone_map, 0);
 
-    int64_t timeout = 1;
+    int64_t timeout = 1000;
 
     std::string name1 = "temp1";
     std::unique_ptr<Sensor> sensor1 =
@@ -589,7 +634,7 @@ TEST_F(PidZoneTest, ThermalInput_MissingIsAcceptableNoFailSafe)
 
     ReadReturn r2;
     r2.value = 11.0;
-    r2.updated = std::chrono::high_resolution_clock::now();
+    r2.updated = std::chrono::steady_clock::now();
     EXPECT_CALL(*sensor_ptr2, read()).WillOnce(Return(r2));
 
     zone->updateSensors();
@@ -599,7 +644,7 @@ TEST_F(PidZoneTest, ThermalInput_MissingIsAcceptableNoFailSafe)
     EXPECT_FALSE(zone->getFailSafeMode());
 
     r1.value = 10.0;
-    r1.updated = std::chrono::high_resolution_clock::now();
+    r1.updated = std::chrono::steady_clock::now();
 
     EXPECT_CALL(*sensor_ptr1, read()).WillOnce(Return(r1));
     EXPECT_CALL(*sensor_ptr2, read()).WillOnce(Return(r2));
@@ -612,7 +657,7 @@ TEST_F(PidZoneTest, ThermalInput_MissingIsAcceptableNoFailSafe)
     // sensor1 will have an updated field older than its timeout value, but
     // sensor2 will be fine. :D
     r1.updated -= std::chrono::seconds(3);
-    r2.updated = std::chrono::high_resolution_clock::now();
+    r2.updated = std::chrono::steady_clock::now();
 
     EXPECT_CALL(*sensor_ptr1, read()).WillOnce(Return(r1));
     EXPECT_CALL(*sensor_ptr2, read()).WillOnce(Return(r2));
@@ -624,7 +669,7 @@ TEST_F(PidZoneTest, ThermalInput_MissingIsAcceptableNoFailSafe)
 
     // Do the same thing, but for the opposite sensors: r1 is good,
     // but r2 is set to some time in the past.
-    r1.updated = std::chrono::high_resolution_clock::now();
+    r1.updated = std::chrono::steady_clock::now();
     r2.updated -= std::chrono::seconds(3);
 
     EXPECT_CALL(*sensor_ptr1, read()).WillOnce(Return(r1));
@@ -635,8 +680,8 @@ TEST_F(PidZoneTest, ThermalInput_MissingIsAcceptableNoFailSafe)
     // have MissingIsAcceptable set true, it is still subject to failsafe.
     EXPECT_TRUE(zone->getFailSafeMode());
 
-    r1.updated = std::chrono::high_resolution_clock::now();
-    r2.updated = std::chrono::high_resolution_clock::now();
+    r1.updated = std::chrono::steady_clock::now();
+    r2.updated = std::chrono::steady_clock::now();
 
     EXPECT_CALL(*sensor_ptr1, read()).WillOnce(Return(r1));
     EXPECT_CALL(*sensor_ptr2, read()).WillOnce(Return(r2));
@@ -655,7 +700,7 @@ TEST_F(PidZoneTest, FanInputTest_FailsafeToValid_ReadsSensors)
     buildFailsafeLoggers(empty_zone_map, 0);
 
     std::string name1 = "fan1";
-    int64_t timeout = 2;
+    int64_t timeout = 2000;
 
     std::unique_ptr<Sensor> sensor1 =
         std::make_unique<SensorMock>(name1, timeout);
@@ -684,12 +729,12 @@ TEST_F(PidZoneTest, FanInputTest_FailsafeToValid_ReadsSensors)
 
     ReadReturn r1;
     r1.value = 10.0;
-    r1.updated = std::chrono::high_resolution_clock::now();
+    r1.updated = std::chrono::steady_clock::now();
     EXPECT_CALL(*sensor_ptr1, read()).WillOnce(Return(r1));
 
     ReadReturn r2;
     r2.value = 11.0;
-    r2.updated = std::chrono::high_resolution_clock::now();
+    r2.updated = std::chrono::steady_clock::now();
     EXPECT_CALL(*sensor_ptr2, read()).WillOnce(Return(r2));
 
     // Method under test will read through each fan sensor for the zone and
@@ -712,7 +757,7 @@ TEST_F(PidZoneTest, FanInputTest_ValueTimeoutEntersFailSafeMode)
     buildFailsafeLoggers(empty_zone_map, 0);
 
     std::string name1 = "fan1";
-    int64_t timeout = 2;
+    int64_t timeout = 2000;
 
     std::unique_ptr<Sensor> sensor1 =
         std::make_unique<SensorMock>(name1, timeout);
@@ -741,12 +786,12 @@ TEST_F(PidZoneTest, FanInputTest_ValueTimeoutEntersFailSafeMode)
 
     ReadReturn r1;
     r1.value = 10.0;
-    r1.updated = std::chrono::high_resolution_clock::now();
+    r1.updated = std::chrono::steady_clock::now();
     EXPECT_CALL(*sensor_ptr1, read()).WillOnce(Return(r1));
 
     ReadReturn r2;
     r2.value = 11.0;
-    r2.updated = std::chrono::high_resolution_clock::now();
+    r2.updated = std::chrono::steady_clock::now();
     EXPECT_CALL(*sensor_ptr2, read()).WillOnce(Return(r2));
 
     // Method under test will read through each fan sensor for the zone and
@@ -757,7 +802,7 @@ TEST_F(PidZoneTest, FanInputTest_ValueTimeoutEntersFailSafeMode)
     EXPECT_FALSE(zone->getFailSafeMode());
 
     r1.updated -= std::chrono::seconds(3);
-    r2.updated = std::chrono::high_resolution_clock::now();
+    r2.updated = std::chrono::steady_clock::now();
 
     EXPECT_CALL(*sensor_ptr1, read()).WillOnce(Return(r1));
     EXPECT_CALL(*sensor_ptr2, read()).WillOnce(Return(r2));
@@ -766,6 +811,45 @@ TEST_F(PidZoneTest, FanInputTest_ValueTimeoutEntersFailSafeMode)
     EXPECT_TRUE(zone->getFailSafeMode());
 }
 
+TEST_F(PidZoneTest, FanInputTest_SubSecondTimeoutEntersFailSafeMode)
+{
+    // A fan with a 500ms timeout that stopped updating 900ms ago is stale,
+    // even though it hasn't been a whole second.
+
+    // Disable failsafe logger for the unit test.
+    std::unordered_map<int64_t, std::shared_ptr<ZoneInterface>> empty_zone_map;
+    buildFailsafeLoggers(empty_zone_map, 0);
+
+    std::string name1 = "fan1";
+    int64_t timeout = 500;
+
+    std::unique_ptr<Sensor> sensor1 =
+        std::make_unique<SensorMock>(name1, timeout);
+    SensorMock* sensor_ptr1 = reinterpret_cast<SensorMock*>(sensor1.get());
+
+    std::string type = "unchecked";
+    mgr->addSensor(type, name1, std::move(sensor1));
+    EXPECT_EQ(mgr->getSensor(name1), sensor_ptr1);
+
+    zone->addFanInput(name1, false);
+    zone->initializeCache();
+    EXPECT_TRUE(zone->getFailSafeMode());
+
+    ReadReturn r1;
+    r1.value = 10.0;
+    r1.updated = std::chrono::steady_clock::now();
+    EXPECT_CALL(*sensor_ptr1, read()).WillOnce(Return(r1));
+
+    zone->updateFanTelemetry();
+    EXPECT_FALSE(zone->getFailSafeMode());
+
+    r1.updated -= std::chrono::milliseconds(900);
+    EXPECT_CALL(*sensor_ptr1, read()).WillOnce(Return(r1));
+
+    zone->updateFanTelemetry();
+    EXPECT_TRUE(zone->getFailSafeMode());
+}
+
 TEST_F(PidZoneTest, GetSensorTest_ReturnsExpected)
 {
     // One can grab a sensor from the manager through the zone.
@@ -774,7 +858,7 @@ TEST_F(PidZoneTest, GetSensorTest_ReturnsExpected)
     std::unordered_map<int64_t, std::shared_ptr<ZoneInterface>> empty_zone_map;
     buildFailsafeLoggers(empty_zone_map, 0);
 
-    int64_t timeout = 1;
+    int64_t timeout = 1000;
 
     std::string name1 = "temp1";
     std::unique_ptr<Sensor> sensor1 =
@@ -815,6 +899,272 @@ TEST_F(PidZoneTest, AddThermalPIDTest_VerifiesThermalPIDsProcessed)
     zone->processThermals();
 }
 
+TEST_F(PidZoneTest, ThermalSegments_RunEachControllerOnce)
+{
+    // Stepwise controllers and ceilings run in their own segments, and a
+    // controller of any other type, here a mock, through Controller.  Each
+    // runs once a cycle.
+
+    // Disable failsafe logger for the unit test.
+    std::unordered_map<int64_t, std::shared_ptr<ZoneInterface>> empty_zone_map;
+    buildFailsafeLoggers(empty_zone_map, 0);
+
+    int64_t timeout = 1;
+    std::unique_ptr<Sensor> sensor =
+        std::make_unique<SensorMock>(sensorname, timeout);
+    SensorMock* sensor_ptr = reinterpret_cast<SensorMock*>(sensor.get());
+    mgr->addSensor(sensorType, sensorname, std::move(sensor));
+    zone->addThermalInput(sensorname, false);
+    zone->initializeCache();
+
+    ReadReturn r;
+    r.value = 45.0;
+    r.updated = std::chrono::steady_clock::now();
+    EXPECT_CALL(*sensor_ptr, read()).WillOnce(Return(r));
+    zone->updateSensors();
+
+    auto bus_mock_enable = sdbusplus::get_mocked_new(&sdbus_mock_enable);
+    EXPECT_CALL(sdbus_mock_mode, sd_bus_emit_properties_changed_strv(
+                                     IsNull(), StrEq(pidsensorpath.c_str()),
+                                     StrEq(ObjectEnable::interface), NotNull()))
+        .Times(::testing::AnyNumber())
+        .WillRepeatedly(Return(0));
+    zone->addPidControlProcess(sensorname, sensorType, setpoint,
+                               bus_mock_enable, pidsensorpath.c_str(), defer);
+
+    ec::StepwiseInfo info;
+    info.reading = {0.0, 40.0};
+    info.output = {2000.0, 3000.0};
+    zone->addThermalPID(StepwiseController::createStepwiseController(
+        zone.get(), sensorname, {sensorname}, info));
+
+    info.isCeiling = true;
+    info.output = {2000.0, 2500.0};
+    zone->addThermalPID(StepwiseController::createStepwiseController(
+        zone.get(), "ceiling1", {sensorname}, info));
+
+    std::unique_ptr<PIDController> tpid =
+        std::make_unique<ControllerMock>("thermal1", zone.get());
+    ControllerMock* tmock = reinterpret_cast<ControllerMock*>(tpid.get());
+    zone->addThermalPID(std::move(tpid));
+
+    EXPECT_CALL(*tmock, setptProc()).WillOnce(Return(10.0));
+    EXPECT_CALL(*tmock, inputProc()).WillOnce(Return(11.0));
+    EXPECT_CALL(*tmock, outputProc(_));
+
+    zone->processThermals();
+
+    // The stepwise setpoint, held down by the ceiling.
+    zone->determineMaxSetPointRequest();
+    EXPECT_EQ(2500.0, zone->getMaxSetPointRequest());
+}
+
+TEST_F(PidZoneTest, ThermalSegments_TieGoesToFirstConfigured)
+{
+    // The controllers run in configuration order across their segments, so
+    // of two with the same setpoint the first configured leads.
+
+    std::unordered_map<int64_t, std::shared_ptr<ZoneInterface>> empty_zone_map;
+    buildFailsafeLoggers(empty_zone_map, 0);
+
+    int64_t timeout = 1;
+    std::unique_ptr<Sensor> sensor =
+        std::make_unique<SensorMock>(sensorname, timeout);
+    SensorMock* sensor_ptr = reinterpret_cast<SensorMock*>(sensor.get());
+    mgr->addSensor(sensorType, sensorname, std::move(sensor));
+    zone->addThermalInput(sensorname, false);
+    zone->initializeCache();
+
+    ReadReturn r;
+    r.value = 45.0;
+    r.updated = std::chrono::steady_clock::now();
+    EXPECT_CALL(*sensor_ptr, read()).WillOnce(Return(r));
+    zone->updateSensors();
+
+    auto bus_mock_enable = sdbusplus::get_mocked_new(&sdbus_mock_enable);
+    EXPECT_CALL(sdbus_mock_mode,
+                sd_bus_emit_properties_changed_strv(
+                    IsNull(), _, StrEq(ObjectEnable::interface), NotNull()))
+        .Times(::testing::AnyNumber())
+        .WillRepeatedly(Return(0));
+    for (const char* name : {"zeta", "alpha"})
+    {
+        std::string path = "/xyz/openbmc_project/settings/fanctrl/zone1/";
+        zone->addPidControlProcess(name, sensorType, setpoint, bus_mock_enable,
+                                   (path + name).c_str(), defer);
+    }
+
+    ec::StepwiseInfo step;
+    step.reading = {0.0, 40.0};
+    step.output = {2000.0, 3000.0};
+    zone->addThermalPID(StepwiseController::createStepwiseController(
+        zone.get(), "zeta", {sensorname}, step));
+
+    // All feed-forward, to the stepwise controller's output.
+    ec::pidinfo info;
+    info.ts = 1.0;
+    info.feedFwdGain = 1.0;
+    info.feedFwdOffset = 3000.0 - setpoint;
+    info.outLim = {0.0, 5000.0};
+    zone->addThermalPID(ThermalController::createThermalPid(
+        zone.get(), "alpha", {{sensorname}}, setpoint, info,
+        ThermalType::absolute));
+
+    zone->processThermals();
+    zone->determineMaxSetPointRequest();
+
+    EXPECT_EQ(3000.0, zone->getMaxSetPointRequest());
+    EXPECT_EQ("zeta", zone->leader());
+}
+
+TEST_F(PidZoneTest, ThermalSegments_ThermalControllersMatchProcess)
+{
+    // Margin, absolute and summation controllers, interleaved with a
+    // stepwise one, get the same outputs and state from processThermals()
+    // as from running each through process().
+
+    std::unordered_map<int64_t, std::shared_ptr<ZoneInterface>> empty_zone_map;
+    buildFailsafeLoggers(empty_zone_map, 0);
+
+    std::vector<std::string> sensors = {"temp1", "temp2"};
+    std::vector<double> values = {45.0, 52.0};
+    for (size_t i = 0; i < sensors.size(); i++)
+    {
+        std::unique_ptr<Sensor> sensor =
+            std::make_unique<SensorMock>(sensors[i], 1);
+        SensorMock* sensor_ptr = reinterpret_cast<SensorMock*>(sensor.get());
+        mgr->addSensor(sensorType, sensors[i], std::move(sensor));
+        zone->addThermalInput(sensors[i], false);
+
+        ReadReturn r;
+        r.value = values[i];
+        r.updated = std::chrono::steady_clock::now();
+        EXPECT_CALL(*sensor_ptr, read()).WillOnce(Return(r));
+    }
+    zone->initializeCache();
+    zone->updateSensors();
+
+    struct Config
+    {
+        std::string name;
+        ThermalType type;
+        double setpoint;
+    };
+    std::vector<Config> configs = {
+        {"margin1", ThermalType::margin, 10.0},
+        {"absolute1", ThermalType::absolute, 50.0},
+        {"summation1", ThermalType::summation, 90.0},
+        {"margin2", ThermalType::margin, 40.0},
+    };
+
+    auto bus_mock_enable = sdbusplus::get_mocked_new(&sdbus_mock_enable);
+    EXPECT_CALL(sdbus_mock_mode,
+                sd_bus_emit_properties_changed_strv(
+                    IsNull(), _, StrEq(ObjectEnable::interface), NotNull()))
+        .Times(::testing::AnyNumber())
+        .WillRepeatedly(Return(0));
+    std::string path = "/xyz/openbmc_project/settings/fanctrl/zone1/";
+    for (const auto& config : configs)
+    {
+        zone->addPidControlProcess(config.name, sensorType, config.setpoint,
+                                   bus_mock_enable,
+                                   (path + config.name).c_str(), defer);
+    }
+    zone->addPidControlProcess("stepwise1", sensorType, setpoint,
+                               bus_mock_enable, (path + "stepwise1").c_str(),
+                               defer);
+
+    ec::pidinfo info;
+    info.ts = 1.0;
+    info.proportionalCoeff = -20.0;
+    info.integralCoeff = -2.0;
+    info.integralLimit = {0.0, 5000.0};
+    info.outLim = {1000.0, 9000.0};
+
+    std::vector<PIDController*> controllers;
+    std::vector<std::unique_ptr<PIDController>> references;
+    for (size_t i = 0; i < configs.size(); i++)
+    {
+        std::vector<conf::SensorInput> inputs = {{sensors[0]}, {sensors[1]}};
+        auto pid = ThermalController::createThermalPid(
+            zone.get(), configs[i].name, inputs, configs[i].setpoint, info,
+            configs[i].type);
+        controllers.push_back(pid.get());
+        zone->addThermalPID(std::move(pid));
+        references.push_back(ThermalController::createThermalPid(
+            zone.get(), configs[i].name, inputs, configs[i].setpoint, info,
+            configs[i].type));
+
+        if (i == 1)
+        {
+            ec::StepwiseInfo step;
+            step.reading = {0.0, 40.0};
+            step.output = {2000.0, 3000.0};
+            zone->addThermalPID(StepwiseController::createStepwiseController(
+                zone.get(), "stepwise1", {sensors[0]}, step));
+        }
+    }
+
+    for (int cycle = 0; cycle < 3; cycle++)
+    {
+        zone->processThermals();
+        for (size_t i = 0; i < references.size(); i++)
+        {
+            references[i]->process();
+
+            const ec::pid_info_t* got = controllers[i]->getPIDInfo();
+            const ec::pid_info_t* want = references[i]->getPIDInfo();
+            EXPECT_EQ(want->lastOutput, got->lastOutput) << configs[i].name;
+            EXPECT_EQ(want->integral, got->integral) << configs[i].name;
+            EXPECT_EQ(references[i]->getLastInput(),
+                      controllers[i]->getLastInput())
+                << configs[i].name;
+        }
+    }
+}
+
+TEST_F(PidZoneTest, ThermalPIDs_OutputsMatchPid)
+{
+    // Whether or not the thermal PIDs are batched, each gets the output and
+    // state ec::pid() computes for it.
+
+    std::vector<ControllerMock*> mocks;
+    std::vector<ec::pid_info_t> expected;
+
+    for (int i = 0; i < 3; i++)
+    {
+        std::unique_ptr<PIDController> tpid = std::make_unique<ControllerMock>(
+            "thermal" + std::to_string(i), zone.get());
+        ec::pid_info_t* info = tpid->getPIDInfo();
+        info->ts = 1.0;
+        info->proportionalCoeff = -0.5 * (i + 1);
+        info->integralCoeff = -0.1;
+        info->integralLimit = {0.0, 100.0};
+        info->outLim = {0.0, 100.0};
+        expected.push_back(*info);
+
+        mocks.push_back(reinterpret_cast<ControllerMock*>(tpid.get()));
+        zone->addThermalPID(std::move(tpid));
+    }
+
+    for (size_t i = 0; i < mocks.size(); i++)
+    {
+        double output = ec::pid(&expected[i], 60.0 + i, 50.0);
+        EXPECT_CALL(*mocks[i], setptProc()).WillOnce(Return(50.0));
+        EXPECT_CALL(*mocks[i], inputProc()).WillOnce(Return(60.0 + i));
+        EXPECT_CALL(*mocks[i], outputProc(output));
+    }
+
+    zone->processThermals();
+
+    for (size_t i = 0; i < mocks.size(); i++)
+    {
+        EXPECT_EQ(expected[i].integral, mocks[i]->getPIDInfo()->integral);
+        EXPECT_EQ(expected[i].lastOutput, mocks[i]->getPIDInfo()->lastOutput);
+        EXPECT_EQ(60.0 + i, mocks[i]->getLastInput());
+    }
+}
+
 TEST_F(PidZoneTest, AddFanPIDTest_VerifiesFanPIDsProcessed)
 {
     // Tests adding a fan PID controller to the zone, and verifies it's
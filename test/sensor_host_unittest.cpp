@@ -1,5 +1,6 @@
 #include "interfaces.hpp"
 #include "sensors/host.hpp"
+#include "sensors/hostbatch.hpp"
 #include "sensors/sensor.hpp"
 #include "test/helpers.hpp"
 
@@ -24,6 +25,7 @@ namespace
 
 using SensorValue = sdbusplus::common::xyz::openbmc_project::sensor::Value;
 
+using ::testing::_;
 using ::testing::IsNull;
 using ::testing::Return;
 using ::testing::StrEq;
@@ -42,7 +44,7 @@ TEST(HostSensorTest, CreateHostTempSensorTest)
     sdbusplus::SdBusMock sdbus_mock;
     auto bus_mock = sdbusplus::get_mocked_new(&sdbus_mock);
     std::string name = "fleeting0";
-    int64_t timeout = 1;
+    int64_t timeout = 1000;
     const char* objPath = "/asdf/asdf0";
     bool defer = false;
 
@@ -71,7 +73,7 @@ TEST(HostSensorTest, VerifyWriteThenReadMatches)
     sdbusplus::SdBusMock sdbus_mock;
     auto bus_mock = sdbusplus::get_mocked_new(&sdbus_mock);
     std::string name = "fleeting0";
-    int64_t timeout = 1;
+    int64_t timeout = 1000;
     const char* objPath = "/asdf/asdf0";
     bool defer = false;
 
@@ -105,8 +107,8 @@ TEST(HostSensorTest, VerifyWriteThenReadMatches)
                 return 0;
             }));
 
-    std::chrono::high_resolution_clock::time_point t1 =
-        std::chrono::high_resolution_clock::now();
+    std::chrono::steady_clock::time_point t1 =
+        std::chrono::steady_clock::now();
 
     hs->value(new_value);
     r = hs->read();
@@ -120,5 +122,44 @@ TEST(HostSensorTest, VerifyWriteThenReadMatches)
     EXPECT_TRUE(duration < 1);
 }
 
+TEST(HostSensorTest, BatchUpdateAppliesKnownSensorsWithoutSignals)
+{
+    // Verify that a batch update finds the host sensor by name, skips names it
+    // doesn't know, and doesn't emit PropertiesChanged for what it applies.
+
+    sdbusplus::SdBusMock sdbus_mock;
+    auto bus_mock = sdbusplus::get_mocked_new(&sdbus_mock);
+    std::string name = "fleeting0";
+    int64_t timeout = 1000;
+    const char* objPath = "/asdf/asdf0";
+    bool defer = false;
+
+    std::vector<std::string> properties = {};
+    double d;
+
+    SetupDbusObject(&sdbus_mock, defer, objPath, SensorValue::interface,
+                    properties, &d);
+
+    EXPECT_CALL(sdbus_mock,
+                sd_bus_emit_object_removed(IsNull(), StrEq(objPath)))
+        .WillOnce(Return(0));
+
+    std::unique_ptr<Sensor> s =
+        HostSensor::createTemp(name, timeout, bus_mock, objPath, defer);
+
+    EXPECT_CALL(sdbus_mock, sd_bus_emit_properties_changed_strv(_, _, _, _))
+        .Times(0);
+
+    uint32_t applied =
+        HostSensorBatch::setValues({{name, 3.5}, {"sluggish0", 7.0}});
+    EXPECT_EQ(applied, 1);
+
+    ReadReturn r = s->read();
+    EXPECT_EQ(r.value, 3.5);
+
+    s.reset();
+    EXPECT_EQ(HostSensor::find(name), nullptr);
+}
+
 } // namespace
 } // namespace pid_control
@@ -1,11 +1,14 @@
 #include "sensors/manager.hpp"
+#include "sensors/missing.hpp"
 #include "sensors/sensor.hpp"
+#include "symbols.hpp"
 #include "test/sensor_mock.hpp"
 
 #include <sdbusplus/test/sdbus_mock.hpp>
 
 #include <cstdint>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <utility>
 
@@ -22,6 +25,20 @@ using ::testing::IsNull;
 using ::testing::Return;
 using ::testing::StrEq;
 
+class DestroyCountSensor : public MissingSensor
+{
+  public:
+    explicit DestroyCountSensor(const std::string& name) : MissingSensor(name)
+    {}
+
+    ~DestroyCountSensor() override
+    {
+        ++destroyed;
+    }
+
+    static inline int destroyed = 0;
+};
+
 TEST(SensorManagerTest, BoringConstructorTest)
 {
     // Build a boring SensorManager.
@@ -58,7 +75,7 @@ TEST(SensorManagerTest, AddSensorInvalidTypeTest)
 
     std::string name = "name";
     std::string type = "invalid";
-    int64_t timeout = 1;
+    int64_t timeout = 1000;
     std::unique_ptr<Sensor> sensor =
         std::make_unique<SensorMock>(name, timeout);
     Sensor* sensor_ptr = sensor.get();
@@ -67,5 +84,134 @@ TEST(SensorManagerTest, AddSensorInvalidTypeTest)
     EXPECT_EQ(s.getSensor(name), sensor_ptr);
 }
 
+TEST(SensorManagerTest, RemoveSensorTest)
+{
+    // A removed sensor can be added back, as is done when its configuration
+    // changes.
+
+    sdbusplus::SdBusMock sdbus_mock_passive, sdbus_mock_host;
+    auto bus_mock_passive = sdbusplus::get_mocked_new(&sdbus_mock_passive);
+    auto bus_mock_host = sdbusplus::get_mocked_new(&sdbus_mock_host);
+
+    EXPECT_CALL(sdbus_mock_host,
+                sd_bus_add_object_manager(
+                    IsNull(), _, StrEq("/xyz/openbmc_project/extsensors")))
+        .WillOnce(Return(0));
+
+    SensorManager s(bus_mock_passive, bus_mock_host);
+
+    std::string name = "name";
+    int64_t timeout = 1000;
+    s.addSensor("temp", name, std::make_unique<SensorMock>(name, timeout));
+    s.addSensor("temp", "other",
+                std::make_unique<SensorMock>("other", timeout));
+
+    s.removeSensor(name);
+    EXPECT_THROW(s.getSensor(name), std::out_of_range);
+    EXPECT_NE(s.getSensor("other"), nullptr);
+
+    std::unique_ptr<Sensor> sensor =
+        std::make_unique<SensorMock>(name, timeout);
+    Sensor* sensor_ptr = sensor.get();
+    s.addSensor("temp", name, std::move(sensor));
+    EXPECT_EQ(s.getSensor(name), sensor_ptr);
+
+    // Removing a sensor that isn't there is fine.
+    s.removeSensor("missing");
+}
+
+TEST(SensorManagerTest, ReplaceMissingSensorTest)
+{
+    // A sensor that failed to build stands in as missing, and the real one
+    // takes over its name once it can be built.
+
+    sdbusplus::SdBusMock sdbus_mock_passive, sdbus_mock_host;
+    auto bus_mock_passive = sdbusplus::get_mocked_new(&sdbus_mock_passive);
+    auto bus_mock_host = sdbusplus::get_mocked_new(&sdbus_mock_host);
+
+    EXPECT_CALL(sdbus_mock_host,
+                sd_bus_add_object_manager(
+                    IsNull(), _, StrEq("/xyz/openbmc_project/extsensors")))
+        .WillOnce(Return(0));
+
+    SensorManager s(bus_mock_passive, bus_mock_host);
+
+    std::string name = "name";
+    s.addSensor("temp", name, std::make_unique<MissingSensor>(name));
+    EXPECT_TRUE(s.getSensor(name)->getFailed());
+    uint64_t version = s.getVersion();
+
+    std::unique_ptr<Sensor> sensor = std::make_unique<SensorMock>(name, 1000);
+    Sensor* sensor_ptr = sensor.get();
+    s.addSensor("temp", name, std::move(sensor));
+    EXPECT_EQ(s.getSensor(name), sensor_ptr);
+
+    // Holders of the old pointer can tell it went away.
+    EXPECT_NE(version, s.getVersion());
+}
+
+TEST(SensorManagerTest, ArenaSensorTest)
+{
+    // Sensors made by the manager are found by name and SymbolId, and are
+    // destroyed when removed or replaced.
+
+    sdbusplus::SdBusMock sdbus_mock_passive, sdbus_mock_host;
+    auto bus_mock_passive = sdbusplus::get_mocked_new(&sdbus_mock_passive);
+    auto bus_mock_host = sdbusplus::get_mocked_new(&sdbus_mock_host);
+
+    EXPECT_CALL(sdbus_mock_host,
+                sd_bus_add_object_manager(
+                    IsNull(), _, StrEq("/xyz/openbmc_project/extsensors")))
+        .WillOnce(Return(0));
+
+    SensorManager s(bus_mock_passive, bus_mock_host);
+
+    auto first = s.make<DestroyCountSensor>("arena0");
+    Sensor* first_ptr = first.get();
+    s.addSensor("temp", "arena0", std::move(first));
+    s.addSensor("temp", "arena1", s.make<DestroyCountSensor>("arena1"));
+
+    EXPECT_EQ(s.getSensor("arena0"), first_ptr);
+    EXPECT_EQ(s.getSensor(intern("arena0")), first_ptr);
+    EXPECT_EQ(0, DestroyCountSensor::destroyed);
+
+    s.addSensor("temp", "arena0", s.make<DestroyCountSensor>("arena0"));
+    EXPECT_EQ(1, DestroyCountSensor::destroyed);
+
+    s.removeSensor("arena1");
+    EXPECT_EQ(2, DestroyCountSensor::destroyed);
+    EXPECT_THROW(s.getSensor(intern("arena1")), std::out_of_range);
+}
+
+TEST(SensorManagerTest, MoveAssignReleasesSensorsFirst)
+{
+    // Assigning over a manager destroys its sensors while their arena is
+    // still there, and takes over the other's sensors and arena.
+
+    sdbusplus::SdBusMock sdbus_mock_passive, sdbus_mock_host;
+    auto bus_mock_passive = sdbusplus::get_mocked_new(&sdbus_mock_passive);
+    auto bus_mock_host = sdbusplus::get_mocked_new(&sdbus_mock_host);
+
+    EXPECT_CALL(sdbus_mock_host,
+                sd_bus_add_object_manager(
+                    IsNull(), _, StrEq("/xyz/openbmc_project/extsensors")))
+        .Times(2)
+        .WillRepeatedly(Return(0));
+
+    SensorManager s(bus_mock_passive, bus_mock_host);
+    s.addSensor("temp", "move0", s.make<DestroyCountSensor>("move0"));
+
+    SensorManager other(bus_mock_passive, bus_mock_host);
+    auto moved = other.make<DestroyCountSensor>("move1");
+    Sensor* moved_ptr = moved.get();
+    other.addSensor("temp", "move1", std::move(moved));
+
+    int destroyed = DestroyCountSensor::destroyed;
+    s = std::move(other);
+    EXPECT_EQ(destroyed + 1, DestroyCountSensor::destroyed);
+    EXPECT_EQ(s.getSensor("move1"), moved_ptr);
+    EXPECT_THROW(s.getSensor(intern("move0")), std::out_of_range);
+}
+
 } // namespace
 } // namespace pid_control
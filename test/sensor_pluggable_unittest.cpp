@@ -1,13 +1,19 @@
+#include "conf.hpp"
+#include "errors/exception.hpp"
 #include "interfaces.hpp"
+#include "sensors/filter.hpp"
 #include "sensors/pluggable.hpp"
 #include "test/readinterface_mock.hpp"
 #include "test/writeinterface_mock.hpp"
 
 #include <chrono>
+#include <cmath>
+#include <limits>
 #include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -18,6 +24,7 @@ namespace
 {
 
 using ::testing::Invoke;
+using ::testing::Return;
 
 TEST(PluggableSensorTest, BoringConstructorTest)
 {
@@ -31,7 +38,7 @@ TEST(PluggableSensorTest, BoringConstructorTest)
         std::make_unique<WriteInterfaceMock>(min, max);
 
     std::string name = "name";
-    int64_t timeout = 1;
+    int64_t timeout = 1000;
 
     PluggableSensor p(name, timeout, std::move(ri), std::move(wi));
     // Successfully created it.
@@ -49,7 +56,7 @@ TEST(PluggableSensorTest, TryReadingTest)
         std::make_unique<WriteInterfaceMock>(min, max);
 
     std::string name = "name";
-    int64_t timeout = 1;
+    int64_t timeout = 1000;
 
     ReadInterfaceMock* rip = reinterpret_cast<ReadInterfaceMock*>(ri.get());
 
@@ -57,7 +64,7 @@ TEST(PluggableSensorTest, TryReadingTest)
 
     ReadReturn r;
     r.value = 0.1;
-    r.updated = std::chrono::high_resolution_clock::now();
+    r.updated = std::chrono::steady_clock::now();
 
     EXPECT_CALL(*rip, read()).WillOnce(Invoke([&](void) { return r; }));
 
@@ -79,7 +86,7 @@ TEST(PluggableSensorTest, TryWritingTest)
         std::make_unique<WriteInterfaceMock>(min, max);
 
     std::string name = "name";
-    int64_t timeout = 1;
+    int64_t timeout = 1000;
 
     WriteInterfaceMock* wip = reinterpret_cast<WriteInterfaceMock*>(wi.get());
 
@@ -91,5 +98,201 @@ TEST(PluggableSensorTest, TryWritingTest)
     p.write(value);
 }
 
+TEST(PluggableSensorTest, MedianFilterRejectsSingleSpike)
+{
+    // A median over three samples shouldn't let a single bad reading through.
+
+    std::unique_ptr<ReadInterface> ri = std::make_unique<ReadInterfaceMock>();
+    std::unique_ptr<WriteInterface> wi =
+        std::make_unique<WriteInterfaceMock>(0, 255);
+
+    ReadInterfaceMock* rip = reinterpret_cast<ReadInterfaceMock*>(ri.get());
+
+    std::vector<conf::SensorFilterConfig> filters(1);
+    filters[0].type = "median";
+    filters[0].window = 3;
+
+    PluggableSensor p("name", 1000, std::move(ri), std::move(wi), false,
+                      filters);
+
+    auto now = std::chrono::steady_clock::now();
+    std::vector<ReadReturn> readings = {
+        {40.0, now},
+        {41.0, now + std::chrono::milliseconds(100)},
+        {127.0, now + std::chrono::milliseconds(200)},
+        {42.0, now + std::chrono::milliseconds(300)},
+    };
+
+    EXPECT_CALL(*rip, read())
+        .WillOnce(Return(readings[0]))
+        .WillOnce(Return(readings[1]))
+        .WillOnce(Return(readings[2]))
+        .WillOnce(Return(readings[3]));
+
+    EXPECT_EQ(40.0, p.read().value);
+    EXPECT_EQ(40.5, p.read().value);
+    ReadReturn v = p.read();
+    EXPECT_EQ(41.0, v.value);
+    EXPECT_EQ(readings[2].updated, v.updated);
+    EXPECT_EQ(42.0, p.read().value);
+}
+
+TEST(PluggableSensorTest, FilterOnlyAppliedToNewReadings)
+{
+    // Reading the same sample twice mustn't advance the filter.
+
+    std::unique_ptr<ReadInterface> ri = std::make_unique<ReadInterfaceMock>();
+    std::unique_ptr<WriteInterface> wi =
+        std::make_unique<WriteInterfaceMock>(0, 255);
+
+    ReadInterfaceMock* rip = reinterpret_cast<ReadInterfaceMock*>(ri.get());
+
+    std::vector<conf::SensorFilterConfig> filters(1);
+    filters[0].type = "ema";
+    filters[0].alpha = 0.5;
+
+    PluggableSensor p("name", 1000, std::move(ri), std::move(wi), false,
+                      filters);
+
+    auto now = std::chrono::steady_clock::now();
+    ReadReturn first = {10.0, now};
+    ReadReturn second = {20.0, now + std::chrono::milliseconds(100)};
+
+    EXPECT_CALL(*rip, read())
+        .WillOnce(Return(first))
+        .WillOnce(Return(second))
+        .WillOnce(Return(second));
+
+    EXPECT_EQ(10.0, p.read().value);
+    EXPECT_EQ(15.0, p.read().value);
+    EXPECT_EQ(15.0, p.read().value);
+}
+
+TEST(PluggableSensorTest, FilterPassesNonFiniteThrough)
+{
+    // NaN means the sensor failed, the filter mustn't hide that.
+
+    std::unique_ptr<ReadInterface> ri = std::make_unique<ReadInterfaceMock>();
+    std::unique_ptr<WriteInterface> wi =
+        std::make_unique<WriteInterfaceMock>(0, 255);
+
+    ReadInterfaceMock* rip = reinterpret_cast<ReadInterfaceMock*>(ri.get());
+
+    std::vector<conf::SensorFilterConfig> filters(1);
+    filters[0].type = "ema";
+    filters[0].alpha = 0.5;
+
+    PluggableSensor p("name", 1000, std::move(ri), std::move(wi), false,
+                      filters);
+
+    auto now = std::chrono::steady_clock::now();
+    ReadReturn good = {10.0, now};
+    ReadReturn bad = {std::numeric_limits<double>::quiet_NaN(),
+                      now + std::chrono::milliseconds(100)};
+
+    EXPECT_CALL(*rip, read()).WillOnce(Return(good)).WillOnce(Return(bad));
+
+    EXPECT_EQ(10.0, p.read().value);
+    EXPECT_TRUE(std::isnan(p.read().value));
+}
+
+/* A fan tach read in RPM and scaled to 0..1 of its 10000 RPM maximum. */
+class ScaledFanReadMock : public ReadInterfaceMock
+{
+  public:
+    double scale(double unscaled) const override
+    {
+        return unscaled / 10000.0;
+    }
+};
+
+TEST(PluggableSensorTest, FilterRunsOnUnscaledFanReading)
+{
+    // The filter parameters are in RPM, and the scaled value follows the
+    // filtered RPM.
+
+    std::unique_ptr<ReadInterface> ri = std::make_unique<ScaledFanReadMock>();
+    std::unique_ptr<WriteInterface> wi =
+        std::make_unique<WriteInterfaceMock>(0, 255);
+
+    ReadInterfaceMock* rip = reinterpret_cast<ReadInterfaceMock*>(ri.get());
+
+    std::vector<conf::SensorFilterConfig> filters(1);
+    filters[0].type = "rateLimit";
+    filters[0].maxRate = 1000.0;
+
+    PluggableSensor p("fan1", 1000, std::move(ri), std::move(wi), false,
+                      filters);
+
+    auto now = std::chrono::steady_clock::now();
+    ReadReturn first = {0.5, now, 5000.0};
+    ReadReturn second = {0.9, now + std::chrono::milliseconds(100), 9000.0};
+
+    EXPECT_CALL(*rip, read()).WillOnce(Return(first)).WillOnce(Return(second));
+
+    ReadReturn v = p.read();
+    EXPECT_EQ(5000.0, v.unscaled);
+    EXPECT_EQ(0.5, v.value);
+
+    // 1000 RPM/s for 100ms.
+    v = p.read();
+    EXPECT_DOUBLE_EQ(5100.0, v.unscaled);
+    EXPECT_DOUBLE_EQ(0.51, v.value);
+}
+
+TEST(SensorFilterTest, RateLimitAndSpikeFilters)
+{
+    auto now = std::chrono::steady_clock::now();
+
+    RateLimitFilter rate(10.0);
+    EXPECT_EQ(20.0, rate.apply(20.0, now));
+    EXPECT_EQ(25.0, rate.apply(80.0, now + std::chrono::milliseconds(500)));
+
+    SpikeFilter spike(5.0, 2);
+    EXPECT_EQ(20.0, spike.apply(20.0, now));
+    EXPECT_EQ(20.0, spike.apply(50.0, now));
+    EXPECT_EQ(20.0, spike.apply(50.0, now));
+    EXPECT_EQ(50.0, spike.apply(50.0, now));
+}
+
+TEST(SensorFilterTest, ParseFilterSpecs)
+{
+    conf::SensorFilterConfig ema = parseSensorFilter("ema:0.25");
+    EXPECT_EQ("ema", ema.type);
+    EXPECT_EQ(0.25, ema.alpha);
+
+    conf::SensorFilterConfig median = parseSensorFilter("median:5");
+    EXPECT_EQ("median", median.type);
+    EXPECT_EQ(5U, median.window);
+
+    conf::SensorFilterConfig spike = parseSensorFilter("spike:8:3");
+    EXPECT_EQ("spike", spike.type);
+    EXPECT_EQ(8.0, spike.threshold);
+    EXPECT_EQ(3U, spike.maxRejects);
+
+    // Without maxRejects, a lone jump is rejected.
+    std::vector<conf::SensorFilterConfig> defaultRejects = {
+        parseSensorFilter("spike:8")};
+    EXPECT_EQ(1U, defaultRejects[0].maxRejects);
+    SensorFilterChain spikeChain(defaultRejects);
+    auto now = std::chrono::steady_clock::now();
+    EXPECT_EQ(20.0, spikeChain.apply(20.0, now));
+    EXPECT_EQ(20.0, spikeChain.apply(50.0, now));
+    EXPECT_EQ(50.0, spikeChain.apply(50.0, now));
+
+    std::vector<conf::SensorFilterConfig> noRejects = {
+        parseSensorFilter("spike:8:0")};
+    EXPECT_THROW(SensorFilterChain chain(noRejects), SensorBuildException);
+    EXPECT_THROW(parseSensorFilter("spike:8:-1"), SensorBuildException);
+    EXPECT_THROW(parseSensorFilter("spike:8:4294967296"), SensorBuildException);
+    EXPECT_THROW(parseSensorFilter("median:-3"), SensorBuildException);
+
+    std::vector<conf::SensorFilterConfig> tooWide = {
+        parseSensorFilter("median:100")};
+    EXPECT_THROW(SensorFilterChain chain(tooWide), SensorBuildException);
+    EXPECT_THROW(parseSensorFilter("lowpass:1"), SensorBuildException);
+    EXPECT_THROW(parseSensorFilter("ema"), SensorBuildException);
+}
+
 } // namespace
 } // namespace pid_control
@@ -0,0 +1,112 @@
+#include "interfaces.hpp"
+#include "sensors/readcache.hpp"
+#include "symbols.hpp"
+#include "test/sensor_mock.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace pid_control
+{
+namespace
+{
+
+using ::testing::Return;
+
+class SensorReadCacheTest : public ::testing::Test
+{
+  protected:
+    SensorReadCacheTest() : sensor("readcache_temp", 1000)
+    {
+        id = intern(sensor.getName());
+    }
+
+    ReadReturn at(double value, std::chrono::steady_clock::time_point updated)
+    {
+        ReadReturn r;
+        r.value = value;
+        r.updated = updated;
+        return r;
+    }
+
+    SensorMock sensor;
+    SymbolId id;
+    SensorReadCache cache;
+    std::chrono::steady_clock::time_point now =
+        std::chrono::steady_clock::now();
+};
+
+TEST_F(SensorReadCacheTest, ZonesShareAGenerationsReading)
+{
+    // Two zones reading in the same generation read the sensor once, and
+    // each zone's next cycle reads it again.
+
+    EXPECT_CALL(sensor, read())
+        .WillOnce(Return(at(40.0, now)))
+        .WillOnce(Return(at(41.0, now)));
+
+    uint64_t zone1 = cache.begin(0, now);
+    uint64_t zone2 = cache.begin(0, now + std::chrono::milliseconds(1));
+    EXPECT_EQ(zone1, zone2);
+
+    EXPECT_EQ(40.0, cache.read(id, &sensor, zone1, now).read.value);
+    EXPECT_EQ(40.0, cache.read(id, &sensor, zone2, now).read.value);
+
+    // Zone 1 again, within the window but already read in this generation.
+    uint64_t next = cache.begin(zone1, now + std::chrono::milliseconds(2));
+    EXPECT_NE(zone1, next);
+    EXPECT_EQ(41.0, cache.read(id, &sensor, next, now).read.value);
+}
+
+TEST_F(SensorReadCacheTest, GenerationEndsAfterWindow)
+{
+    EXPECT_CALL(sensor, read())
+        .WillOnce(Return(at(40.0, now)))
+        .WillOnce(Return(at(41.0, now)));
+
+    uint64_t zone1 = cache.begin(0, now);
+    EXPECT_EQ(40.0, cache.read(id, &sensor, zone1, now).read.value);
+
+    uint64_t zone2 = cache.begin(0, now + SensorReadCache::window);
+    EXPECT_NE(zone1, zone2);
+    EXPECT_EQ(41.0, cache.read(id, &sensor, zone2, now).read.value);
+}
+
+TEST_F(SensorReadCacheTest, ChecksHealthOnce)
+{
+    // The health is checked with the reading, as of its time.
+
+    EXPECT_CALL(sensor, read()).WillOnce(Return(at(40.0, now)));
+
+    auto later = now + std::chrono::milliseconds(1000);
+    uint64_t generation = cache.begin(0, later);
+    const SensorReading& reading = cache.read(id, &sensor, generation, later);
+
+    EXPECT_FALSE(reading.failed);
+    EXPECT_TRUE(reading.timedOut);
+    EXPECT_TRUE(
+        cache.read(id, &sensor, generation, later + std::chrono::hours(1))
+            .timedOut);
+}
+
+TEST_F(SensorReadCacheTest, InvalidateRereads)
+{
+    // A replaced sensor is read again, even in the same generation.
+
+    EXPECT_CALL(sensor, read())
+        .WillOnce(Return(at(40.0, now)))
+        .WillOnce(Return(at(41.0, now)));
+
+    uint64_t generation = cache.begin(0, now);
+    EXPECT_EQ(40.0, cache.read(id, &sensor, generation, now).read.value);
+
+    cache.invalidate(id);
+    EXPECT_EQ(41.0, cache.read(id, &sensor, generation, now).read.value);
+}
+
+} // namespace
+} // namespace pid_control
@@ -0,0 +1,122 @@
+#include "conf.hpp"
+#include "notimpl/readonly.hpp"
+#include "notimpl/writeonly.hpp"
+#include "sensors/variant.hpp"
+#include "sysfs/sysfsread.hpp"
+#include "sysfs/sysfswrite.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace pid_control
+{
+namespace
+{
+
+class VariantSensorTest : public ::testing::Test
+{
+  protected:
+    VariantSensorTest()
+    {
+        char dir[] = "/tmp/sensor_variant_unittest.XXXXXX";
+        _dir = mkdtemp(dir);
+        _input = _dir + "/temp1_input";
+        _pwm = _dir + "/pwm1";
+    }
+
+    ~VariantSensorTest() override
+    {
+        std::filesystem::remove_all(_dir);
+    }
+
+    void setInput(int64_t value)
+    {
+        std::ofstream(_input) << value;
+    }
+
+    int64_t getPwm(void)
+    {
+        int64_t value = -1;
+        std::ifstream(_pwm) >> value;
+        return value;
+    }
+
+    std::string _dir;
+    std::string _input;
+    std::string _pwm;
+};
+
+TEST_F(VariantSensorTest, ReadsSysFs)
+{
+    VariantSensor s("temp1", 1000,
+                    SensorReader(std::in_place_type<SysFsRead>, _input),
+                    SensorWriter(std::in_place_type<ReadOnlyNoExcept>));
+
+    setInput(45000);
+    EXPECT_EQ(45000.0, s.read().value);
+    setInput(46000);
+    EXPECT_EQ(46000.0, s.read().value);
+
+    EXPECT_FALSE(s.getFailed());
+
+    // Writing a read-only sensor does nothing.
+    s.write(0.5);
+}
+
+TEST_F(VariantSensorTest, WritesSysFsPercent)
+{
+    int64_t min = 0;
+    int64_t max = 255;
+    VariantSensor s(
+        "fan1", 1000, SensorReader(std::in_place_type<SysFsRead>, _input),
+        SensorWriter(std::in_place_type<SysFsWritePercent>, _pwm, min, max));
+
+    s.write(0.5);
+    EXPECT_EQ(127, getPwm());
+
+    // Without a D-Bus writer, force and written are ignored.
+    int64_t written = -1;
+    s.write(1.0, true, &written);
+    EXPECT_EQ(255, getPwm());
+    EXPECT_EQ(-1, written);
+}
+
+TEST_F(VariantSensorTest, WritesSysFs)
+{
+    VariantSensor s("fan1", 1000, SensorReader(std::in_place_type<WriteOnly>),
+                    SensorWriter(std::in_place_type<SysFsWrite>, _pwm, 0, 0));
+
+    s.write(200.0);
+    EXPECT_EQ(200, getPwm());
+
+    EXPECT_THROW(s.read(), std::runtime_error);
+}
+
+TEST_F(VariantSensorTest, FiltersReadings)
+{
+    std::vector<conf::SensorFilterConfig> filters(1);
+    filters[0].type = "ema";
+    filters[0].alpha = 0.5;
+
+    VariantSensor s("temp1", 1000,
+                    SensorReader(std::in_place_type<SysFsRead>, _input),
+                    SensorWriter(std::in_place_type<ReadOnlyNoExcept>), false,
+                    filters);
+
+    setInput(40);
+    EXPECT_EQ(40.0, s.read().value);
+    setInput(60);
+    EXPECT_EQ(50.0, s.read().value);
+}
+
+} // namespace
+} // namespace pid_control
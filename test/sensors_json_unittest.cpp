@@ -51,7 +51,7 @@ TEST(SensorsFromJson, oneFanSensor)
               "hwmon/**/pwm1");
     EXPECT_EQ(output["fan1"].min, 0);
     EXPECT_EQ(output["fan1"].max, 255);
-    EXPECT_EQ(output["fan1"].timeout,
+    EXPECT_EQ(output["fan1"].timeoutMs,
               Sensor::getDefaultTimeout(output["fan1"].type));
     EXPECT_EQ(output["fan1"].ignoreDbusMinMax, false);
 }
@@ -77,7 +77,7 @@ TEST(SensorsFromJson, IgnoreDbusSensor)
     EXPECT_EQ(output["fan1"].writePath, "");
     EXPECT_EQ(output["fan1"].min, 0);
     EXPECT_EQ(output["fan1"].max, 0);
-    EXPECT_EQ(output["fan1"].timeout,
+    EXPECT_EQ(output["fan1"].timeoutMs,
               Sensor::getDefaultTimeout(output["fan1"].type));
     EXPECT_EQ(output["fan1"].ignoreDbusMinMax, true);
 }
@@ -103,7 +103,7 @@ TEST(SensorsFromJson, TempDbusSensor)
     EXPECT_EQ(output["CPU_DTS"].writePath, "");
     EXPECT_EQ(output["CPU_DTS"].min, 0);
     EXPECT_EQ(output["CPU_DTS"].max, 0);
-    EXPECT_EQ(output["CPU_DTS"].timeout,
+    EXPECT_EQ(output["CPU_DTS"].timeoutMs,
               Sensor::getDefaultTimeout(output["CPU_DTS"].type));
     EXPECT_EQ(output["CPU_DTS"].unavailableAsFailed, false);
 }
@@ -131,7 +131,7 @@ TEST(SensorsFromJson, validateOptionalFields)
     EXPECT_EQ(output["fan1"].writePath, "");
     EXPECT_EQ(output["fan1"].min, 0);
     EXPECT_EQ(output["fan1"].max, 0);
-    EXPECT_EQ(output["fan1"].timeout,
+    EXPECT_EQ(output["fan1"].timeoutMs,
               Sensor::getDefaultTimeout(output["fan1"].type));
     EXPECT_EQ(output["fan1"].ignoreDbusMinMax, false);
     EXPECT_EQ(output["fan1"].unavailableAsFailed, true);
@@ -161,5 +161,62 @@ TEST(SensorsFromJson, twoSensors)
     EXPECT_EQ(static_cast<u_int64_t>(2), output.size());
 }
 
+TEST(SensorsFromJson, timeoutSecondsAndMilliseconds)
+{
+    // timeout is in seconds, timeout_ms is in milliseconds and takes
+    // precedence when both are given.
+
+    auto j2 = R"(
+      {
+        "sensors": [{
+            "name": "fan1",
+            "type": "fan",
+            "readPath": "/xyz/openbmc_project/sensors/fan_tach/fan1",
+            "timeout": 4
+        }, {
+            "name": "fan2",
+            "type": "fan",
+            "readPath": "/xyz/openbmc_project/sensors/fan_tach/fan2",
+            "timeout_ms": 300
+        }, {
+            "name": "fan3",
+            "type": "fan",
+            "readPath": "/xyz/openbmc_project/sensors/fan_tach/fan3",
+            "timeout": 4,
+            "timeout_ms": 900
+        }]
+      }
+    )"_json;
+
+    auto output = buildSensorsFromJson(j2);
+    EXPECT_EQ(static_cast<u_int64_t>(3), output.size());
+    EXPECT_EQ(output["fan1"].timeoutMs, 4000);
+    EXPECT_EQ(output["fan2"].timeoutMs, 300);
+    EXPECT_EQ(output["fan3"].timeoutMs, 900);
+}
+
+TEST(SensorsFromJson, spikeFilterDefaultsToOneReject)
+{
+    // maxRejects is optional, and a spike filter without it still rejects a
+    // lone jump.
+
+    auto j2 = R"(
+      {
+        "sensors": [{
+            "name": "fan1",
+            "type": "fan",
+            "readPath": "/xyz/openbmc_project/sensors/fan_tach/fan1",
+            "filters": [{"type": "spike", "threshold": 500}]
+        }]
+      }
+    )"_json;
+
+    auto output = buildSensorsFromJson(j2);
+    ASSERT_EQ(static_cast<u_int64_t>(1), output["fan1"].filters.size());
+    EXPECT_EQ("spike", output["fan1"].filters[0].type);
+    EXPECT_EQ(500.0, output["fan1"].filters[0].threshold);
+    EXPECT_EQ(1U, output["fan1"].filters[0].maxRejects);
+}
+
 } // namespace
 } // namespace pid_control
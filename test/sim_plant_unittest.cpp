@@ -0,0 +1,135 @@
+#include "sim/plant.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace pid_control
+{
+namespace
+{
+
+sim::FanConfig makeFan(const std::string& name, double timeConstant)
+{
+    sim::FanConfig fan;
+    fan.name = name;
+    fan.timeConstant = timeConstant;
+    return fan;
+}
+
+sim::ThermalConfig makeThermal(const std::string& name, double power,
+                               double stillResistance, double fullResistance,
+                               double timeConstant)
+{
+    sim::ThermalConfig thermal;
+    thermal.name = name;
+    thermal.power = power;
+    thermal.stillResistance = stillResistance;
+    thermal.fullResistance = fullResistance;
+    thermal.timeConstant = timeConstant;
+    return thermal;
+}
+
+TEST(SimPlantTest, ParsesPlant)
+{
+    auto j = R"(
+        {
+            "ambient": 30.0,
+            "fans": [{"name": "fan1", "maxRpm": 8000.0}],
+            "thermals": [
+                {
+                    "name": "cpu0",
+                    "power": 50.0,
+                    "powerProfile": [
+                        {"time": 20.0, "power": 70.0},
+                        {"time": 10.0, "power": 60.0}
+                    ],
+                    "tjMax": 100.0
+                }
+            ]
+        }
+    )"_json;
+
+    sim::PlantConfig config = sim::buildPlantFromJson(j);
+    EXPECT_EQ(30.0, config.ambient);
+    ASSERT_EQ(1U, config.fans.size());
+    EXPECT_EQ("fan1", config.fans[0].name);
+    EXPECT_EQ(8000.0, config.fans[0].maxRpm);
+    EXPECT_EQ(1.0, config.fans[0].timeConstant);
+    ASSERT_EQ(1U, config.thermals.size());
+    EXPECT_EQ(100.0, config.thermals[0].tjMax);
+    ASSERT_EQ(2U, config.thermals[0].powerProfile.size());
+    EXPECT_EQ(10.0, config.thermals[0].powerProfile[0].time);
+}
+
+TEST(SimPlantTest, RejectsDuplicateNames)
+{
+    sim::PlantConfig config;
+    config.fans.push_back(makeFan("fan1", 1.0));
+    config.thermals.push_back(makeThermal("fan1", 0.0, 1.0, 1.0, 1.0));
+
+    EXPECT_THROW(sim::ThermalPlant plant(config), std::runtime_error);
+}
+
+TEST(SimPlantTest, SettlesAtSteadyState)
+{
+    // With the fans at half speed, the heat source settles at ambient plus
+    // power times the resistance halfway between still and full.
+
+    sim::PlantConfig config;
+    config.ambient = 20.0;
+    config.fans.push_back(makeFan("fan1", 2.0));
+    config.thermals.push_back(makeThermal("cpu0", 100.0, 1.0, 0.2, 10.0));
+    config.thermals[0].tjMax = 90.0;
+
+    sim::ThermalPlant plant(config);
+    EXPECT_EQ(20.0, plant.getTemperature("cpu0"));
+
+    plant.setFanPwm("fan1", 0.5);
+    for (int i = 0; i < 3000; i++)
+    {
+        plant.step(0.1);
+    }
+
+    EXPECT_NEAR(300.0, plant.getTime(), 1e-6);
+    EXPECT_NEAR(5000.0, plant.getFanRpm("fan1"), 1e-6);
+    EXPECT_NEAR(80.0, plant.getTemperature("cpu0"), 1e-6);
+    EXPECT_NEAR(10.0, plant.getReading("cpu0"), 1e-6);
+}
+
+TEST(SimPlantTest, FollowsPowerProfileAndFailures)
+{
+    sim::PlantConfig config;
+    config.fans.push_back(makeFan("fan1", 0.0));
+    config.fans[0].failAt = 5.0;
+    config.thermals.push_back(makeThermal("cpu0", 10.0, 1.0, 1.0, 0.0));
+    config.thermals[0].powerProfile.push_back({2.0, 40.0});
+
+    sim::ThermalPlant plant(config);
+    plant.setFanPwm("fan1", 2.0);
+    EXPECT_EQ(1.0, plant.getFanPwm("fan1"));
+
+    plant.step(1.0);
+    EXPECT_EQ(10000.0, plant.getFanRpm("fan1"));
+    EXPECT_EQ(35.0, plant.getTemperature("cpu0"));
+
+    // Each step uses the power at its start.
+    plant.step(1.0);
+    EXPECT_EQ(35.0, plant.getTemperature("cpu0"));
+    plant.step(1.0);
+    EXPECT_EQ(65.0, plant.getTemperature("cpu0"));
+    EXPECT_FALSE(plant.getFailed("fan1"));
+
+    plant.step(3.0);
+    EXPECT_TRUE(plant.getFailed("fan1"));
+    EXPECT_FALSE(plant.getFailed("cpu0"));
+
+    plant.step(1.0);
+    EXPECT_EQ(0.0, plant.getFanRpm("fan1"));
+}
+
+} // namespace
+} // namespace pid_control
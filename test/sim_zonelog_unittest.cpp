@@ -0,0 +1,100 @@
+#include "sim/replaysensor.hpp"
+#include "sim/zonelog.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+namespace pid_control
+{
+namespace
+{
+
+TEST(SimZoneLogTest, ReadsHeaderAndRows)
+{
+    std::istringstream in("epoch_ms,setpt,requester,fan1,fan1_raw\n"
+                          "1000,50,cpu0,0.5,5000\n"
+                          "\n"
+                          "1100,55,cpu0,nan,-\n");
+    sim::ZoneLogReader log(in);
+
+    EXPECT_EQ(5u, log.getColumns().size());
+    EXPECT_EQ(3u, log.findColumn("fan1"));
+    EXPECT_EQ(4u, log.findColumn("fan1_raw"));
+    EXPECT_FALSE(log.findColumn("fan2"));
+
+    ASSERT_TRUE(log.next());
+    EXPECT_EQ(1000u, log.getTimeMs());
+    EXPECT_DOUBLE_EQ(50.0, log.getValue(1));
+    EXPECT_DOUBLE_EQ(0.5, log.getValue(3));
+    EXPECT_TRUE(std::isnan(log.getValue(2)));
+
+    // The empty line is skipped.
+    ASSERT_TRUE(log.next());
+    EXPECT_EQ(4u, log.getLine());
+    EXPECT_EQ(1100u, log.getTimeMs());
+    EXPECT_TRUE(std::isnan(log.getValue(3)));
+    EXPECT_TRUE(std::isnan(log.getValue(4)));
+
+    EXPECT_FALSE(log.next());
+}
+
+TEST(SimZoneLogTest, ThrowsWithoutTime)
+{
+    std::istringstream empty("");
+    EXPECT_THROW(sim::ZoneLogReader log(empty), std::runtime_error);
+
+    std::istringstream noTime("setpt,requester\n");
+    EXPECT_THROW(sim::ZoneLogReader log(noTime), std::runtime_error);
+}
+
+TEST(SimZoneLogTest, ThrowsForShortRow)
+{
+    std::istringstream in("epoch_ms,setpt,fan1\n"
+                          "1000,50\n");
+    sim::ZoneLogReader log(in);
+
+    EXPECT_THROW(log.next(), std::runtime_error);
+}
+
+TEST(SimZoneLogTest, ReplayReadFollowsRow)
+{
+    std::istringstream in("epoch_ms,cpu0,cpu0_raw\n"
+                          "1000,60,60000\n"
+                          "1100,61,61000\n");
+    sim::ZoneLogReader log(in);
+    sim::ReplayRead read(log, 1, 2);
+
+    ASSERT_TRUE(log.next());
+    EXPECT_DOUBLE_EQ(60.0, read.read().value);
+    EXPECT_DOUBLE_EQ(60000.0, read.read().unscaled);
+
+    ASSERT_TRUE(log.next());
+    EXPECT_DOUBLE_EQ(61.0, read.read().value);
+}
+
+TEST(SimZoneLogTest, ReplayWriteCountsChanges)
+{
+    sim::ReplayWrite write(0, 255);
+    int64_t written = 0;
+
+    write.write(0.5, false, &written);
+    EXPECT_EQ(127, written);
+    EXPECT_DOUBLE_EQ(0.5, write.getValue());
+    EXPECT_EQ(1u, write.getWrites());
+
+    // The same raw value isn't written again unless forced.
+    write.write(0.5);
+    EXPECT_EQ(1u, write.getWrites());
+    write.write(0.5, true, nullptr);
+    EXPECT_EQ(2u, write.getWrites());
+
+    write.write(1.0);
+    EXPECT_EQ(3u, write.getWrites());
+}
+
+} // namespace
+} // namespace pid_control
@@ -0,0 +1,63 @@
+#include "symbols.hpp"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace pid_control
+{
+namespace
+{
+
+TEST(SymbolTableTest, InternReturnsSameIdForName)
+{
+    SymbolTable table;
+
+    SymbolId fan = table.intern("fan0");
+    SymbolId temp = table.intern("temp0");
+
+    EXPECT_NE(fan, temp);
+    EXPECT_EQ(fan, table.intern("fan0"));
+    EXPECT_EQ(fan, table.intern(std::string("fan0")));
+    EXPECT_EQ(2u, table.size());
+}
+
+TEST(SymbolTableTest, NameReturnsInternedName)
+{
+    SymbolTable table;
+
+    SymbolId fan = table.intern("fan0");
+    for (int i = 0; i < 1000; i++)
+    {
+        table.intern("sensor" + std::to_string(i));
+    }
+
+    // Names stay put as more are added.
+    EXPECT_EQ("fan0", table.name(fan));
+    EXPECT_EQ("sensor999", table.name(table.intern("sensor999")));
+}
+
+TEST(SymbolTableTest, FindDoesNotIntern)
+{
+    SymbolTable table;
+
+    EXPECT_FALSE(table.find("fan0"));
+    EXPECT_EQ(0u, table.size());
+
+    SymbolId fan = table.intern("fan0");
+    EXPECT_EQ(fan, table.find("fan0"));
+}
+
+TEST(SymbolTableTest, InternsListInOrder)
+{
+    std::vector<SymbolId> ids = intern({"symtest_a", "symtest_b", "symtest_a"});
+
+    ASSERT_EQ(3u, ids.size());
+    EXPECT_EQ(ids[0], ids[2]);
+    EXPECT_EQ("symtest_a", symbolName(ids[0]));
+    EXPECT_EQ("symtest_b", symbolName(ids[1]));
+}
+
+} // namespace
+} // namespace pid_control
@@ -0,0 +1,65 @@
+#include "util.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace pid_control
+{
+namespace
+{
+
+class WriteFileAtomicTest : public ::testing::Test
+{
+  protected:
+    WriteFileAtomicTest()
+    {
+        char dir[] = "/tmp/write_file_unittest.XXXXXX";
+        _dir = mkdtemp(dir);
+    }
+
+    ~WriteFileAtomicTest() override
+    {
+        std::filesystem::remove_all(_dir);
+    }
+
+    std::string readFile(const std::string& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(in),
+                std::istreambuf_iterator<char>()};
+    }
+
+    std::string _dir;
+};
+
+TEST_F(WriteFileAtomicTest, CreatesAndReplaces)
+{
+    std::string path = _dir + "/swampd/file.bin";
+    std::string contents("first\0second", 12);
+
+    writeFileAtomic(path, contents);
+    EXPECT_EQ(contents, readFile(path));
+
+    writeFileAtomic(path, "third");
+    EXPECT_EQ("third", readFile(path));
+
+    EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+}
+
+TEST_F(WriteFileAtomicTest, ThrowsWhenItCannotWrite)
+{
+    std::string notDir = _dir + "/file";
+    writeFileAtomic(notDir, "");
+
+    EXPECT_THROW(writeFileAtomic(notDir + "/file.bin", "contents"),
+                 std::runtime_error);
+}
+
+} // namespace
+} // namespace pid_control
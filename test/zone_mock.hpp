@@ -1,9 +1,11 @@
 #pragma once
 
 #include "interfaces.hpp"
+#include "pid/controller.hpp"
 #include "pid/zone_interface.hpp"
 #include "sensors/sensor.hpp"
 
+#include <cstddef>
 #include <cstdint>
 #include <map>
 #include <string>
@@ -19,12 +21,23 @@ namespace pid_control
 class ZoneMock : public ZoneInterface
 {
   public:
+    ZoneMock()
+    {
+        // Controllers fall back to lookups by name without slots.
+        EXPECT_CALL(*this, getCachedValueSlot(::testing::_))
+            .Times(::testing::AnyNumber());
+        EXPECT_CALL(*this, getOutputCacheSlot(::testing::_))
+            .Times(::testing::AnyNumber());
+        EXPECT_CALL(*this, getSensorsVersion()).Times(::testing::AnyNumber());
+    }
     ~ZoneMock() override = default;
 
     MOCK_METHOD0(updateFanTelemetry, void());
     MOCK_METHOD0(updateSensors, void());
     MOCK_METHOD0(initializeCache, void());
     MOCK_METHOD1(getCachedValue, double(const std::string&));
+    MOCK_METHOD1(getCachedValueSlot,
+                 const ValueCacheEntry*(const std::string&));
 
     // Compatibility interface for getCachedValues
     ValueCacheEntry getCachedValues(const std::string& s) override
@@ -37,6 +50,7 @@ class ZoneMock : public ZoneInterface
     MOCK_METHOD2(addSetPoint, void(double, const std::string&));
     MOCK_METHOD2(setOutputCache,
                  void(std::string_view name, const ValueCacheEntry& values));
+    MOCK_METHOD1(getOutputCacheSlot, ValueCacheEntry*(const std::string&));
     MOCK_METHOD0(clearSetPoints, void());
     MOCK_METHOD1(addRPMCeiling, void(double));
     MOCK_METHOD0(clearRPMCeilings, void());
@@ -46,6 +60,11 @@ class ZoneMock : public ZoneInterface
     MOCK_METHOD0(processFans, void());
     MOCK_METHOD0(processThermals, void());
 
+    MOCK_METHOD0(getControllerStates,
+                 std::map<std::string, ControllerState>(void));
+    MOCK_METHOD1(setControllerStates,
+                 size_t(const std::map<std::string, ControllerState>&));
+
     MOCK_CONST_METHOD0(getManualMode, bool());
     MOCK_CONST_METHOD0(getFailSafeMode, bool());
     MOCK_METHOD0(getFailSafePercent, double());
@@ -59,6 +78,7 @@ class ZoneMock : public ZoneInterface
     MOCK_CONST_METHOD0(getAccSetPoint, bool());
 
     MOCK_METHOD1(getSensor, Sensor*(const std::string&));
+    MOCK_CONST_METHOD0(getSensorsVersion, uint64_t());
     MOCK_METHOD0(getSensorNames, std::vector<std::string>());
 
     MOCK_METHOD0(initializeLog, void());
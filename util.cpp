@@ -17,13 +17,23 @@
 
 #include "conf.hpp"
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
 #include <limits>
 #include <map>
 #include <set>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace pid_control
@@ -44,7 +54,7 @@ void debugPrint(const std::map<std::string, conf::SensorConfig>& sensorConfig,
         std::cout << pair.second.writePath << ", ";
         std::cout << pair.second.min << ", ";
         std::cout << pair.second.max << ", ";
-        std::cout << pair.second.timeout << ", ";
+        std::cout << pair.second.timeoutMs << ", ";
         std::cout << pair.second.unavailableAsFailed << ", ";
         std::cout << pair.second.ignoreFailIfHostOff << "},\n\t},\n";
     }
@@ -168,4 +178,170 @@ std::vector<std::string> splitNames(
     return results;
 }
 
+template <typename K, typename V>
+static bool sameEntry(const std::map<K, V>& lhs, const std::map<K, V>& rhs,
+                      const K& key)
+{
+    auto l = lhs.find(key);
+    auto r = rhs.find(key);
+    if (l == lhs.end() || r == rhs.end())
+    {
+        return false;
+    }
+    return l->second == r->second;
+}
+
+static bool usesSensor(const conf::PIDConf& pids,
+                       const std::set<std::string>& sensors)
+{
+    for (const auto& [name, info] : pids)
+    {
+        for (const auto& input : info.inputs)
+        {
+            if (sensors.contains(input.name))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+ConfigDiff diffConfiguration(
+    const std::map<std::string, conf::SensorConfig>& oldSensorConfig,
+    const std::map<int64_t, conf::PIDConf>& oldZoneConfig,
+    const std::map<int64_t, conf::ZoneConfig>& oldZoneDetailsConfig,
+    const std::map<std::string, conf::SensorConfig>& sensorConfig,
+    const std::map<int64_t, conf::PIDConf>& zoneConfig,
+    const std::map<int64_t, conf::ZoneConfig>& zoneDetailsConfig)
+{
+    ConfigDiff diff;
+
+    for (const auto& [name, config] : oldSensorConfig)
+    {
+        if (!sameEntry(oldSensorConfig, sensorConfig, name))
+        {
+            diff.sensors.insert(name);
+        }
+    }
+    for (const auto& [name, config] : sensorConfig)
+    {
+        if (!oldSensorConfig.contains(name))
+        {
+            diff.sensors.insert(name);
+        }
+    }
+
+    std::set<int64_t> zoneIds;
+    for (const auto* zones : {&oldZoneConfig, &zoneConfig})
+    {
+        for (const auto& [id, pids] : *zones)
+        {
+            zoneIds.insert(id);
+        }
+    }
+    for (const auto* zones : {&oldZoneDetailsConfig, &zoneDetailsConfig})
+    {
+        for (const auto& [id, details] : *zones)
+        {
+            zoneIds.insert(id);
+        }
+    }
+
+    for (int64_t id : zoneIds)
+    {
+        if (!sameEntry(oldZoneConfig, zoneConfig, id) ||
+            !sameEntry(oldZoneDetailsConfig, zoneDetailsConfig, id) ||
+            usesSensor(zoneConfig.at(id), diff.sensors))
+        {
+            diff.zones.insert(id);
+        }
+    }
+
+    return diff;
+}
+
+static void writeAll(int fd, std::string_view contents)
+{
+    while (!contents.empty())
+    {
+        ssize_t written = ::write(fd, contents.data(), contents.size());
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw std::runtime_error(std::strerror(errno));
+        }
+        contents.remove_prefix(written);
+    }
+}
+
+void writeFileAtomic(const std::string& path, std::string_view contents)
+{
+    std::filesystem::path file(path);
+    std::filesystem::path dir = file.parent_path();
+    if (!dir.empty())
+    {
+        std::filesystem::create_directories(dir);
+    }
+
+    std::filesystem::path tmp = file;
+    tmp += ".tmp";
+
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                    0644);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Failed opening " + tmp.string() + ": " +
+                                 std::strerror(errno));
+    }
+    try
+    {
+        writeAll(fd, contents);
+        if (::fsync(fd) != 0)
+        {
+            throw std::runtime_error(std::strerror(errno));
+        }
+    }
+    catch (const std::runtime_error& e)
+    {
+        ::close(fd);
+        throw std::runtime_error("Failed writing " + tmp.string() + ": " +
+                                 e.what());
+    }
+    if (::close(fd) != 0)
+    {
+        throw std::runtime_error("Failed writing " + tmp.string() + ": " +
+                                 std::strerror(errno));
+    }
+
+    std::filesystem::rename(tmp, file);
+
+    // The rename is only durable once the directory is.
+    int dirFd = ::open(dir.empty() ? "." : dir.c_str(),
+                       O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd < 0)
+    {
+        throw std::runtime_error("Failed opening " + dir.string() + ": " +
+                                 std::strerror(errno));
+    }
+    int rc = ::fsync(dirFd);
+    int err = errno;
+    ::close(dirFd);
+    if (rc != 0)
+    {
+        throw std::runtime_error("Failed syncing " + dir.string() + ": " +
+                                 std::strerror(err));
+    }
+}
+
+std::chrono::steady_clock::duration Backoff::next(void)
+{
+    auto delay = _next;
+    _next = std::min(_next * 2, _max);
+    return delay;
+}
+
 } // namespace pid_control
@@ -3,10 +3,13 @@
 #include "conf.hpp"
 #include "pid/ec/pid.hpp"
 
+#include <chrono>
 #include <cstdint>
 #include <limits>
 #include <map>
+#include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace pid_control
@@ -55,4 +58,58 @@ void debugPrint(const std::map<std::string, conf::SensorConfig>& sensorConfig,
                 const std::map<int64_t, conf::PIDConf>& zoneConfig,
                 const std::map<int64_t, conf::ZoneConfig>& zoneDetailsConfig);
 
+/*
+ * The parts of a running configuration that have to be rebuilt to apply a
+ * new one.
+ */
+struct ConfigDiff
+{
+    /* Sensors that were added, removed or changed. */
+    std::set<std::string> sensors;
+    /* Zones that were added, removed or changed, or that use one of the
+     * sensors above.
+     */
+    std::set<int64_t> zones;
+};
+
+/*
+ * Compare the running configuration against a new one.  Zones that aren't in
+ * the result can keep running untouched.
+ */
+ConfigDiff diffConfiguration(
+    const std::map<std::string, conf::SensorConfig>& oldSensorConfig,
+    const std::map<int64_t, conf::PIDConf>& oldZoneConfig,
+    const std::map<int64_t, conf::ZoneConfig>& oldZoneDetailsConfig,
+    const std::map<std::string, conf::SensorConfig>& sensorConfig,
+    const std::map<int64_t, conf::PIDConf>& zoneConfig,
+    const std::map<int64_t, conf::ZoneConfig>& zoneDetailsConfig);
+
+/*
+ * Replace the file at path with contents, creating its directory if need be.
+ * The contents are written next to it, synced and renamed over it, and the
+ * directory synced, so neither a crash nor a power loss part way through
+ * leaves a truncated file behind.  Throws std::runtime_error on failure.
+ */
+void writeFileAtomic(const std::string& path, std::string_view contents);
+
+/*
+ * Delays between attempts at something that keeps failing: each one doubles
+ * the last, up to max.
+ */
+class Backoff
+{
+  public:
+    Backoff(std::chrono::steady_clock::duration initial,
+            std::chrono::steady_clock::duration max) :
+        _next(initial), _max(max)
+    {}
+
+    /* The delay before the next attempt. */
+    std::chrono::steady_clock::duration next(void);
+
+  private:
+    std::chrono::steady_clock::duration _next;
+    std::chrono::steady_clock::duration _max;
+};
+
 } // namespace pid_control